@@ -277,6 +277,55 @@ int32_t ICACHE_FLASH_ATTR SPIMasterSendData(SpiNum spiNum, SpiData *pInData)
     return 0;
 }
 
+/**
+ * @brief Send a continuous byte stream to slave, 64 bytes per transaction.
+ *
+ */
+int32_t ICACHE_FLASH_ATTR SPIMasterSendBurst(SpiNum spiNum, const uint8_t *data, uint32_t length)
+{
+    uint32_t word, chunk, idx, i;
+
+    if ((spiNum > SpiNum_HSPI)
+            || (NULL == data)) {
+        return -1;
+    }
+
+    while (READ_PERI_REG(SPI_CMD(spiNum))&SPI_USR);
+
+    // Data phase only, no command and address.
+    CLEAR_PERI_REG_MASK(SPI_USER(spiNum), SPI_USR_COMMAND | SPI_USR_ADDR | SPI_USR_MISO);
+    SET_PERI_REG_BITS(SPI_USER2(spiNum), SPI_USR_COMMAND_BITLEN,
+                      0, SPI_USR_COMMAND_BITLEN_S);
+    SET_PERI_REG_BITS(SPI_USER1(spiNum), SPI_USR_ADDR_BITLEN,
+                      0, SPI_USR_ADDR_BITLEN_S);
+    SET_PERI_REG_MASK(SPI_USER(spiNum), SPI_USR_MOSI);
+
+    while (length > 0) {
+        chunk = (length > 64) ? 64 : length;
+
+        // Load send buffer, the first byte goes out from the low byte of W0.
+        // Source buffer may be unaligned, pack words byte by byte.
+        for (idx = 0; (idx << 2) < chunk; idx++) {
+            word = 0;
+            for (i = 0; (i < 4) && (((idx << 2) + i) < chunk); i++) {
+                word |= ((uint32_t)data[(idx << 2) + i] << (i << 3));
+            }
+            WRITE_PERI_REG((SPI_W0(spiNum) + (idx << 2)), word);
+        }
+        SET_PERI_REG_BITS(SPI_USER1(spiNum), SPI_USR_MOSI_BITLEN, ((chunk << 3) - 1), SPI_USR_MOSI_BITLEN_S);
+
+        // Start send data
+        SET_PERI_REG_MASK(SPI_CMD(spiNum), SPI_USR);
+        // Wait for transmit done
+        while (!(READ_PERI_REG(SPI_SLAVE(spiNum))&SPI_TRANS_DONE));
+        CLEAR_PERI_REG_MASK(SPI_SLAVE(spiNum), SPI_TRANS_DONE);
+
+        data += chunk;
+        length -= chunk;
+    }
+    return 0;
+}
+
 /**
  * @brief Receive data from slave.
  *
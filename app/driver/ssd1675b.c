@@ -26,11 +26,19 @@ const uint8_t LUT_PARTIAL_UPDATE[] = {
 //	    0x00, 0x00, 0x00, 0x00, 0x00, 0x00
 };
 
-static void SoftSpiSendByte(uint8_t byte, TransferType type);
+// 温度分级的全局刷新波形，在温度范围内的项中选择各阶段帧数之和最少的一项，
+// 没有符合的项(超出0~50度或温度未知)时使用LUT_FULL_UPDATE
+// LUT_FULL_UPDATE与Waveshare 2.13寸示例程序(epd2in13)的lut_full_update相同，适用于面板0~50度的工作温度，
+// 各温度段暂时都使用该波形，缩短帧数的波形在对应温度下实测无残影后再替换
+static const EPDWaveform WAVEFORM_TABLE[] = {
+	{25, 50, LUT_FULL_UPDATE},
+	{10, 24, LUT_FULL_UPDATE},
+	{0, 9, LUT_FULL_UPDATE}
+};
 
-#ifdef USE_SOFT_SPI
+static void SoftSpiSendByte(uint8_t byte, TransferType type);
+static void SoftSpiSendBurst(const uint8_t *data, uint32_t length);
 static void SoftSpiRead(uint8_t cmd, uint8_t *buffer, uint32_t length);
-#endif
 
 #define HspiSendCMD(cmd) \
 do{ \
@@ -42,19 +50,74 @@ do{ \
 	SoftSpiSendByte((data), DATA_TYPE); \
 }while(0)
 
+#define HspiSendDATABurst(data, length) \
+do{ \
+	SoftSpiSendBurst((data), (length)); \
+}while(0)
+
+#ifdef EPD_PROFILE_FLUSH
+static inline uint32_t EPDGetCycleCount() {
+	uint32_t ccount;
+	__asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+	return ccount;
+}
+#endif
+
 static void ICACHE_FLASH_ATTR EPDAutoSleep();
 static void ICACHE_FLASH_ATTR timerCallback(void *timer_arg);
 
+// do not add 'ICACHE_FLASH_ATTR'
+static void EPDBusyIRQListener(void);
+
 static void ICACHE_FLASH_ATTR EPDSetWindow(uint16_t x_start, uint16_t x_end, uint16_t y_start, uint16_t y_end);
 static void ICACHE_FLASH_ATTR EPDSetCursor(uint16_t x, uint16_t y);
 
-static void ICACHE_FLASH_ATTR EPDDoSleep();
+static void ICACHE_FLASH_ATTR EPDDoSleep(BOOL refreshed);
+static const uint8_t * ICACHE_FLASH_ATTR EPDSelectWaveform();
+static void ICACHE_FLASH_ATTR EPDWriteWindow(uint8_t cmd, const uint8_t *data, uint16_t rowStart, uint16_t rowEnd, uint16_t colStart, uint16_t colEnd);
+static void ICACHE_FLASH_ATTR EPDBeginWindow(uint8_t cmd, uint16_t rowStart, uint16_t rowEnd, uint16_t colStart, uint16_t colEnd);
+static void ICACHE_FLASH_ATTR EPDWriteRows(const uint8_t *data, uint16_t rowStart, uint16_t rowEnd, uint16_t colStart, uint16_t colEnd);
+static void ICACHE_FLASH_ATTR EPDFlushStart(uint8_t type);
+static void ICACHE_FLASH_ATTR EPDFlushTask(os_event_t *event);
 
 static uint8_t *buffer = NULL;
 static TransferType transfer_type = UNKNOWN_TYPE;
 static STATUS epd_status = IDLE;
 static ETSTimer timer;
-static uint8_t sleepTimeOut;
+// 异步写入任务队列
+static os_event_t flushTaskQueue[EPD_FLUSH_TASK_QUEUE_LEN];
+// 异步写入的下一行
+static uint16_t flushRow;
+
+// 休眠时是否保留控制器RAM(保持供电)
+static BOOL retainRAM = FALSE;
+// 控制器0x24/0x26 RAM内容与显存一致，可以进行局部刷新
+static BOOL ramValid = FALSE;
+// 显存写入开始到刷新完成断电前，显存仍被写入任务或0x26同步读取
+static BOOL updating = FALSE;
+// 显存对应的RAM行范围，分带渲染时为当前条带
+static int32_t bandRowStart = 0;
+static int32_t bandRowEnd = (EPD_BUFFER_ROWS - 1);
+// 本次刷新写入的RAM窗口(行:0~249, 列:0~15)，休眠前同步到0x26 RAM
+static uint16_t syncRowStart, syncRowEnd;
+static uint8_t syncColStart, syncColEnd;
+
+// 面板温度，用于选择全局刷新波形
+static sint8_t panelTemperature = EPD_TEMPERATURE_INVALID;
+// 本次刷新使用的WAVEFORM_TABLE下标，-1为其他LUT
+static sint8_t waveformIndex = -1;
+// 刷新计时环形缓冲，timingHead为当前记录
+static EPDTiming timings[EPD_TIMING_RECORDS];
+static uint8_t timingHead = 0, timingCount = 0;
+
+#ifdef EPD_ESTIMATE_ENERGY
+// 本次更新开始(EPDGpioSetup)时间(us)
+static uint32_t updateStartTime;
+// 本次更新写入控制器RAM的字节数
+static uint32_t bytesWritten;
+
+static void ICACHE_FLASH_ATTR EPDReportEnergyEstimate(BOOL refreshed);
+#endif
 
 /**
  * @brief EPD硬件配置
@@ -62,15 +125,20 @@ static uint8_t sleepTimeOut;
 void ICACHE_FLASH_ATTR EPDGpioSetup() {
 	SpiAttr pAttr;
 
+#ifdef EPD_ESTIMATE_ENERGY
+	updateStartTime = system_get_time();
+	bytesWritten = 0;
+#endif
+
 	// EPD RESET PIN
 	PIN_FUNC_SELECT(PERIPHS_IO_MUX_GPIO2_U, FUNC_GPIO2);
 	PIN_PULLUP_DIS(PERIPHS_IO_MUX_GPIO2_U);
 	GPIO_OUTPUT_SET(EPD_RESET_PIN, GPIO_PIN_HIGH);
 
-	// 默认关闭EPD供电
+	// 默认关闭EPD供电, 控制器保留RAM时不断电
 	// EPD POWER P-MOSFET GATE PIN
 	gpio16_output_conf();
-	gpio16_output_set(GPIO_PIN_HIGH);
+	gpio16_output_set(ramValid ? GPIO_PIN_LOW : GPIO_PIN_HIGH);
 
 	// EPD BUSY PIN, NO PULL AND SET INPUT MODE
 	PIN_FUNC_SELECT(PERIPHS_IO_MUX_GPIO4_U, FUNC_GPIO4);
@@ -110,13 +178,16 @@ void ICACHE_FLASH_ATTR EPDGpioSetup() {
     SPIInit(SpiNum_HSPI, &pAttr);
 #endif
 
-	// 刷新完成自动断电定时器
-	os_timer_disarm(&timer);
-	os_timer_setfn(&timer, &timerCallback, NULL);
+	// BUSY中断只在等待刷新完成时开启
+	gpio_pin_intr_state_set(GPIO_ID_PIN(EPD_BUSY_PIN), GPIO_PIN_INTR_DISABLE);
 }
 
 void ICACHE_FLASH_ATTR EPDReset() {
+	// 开始新的计时记录
+	os_memset(&timings[timingHead], 0x00, sizeof(EPDTiming));
+	timings[timingHead].reset = system_get_time();
 	epd_status = IDLE;
+	updating = FALSE;
 	// enable EPD power control p-mosfet
 	gpio16_output_set(GPIO_PIN_LOW);
 	// pull dowm reset pin 10ms
@@ -159,10 +230,29 @@ static void ICACHE_FLASH_ATTR SoftSpiSendByte(uint8_t byte, TransferType type) {
 #endif
 }
 
+/**
+ * @brief 连续发送数据，D/C保持高电平，硬件spi时每次传输填满64字节W0~W15缓冲区
+ * @param *data 数据
+ * @param length 数据长度
+ * */
+static void ICACHE_FLASH_ATTR SoftSpiSendBurst(const uint8_t *data, uint32_t length) {
+	if(transfer_type != DATA_TYPE) {
+		transfer_type = DATA_TYPE;
+		GPIO_OUTPUT_SET(EPD_DC_PIN, (DATA_TYPE & 0x1));
+	}
 #ifdef USE_SOFT_SPI
+	uint32_t i = 0;
+	for(; i < length; i++) {
+		SoftSpiSendByte(*(data + i), DATA_TYPE);
+	}
+#else
+	SPIMasterSendBurst(SpiNum_HSPI, data, length);
+#endif
+}
 
 /**
- * @brief ssd1675b的SDA是I/O类型，对于主机来说MOSI也充当MISO，因此只能在软件spi的情况下实现读取功能
+ * @brief ssd1675b的SDA是I/O类型，对于主机来说MOSI也充当MISO，因此只能用软件spi实现读取功能
+ * @note 硬件spi模式下临时把引脚切换为GPIO，读取完成后恢复HSPI功能
  * @param cmd 发往ssd1675b命令
  * @param *buffer 读取数据存储区
  * @param length 读取数据长度
@@ -172,6 +262,13 @@ static void SoftSpiRead(uint8_t cmd, uint8_t *buffer, uint32_t length) {
 	int32_t i = 7, j = 0;
 	uint8_t inByte;
 
+#ifndef USE_SOFT_SPI
+	PIN_FUNC_SELECT(PERIPHS_IO_MUX_MTCK_U, FUNC_GPIO13);
+	PIN_FUNC_SELECT(PERIPHS_IO_MUX_MTMS_U, FUNC_GPIO14);
+	PIN_FUNC_SELECT(PERIPHS_IO_MUX_MTDO_U, FUNC_GPIO15);
+	GPIO_OUTPUT_SET(HSPI_SCLK_PIN, GPIO_PIN_LOW);
+#endif
+
 	if(transfer_type != COMMAND_TYPE) {
 		transfer_type = COMMAND_TYPE;
 		GPIO_OUTPUT_SET(EPD_DC_PIN, (COMMAND_TYPE & 0x1));
@@ -206,44 +303,82 @@ static void SoftSpiRead(uint8_t cmd, uint8_t *buffer, uint32_t length) {
 	GPIO_OUTPUT_SET(HSPI_SCLK_PIN, GPIO_PIN_LOW);
 	GPIO_OUTPUT_SET(HSPI_MOSI_PIN, GPIO_PIN_LOW);
 	GPIO_OUTPUT_SET(HSPI_CS_PIN, GPIO_PIN_HIGH);
-}
 
+#ifndef USE_SOFT_SPI
+	PIN_FUNC_SELECT(PERIPHS_IO_MUX_MTCK_U, FUNC_HSPI_MOSI);
+	PIN_FUNC_SELECT(PERIPHS_IO_MUX_MTDO_U, FUNC_HSPI_CS);
+	PIN_FUNC_SELECT(PERIPHS_IO_MUX_MTMS_U, FUNC_HSPI_SCLK);
 #endif
+}
+
+/**
+ * @brief BUSY下降沿中断，刷新完成后转到定时器回调处理
+ * */
+static void EPDBusyIRQListener(void) {
+	gpio_pin_intr_state_set(GPIO_ID_PIN(EPD_BUSY_PIN), GPIO_PIN_INTR_DISABLE);
+	os_timer_disarm(&timer);
+	os_timer_arm(&timer, 0, FALSE);
+}
 
+/**
+ * @brief 刷新完成(BUSY中断)或超时看门狗回调
+ * */
 static void ICACHE_FLASH_ATTR timerCallback(void *timer_arg) {
-	sleepTimeOut++;
-	// 超时10秒或EPD主动拉低忙信号
-	if((sleepTimeOut >= (EPD_REFRESH_TIMEOUT / 500)) || (GPIO_INPUT_GET(EPD_BUSY_PIN) == GPIO_PIN_LOW)) {
-		os_timer_disarm(&timer);
-		epd_status = IDLE;
-		EPDDoSleep();
-		EventBusGetDefault()->post(MAIN_EVENT_EPD_FINISH, 0);
+	os_timer_disarm(&timer);
+	gpio_pin_intr_state_set(GPIO_ID_PIN(EPD_BUSY_PIN), GPIO_PIN_INTR_DISABLE);
+	epd_status = IDLE;
+#ifdef EPD_ESTIMATE_ENERGY
+	EPDReportEnergyEstimate(GPIO_INPUT_GET(EPD_BUSY_PIN) == GPIO_PIN_LOW);
+#endif
+	timings[timingHead].finish = system_get_time();
+#ifdef EPD_PROFILE_FLUSH
+	// 各温度波形的实际刷新时长，用于调整WAVEFORM_TABLE
+	os_printf("epd refresh %s waveform[%d] %d'C: %d ms\n", (timings[timingHead].type == EPD_TIMING_PARTIAL) ? "partial" : "full",
+			waveformIndex, panelTemperature, (timings[timingHead].finish - timings[timingHead].refresh) / 1000);
+#endif
+	// 超时情况下无法确认屏幕内容，不保留RAM
+	if(GPIO_INPUT_GET(EPD_BUSY_PIN) == GPIO_PIN_LOW) {
+		timings[timingHead].result = EPD_FINISH_OK;
+		EPDDoSleep(TRUE);
+		EventBusGetDefault()->post(MAIN_EVENT_EPD_FINISH, EPD_FINISH_OK);
+	}else {
+		timings[timingHead].result = EPD_FINISH_TIMEOUT;
+		EPDDoSleep(FALSE);
+		EventBusGetDefault()->post(MAIN_EVENT_EPD_FINISH, EPD_FINISH_TIMEOUT);
 	}
 }
 
 /**
- * @brief epd全局刷新一次需要3s左右，500ms一次回调判断busy状态
+ * @brief epd全局刷新一次需要3s左右，刷新完成时EPD拉低BUSY产生下降沿中断
  * */
 static void ICACHE_FLASH_ATTR EPDAutoSleep() {
-	sleepTimeOut = 0;
 	if(GPIO_INPUT_GET(EPD_BUSY_PIN) == GPIO_PIN_HIGH) {
 		epd_status = BUSY;
-		os_timer_arm(&timer, 500, TRUE);
+		GPIO_REG_WRITE(GPIO_STATUS_W1TC_ADDRESS, BIT(EPD_BUSY_PIN));
+		gpio_pin_intr_state_set(GPIO_ID_PIN(EPD_BUSY_PIN), GPIO_PIN_INTR_NEGEDGE);
+		os_timer_arm(&timer, EPD_REFRESH_TIMEOUT, FALSE);
+		// 开启中断前已经完成刷新
+		if(GPIO_INPUT_GET(EPD_BUSY_PIN) == GPIO_PIN_LOW) {
+			gpio_pin_intr_state_set(GPIO_ID_PIN(EPD_BUSY_PIN), GPIO_PIN_INTR_DISABLE);
+			os_timer_disarm(&timer);
+			os_timer_arm(&timer, 0, FALSE);
+		}
 	}else {
 		epd_status = IDLE;
-		EPDDoSleep();
-		EventBusGetDefault()->post(MAIN_EVENT_EPD_FINISH, 0);
+		EPDDoSleep(TRUE);
+		EventBusGetDefault()->post(MAIN_EVENT_EPD_FINISH, EPD_FINISH_OK);
 	}
 }
 
 STATUS ICACHE_FLASH_ATTR EPDTurnOnDisplay() {
-	if(BUSY == epd_status) {
+	if(IDLE != epd_status) {
 		return FAIL;
 	}
 	HspiSendCMD(0x22); // DISPLAY_UPDATE_CONTROL_2
 	HspiSendDATA(0xC7);
 	HspiSendCMD(0X20);	// MASTER_ACTIVATION
 	//HspiSendCMD(0xFF);	// TERMINATE_FRAME_READ_WRITE
+	timings[timingHead].refresh = system_get_time();
 	// 稍稍延时5ms
 	os_delay_us(5000);
 	EPDAutoSleep();
@@ -275,9 +410,15 @@ static void ICACHE_FLASH_ATTR EPDSetCursor(uint16_t x, uint16_t y) {
 
 STATUS ICACHE_FLASH_ATTR EPDInit(const uint8_t *lut) {
 	int i = 0;
-	if(BUSY == epd_status) {
+	if(IDLE != epd_status) {
 		return FAIL;
 	}
+	timings[timingHead].init = system_get_time();
+	// 全局刷新使用当前温度下最短的有效波形
+	waveformIndex = -1;
+	if(lut == LUT_FULL_UPDATE) {
+		lut = EPDSelectWaveform();
+	}
 
     HspiSendCMD(0x01); // DRIVER_OUTPUT_CONTROL
     HspiSendDATA((EPD_HEIGHT - 1) & 0xFF);
@@ -308,25 +449,100 @@ STATUS ICACHE_FLASH_ATTR EPDInit(const uint8_t *lut) {
 
 	// WRITE_LUT_REGISTER
     HspiSendCMD(0x32);
-	for(i = 0; i < 30; i++) {
+	for(i = 0; i < EPD_LUT_SIZE; i++) {
 		HspiSendDATA(lut[i]);
 	}
 
     return OK;
 }
 
+/**
+ * @brief 读取控制器内部温度传感器
+ * @note 需在EPDReset之后调用，只加载温度值不影响已写入的LUT
+ * @return 温度(摄氏度)，读取失败返回EPD_TEMPERATURE_INVALID
+ * */
+sint8_t ICACHE_FLASH_ATTR EPDReadTemperature() {
+	uint8_t raw[2];
+	int16_t value;
+	uint32_t wait = 0;
+
+	if(IDLE != epd_status) {
+		return EPD_TEMPERATURE_INVALID;
+	}
+	HspiSendCMD(TEMP_SENSOR_SEL_CMD);
+	HspiSendDATA(INTERNAL_TEMP_SENSOR);
+	HspiSendCMD(0x22); // DISPLAY_UPDATE_CONTROL_2
+	HspiSendDATA(0xA1); // enable clock, load temperature, disable clock
+	HspiSendCMD(0x20); // MASTER_ACTIVATION
+	// 加载温度通常在1ms内完成
+	while(GPIO_INPUT_GET(EPD_BUSY_PIN) == GPIO_PIN_HIGH) {
+		if(wait >= EPD_TEMPERATURE_TIMEOUT) {
+			return EPD_TEMPERATURE_INVALID;
+		}
+		os_delay_us(100);
+		wait += 100;
+	}
+	SoftSpiRead(READ_INTERNAL_TEMP_CMD, raw, 2);
+	// 12bit补码，单位1/16摄氏度
+	value = (int16_t)((raw[0] << 8) | raw[1]) >> 4;
+	return (sint8_t)(value / 16);
+}
+
+/**
+ * @brief 设置面板温度，在EPDInit之前调用
+ * @param temperature 温度(摄氏度)，来自EPDReadTemperature或DHT11，未知时为EPD_TEMPERATURE_INVALID
+ * */
+void ICACHE_FLASH_ATTR EPDSetTemperature(sint8_t temperature) {
+	panelTemperature = temperature;
+}
+
+/**
+ * @brief 按面板温度选择全局刷新波形
+ * @return lut 温度范围内各阶段帧数之和最少的波形，没有符合的项时为LUT_FULL_UPDATE
+ * */
+static const uint8_t * ICACHE_FLASH_ATTR EPDSelectWaveform() {
+	uint8_t i, j, count = sizeof(WAVEFORM_TABLE) / sizeof(WAVEFORM_TABLE[0]);
+	uint16_t frames, shortest = 0xFFFF;
+
+	if(panelTemperature == EPD_TEMPERATURE_INVALID) {
+		return LUT_FULL_UPDATE;
+	}
+	for(i = 0; i < count; i++) {
+		if(panelTemperature < WAVEFORM_TABLE[i].minTemperature || panelTemperature > WAVEFORM_TABLE[i].maxTemperature) {
+			continue;
+		}
+		frames = 0;
+		for(j = 0; j < EPD_LUT_PHASE_COUNT; j++) {
+			frames += WAVEFORM_TABLE[i].lut[EPD_LUT_PHASE_START + j];
+		}
+		if(frames < shortest) {
+			shortest = frames;
+			waveformIndex = i;
+		}
+	}
+	return (waveformIndex >= 0) ? WAVEFORM_TABLE[waveformIndex].lut : LUT_FULL_UPDATE;
+}
+
 STATUS ICACHE_FLASH_ATTR EPDDisplayRAMInit() {
 	if(buffer == NULL) {
-		buffer = (uint8_t *)os_malloc(sizeof(uint8_t) * EPD_RAM_WIDTH * EPD_HEIGHT);
+		buffer = (uint8_t *)os_malloc(sizeof(uint8_t) * EPD_RAM_WIDTH * EPD_BUFFER_ROWS);
 	}
 	if(buffer != NULL) {
-		os_memset(buffer, 0xFF, sizeof(uint8_t) * EPD_RAM_WIDTH * EPD_HEIGHT);
+		os_memset(buffer, 0xFF, sizeof(uint8_t) * EPD_RAM_WIDTH * EPD_BUFFER_ROWS);
 	}
+	system_os_task(EPDFlushTask, EPD_FLUSH_TASK_PRIO, flushTaskQueue, EPD_FLUSH_TASK_QUEUE_LEN);
+	// 刷新完成自动断电定时器
+	os_timer_disarm(&timer);
+	os_timer_setfn(&timer, &timerCallback, NULL);
+	// BUSY下降沿中断，与用户按键共用GPIO中断向量，只需注册一次
+	gpio_pin_intr_state_set(GPIO_ID_PIN(EPD_BUSY_PIN), GPIO_PIN_INTR_DISABLE);
+	UserButtonAddPinIRQListener(EPD_BUSY_PIN, EPDBusyIRQListener);
 	return (buffer == NULL) ? FAIL : OK;
 }
 
 /**
  * @brief 返回显存引用，外部应当只读该显存，尝试写入会干扰正常显示内容
+ * @note 分带渲染模式下为当前条带(EPD_BAND_ROWS行)
  * @return buffer 显存引用
  * */
 uint8_t * ICACHE_FLASH_ATTR EPDGetDisplayRAM() {
@@ -334,7 +550,7 @@ uint8_t * ICACHE_FLASH_ATTR EPDGetDisplayRAM() {
 }
 
 void ICACHE_FLASH_ATTR EPDDisplayClear() {
-	os_memset(buffer, 0xFF, sizeof(uint8_t) * EPD_RAM_WIDTH * EPD_HEIGHT);
+	os_memset(buffer, 0xFF, sizeof(uint8_t) * EPD_RAM_WIDTH * EPD_BUFFER_ROWS);
 }
 
 /**
@@ -344,14 +560,98 @@ void ICACHE_FLASH_ATTR EPDDisplayClear() {
  * @param color BLACK = 0, WHITE = 1
  * */
 void ICACHE_FLASH_ATTR EPDDrawHorizontal(uint16_t x, uint16_t y, uint8_t color) {
-	uint32_t byteIndex = ((EPD_HEIGHT - 1) << 4) + (y >> 3) - (x << 4);
+	int32_t row = (EPD_HEIGHT - 1) - (int32_t)x;
+	uint32_t byteIndex;
 	uint8_t bitVal = (color & 0x1);
 	uint8_t shift = (7 - (y & 0x7));
 
+	// 超出屏幕或当前条带
+	if(row < bandRowStart || row > bandRowEnd || y >= EPD_WIDTH) {
+		return;
+	}
+	byteIndex = ((row - bandRowStart) << 4) + (y >> 3);
+
     *(buffer + byteIndex) &= ~((uint8_t)1 << shift);
     *(buffer + byteIndex) |= (bitVal << shift);
 }
 
+/**
+ * @brief 填充一段竖直像素，对应同一RAM行内连续的位
+ * @note 中间整字节直接写入，首尾字节按掩码读-改-写
+ * @param x 水平坐标(0~249)
+ * @param yStart,yEnd 垂直方向范围(0~121)
+ * @param color 颜色
+ * */
+void ICACHE_FLASH_ATTR EPDFillSpan(uint16_t x, uint16_t yStart, uint16_t yEnd, uint8_t color) {
+	int32_t row = (EPD_HEIGHT - 1) - (int32_t)x;
+	uint8_t fill = (color & 0x1) ? 0xFF : 0x00;
+	uint8_t head, tail, *line;
+	uint16_t i, byteStart, byteEnd;
+
+	// 超出屏幕或当前条带
+	if(row < bandRowStart || row > bandRowEnd || yStart > yEnd || yStart >= EPD_WIDTH) {
+		return;
+	}
+	if(yEnd >= EPD_WIDTH) {
+		yEnd = (EPD_WIDTH - 1);
+	}
+	line = buffer + ((row - bandRowStart) << 4);
+	byteStart = (yStart >> 3);
+	byteEnd = (yEnd >> 3);
+	// 字节高位对应较小的y
+	head = (uint8_t)(0xFF >> (yStart & 0x7));
+	tail = (uint8_t)(0xFF << (7 - (yEnd & 0x7)));
+
+	if(byteStart == byteEnd) {
+		head &= tail;
+		*(line + byteStart) = (*(line + byteStart) & ~head) | (fill & head);
+		return;
+	}
+	*(line + byteStart) = (*(line + byteStart) & ~head) | (fill & head);
+	for(i = (byteStart + 1); i < byteEnd; i++) {
+		*(line + i) = fill;
+	}
+	*(line + byteEnd) = (*(line + byteEnd) & ~tail) | (fill & tail);
+}
+
+/**
+ * @brief 按列写入1bit位图，bits为1的像素使用前景色，其余使用背景色
+ * @note 一列对应同一RAM行，最多跨越5个字节，每字节一次掩码读-改-写
+ * @param x 水平坐标(0~249)
+ * @param y 列起始垂直坐标(0~121)
+ * @param bits 列数据，最高位对应y
+ * @param height 列高度(1~32)
+ * @param foreground,background 前景色/背景色
+ * */
+void ICACHE_FLASH_ATTR EPDBlitColumn(uint16_t x, uint16_t y, uint32_t bits, uint8_t height, uint8_t foreground, uint8_t background) {
+	int32_t row = (EPD_HEIGHT - 1) - (int32_t)x;
+	uint32_t mask, value;
+	uint64_t mask64, value64;
+	uint8_t k, m, v, *line;
+
+	if(row < bandRowStart || row > bandRowEnd || y >= EPD_WIDTH || height == 0) {
+		return;
+	}
+	if((y + height) > EPD_WIDTH) {
+		height = (EPD_WIDTH - y);
+	}
+	mask = (height >= 32) ? 0xFFFFFFFF : ~(0xFFFFFFFF >> height);
+	value = (((foreground & 0x1) ? bits : 0) | ((background & 0x1) ? ~bits : 0)) & mask;
+	// 按y在字节内的偏移右移，拼成从(y >> 3)开始的字节序列
+	mask64 = ((uint64_t)mask << 32) >> (y & 0x7);
+	value64 = ((uint64_t)value << 32) >> (y & 0x7);
+	line = buffer + ((row - bandRowStart) << 4) + (y >> 3);
+
+	for(k = 0; k < 5; k++) {
+		m = (uint8_t)(mask64 >> (56 - (k << 3)));
+		if(m == 0) {
+			break;
+		}
+		v = (uint8_t)(value64 >> (56 - (k << 3)));
+		*(line + k) = (*(line + k) & ~m) | (v & m);
+	}
+}
+
 /**
  * @brief 垂直方式写显存
  * @param x (0~121)
@@ -359,50 +659,338 @@ void ICACHE_FLASH_ATTR EPDDrawHorizontal(uint16_t x, uint16_t y, uint8_t color)
  * @param color BLACK = 0, WHITE = 1
  * */
 void ICACHE_FLASH_ATTR EPDDrawVertical(uint16_t x, uint16_t y, uint8_t color) {
-    uint32_t byteIndex = (y << 4) + (x >> 3);
+    uint32_t byteIndex;
 	uint8_t bitVal = (color & 0x1);
 	uint8_t shift = (7 - (x & 0x7));
 
+	if((int32_t)y < bandRowStart || (int32_t)y > bandRowEnd || x >= EPD_WIDTH) {
+		return;
+	}
+	byteIndex = ((y - bandRowStart) << 4) + (x >> 3);
+
 	*(buffer + byteIndex) &= ~((uint8_t)1 << shift);
 	*(buffer + byteIndex) |= (bitVal << shift);
 }
 
+/**
+ * @brief 整屏显存异步写入控制器，完成后广播MAIN_EVENT_EPD_FLUSHED
+ * */
 STATUS ICACHE_FLASH_ATTR EPDFlush() {
-	return EPDFillData(buffer);
+#ifdef EPD_BANDED_RENDER
+	// 没有整帧显存，使用EPDBandFlush逐带写入
+	return FAIL;
+#else
+	if(IDLE != epd_status) {
+		return FAIL;
+	}
+	syncRowStart = 0;
+	syncRowEnd = EPD_HEIGHT - 1;
+	syncColStart = 0;
+	syncColEnd = EPD_RAM_WIDTH - 1;
+	EPDFlushStart(EPD_TIMING_FULL);
+	return OK;
+#endif
 }
 
-STATUS ICACHE_FLASH_ATTR EPDFillData(uint8_t *data) {
-    int i = 0, j = 0;
-    if(BUSY == epd_status) {
+/**
+ * @brief 设置写入窗口并发送写RAM命令，之后的数据按窗口自动换行
+ * @param cmd 0x24:新数据RAM, 0x26:旧数据RAM
+ * @param rowStart,rowEnd RAM行范围(0~249)
+ * @param colStart,colEnd RAM列字节范围(0~15)
+ * */
+static void ICACHE_FLASH_ATTR EPDBeginWindow(uint8_t cmd, uint16_t rowStart, uint16_t rowEnd, uint16_t colStart, uint16_t colEnd) {
+	// 窗口内地址计数器自动换行，只需设置一次光标
+	EPDSetWindow(colStart, colEnd, rowStart, rowEnd);
+	EPDSetCursor(colStart, rowStart);
+	HspiSendCMD(cmd);
+}
+
+/**
+ * @brief 发送窗口内若干行的数据，需先调用EPDBeginWindow
+ * @param *data rowStart行起始数据，每行EPD_RAM_WIDTH字节
+ * @param rowStart,rowEnd 本次发送的RAM行范围
+ * @param colStart,colEnd RAM列字节范围(0~15)
+ * */
+static void ICACHE_FLASH_ATTR EPDWriteRows(const uint8_t *data, uint16_t rowStart, uint16_t rowEnd, uint16_t colStart, uint16_t colEnd) {
+	// 拼接窗口内各行数据，凑满一次spi传输
+	uint8_t chunk[64];
+	uint32_t j, fill = 0;
+	uint32_t width = (colEnd - colStart + 1);
+#ifdef EPD_PROFILE_FLUSH
+	uint32_t ccount = EPDGetCycleCount();
+#endif
+
+	if(width == EPD_RAM_WIDTH) {
+		// 整行宽度的窗口在显存中连续
+		HspiSendDATABurst(data, ((rowEnd - rowStart + 1) * EPD_RAM_WIDTH));
+	}else {
+		for(j = rowStart; j <= rowEnd; j++) {
+			if((fill + width) > sizeof(chunk)) {
+				HspiSendDATABurst(chunk, fill);
+				fill = 0;
+			}
+			os_memcpy((chunk + fill), (data + (j - rowStart) * EPD_RAM_WIDTH + colStart), width);
+			fill += width;
+		}
+		if(fill > 0) {
+			HspiSendDATABurst(chunk, fill);
+		}
+	}
+
+#ifdef EPD_PROFILE_FLUSH
+	os_printf("epd write %d bytes, %d cycles\n", ((rowEnd - rowStart + 1) * width), (EPDGetCycleCount() - ccount));
+#endif
+#ifdef EPD_ESTIMATE_ENERGY
+	bytesWritten += ((rowEnd - rowStart + 1) * width);
+#endif
+}
+
+/**
+ * @brief 写入数据指定窗口到控制器RAM
+ * @param cmd 0x24:新数据RAM, 0x26:旧数据RAM
+ * @param *data rowStart行起始数据，每行EPD_RAM_WIDTH字节
+ * @param rowStart,rowEnd RAM行范围(0~249)
+ * @param colStart,colEnd RAM列字节范围(0~15)
+ * */
+static void ICACHE_FLASH_ATTR EPDWriteWindow(uint8_t cmd, const uint8_t *data, uint16_t rowStart, uint16_t rowEnd, uint16_t colStart, uint16_t colEnd) {
+	EPDBeginWindow(cmd, rowStart, rowEnd, colStart, colEnd);
+	EPDWriteRows(data, rowStart, rowEnd, colStart, colEnd);
+}
+
+/**
+ * @brief 开始异步写入显存中的同步窗口(syncRow/syncCol)到0x24 RAM
+ * @note 写入期间状态为PENDING，完成后广播MAIN_EVENT_EPD_FLUSHED，期间不可修改显存
+ * @param type EPD_TIMING_FULL / EPD_TIMING_PARTIAL
+ * */
+static void ICACHE_FLASH_ATTR EPDFlushStart(uint8_t type) {
+	timings[timingHead].flush = system_get_time();
+	timings[timingHead].type = type;
+	timings[timingHead].bytes = (syncRowEnd - syncRowStart + 1) * (syncColEnd - syncColStart + 1);
+	EPDBeginWindow(0x24, syncRowStart, syncRowEnd, syncColStart, syncColEnd);
+	flushRow = syncRowStart;
+	epd_status = PENDING;
+	updating = TRUE;
+	system_os_post(EPD_FLUSH_TASK_PRIO, 0, 0);
+}
+
+/**
+ * @brief 异步写入任务，每次写入EPD_FLUSH_CHUNK_ROWS行后让出CPU
+ * */
+static void ICACHE_FLASH_ATTR EPDFlushTask(os_event_t *event) {
+	uint16_t rowEnd;
+	// EPDReset会取消未完成的写入
+	if(PENDING != epd_status) {
+		return;
+	}
+	rowEnd = flushRow + EPD_FLUSH_CHUNK_ROWS - 1;
+	if(rowEnd > syncRowEnd) {
+		rowEnd = syncRowEnd;
+	}
+	EPDWriteRows((buffer + flushRow * EPD_RAM_WIDTH), flushRow, rowEnd, syncColStart, syncColEnd);
+	flushRow = rowEnd + 1;
+	if(flushRow <= syncRowEnd) {
+		system_os_post(EPD_FLUSH_TASK_PRIO, 0, 0);
+		return;
+	}
+	epd_status = IDLE;
+	EventBusGetDefault()->post(MAIN_EVENT_EPD_FLUSHED, 0);
+}
+
+/**
+ * @brief 局部写入显存，仅发送变化区域所在的字节窗口
+ * @note 需配合LUT_PARTIAL_UPDATE使用，且控制器RAM保存着上一帧(EPDCanPartialUpdate)
+ *       异步写入，完成后广播MAIN_EVENT_EPD_FLUSHED
+ * @param xStart,xEnd 水平方向范围(0~249)
+ * @param yStart,yEnd 垂直方向范围(0~121)
+ * */
+STATUS ICACHE_FLASH_ATTR EPDFlushWindow(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) {
+#ifdef EPD_BANDED_RENDER
+    return FAIL;
+#endif
+    if(IDLE != epd_status) {
     	return FAIL;
     }
-    EPDSetWindow(0, EPD_WIDTH, 0, EPD_HEIGHT);
-    for(j = 0; j < EPD_HEIGHT; j++) {
-    	EPDSetCursor(0, j);
-    	HspiSendCMD(0x24);
-        for (i = 0; i < EPD_RAM_WIDTH; i++) {
-        	HspiSendDATA(*(data + j * EPD_RAM_WIDTH + i));
-        }
+    if(xEnd >= EPD_HEIGHT || yEnd >= EPD_WIDTH || xStart > xEnd || yStart > yEnd) {
+    	return FAIL;
+    }
+    // 水平坐标x对应RAM行(逆序), 垂直坐标y对应RAM列字节
+    syncRowStart = (EPD_HEIGHT - 1) - xEnd;
+    syncRowEnd = (EPD_HEIGHT - 1) - xStart;
+    syncColStart = (yStart >> 3);
+    syncColEnd = (yEnd >> 3);
+    EPDFlushStart(EPD_TIMING_PARTIAL);
+    return OK;
+}
+
+STATUS ICACHE_FLASH_ATTR EPDFillData(uint8_t *data) {
+    if(IDLE != epd_status) {
+    	return FAIL;
     }
+    // 整屏窗口，一次设置光标后连续写入4000字节
+    EPDWriteWindow(0x24, data, 0, (EPD_HEIGHT - 1), 0, (EPD_RAM_WIDTH - 1));
+    syncRowStart = 0;
+    syncRowEnd = EPD_HEIGHT - 1;
+    syncColStart = 0;
+    syncColEnd = EPD_RAM_WIDTH - 1;
     return OK;
 }
 
+/**
+ * @brief 设置刷新完成后是否保留控制器RAM
+ * @note 保留时EPD保持供电并进入DEEP_SLEEP_MODE1, 下次更新可以只发送变化窗口
+ * @param retain TRUE:保留, FALSE:断电
+ * */
+void ICACHE_FLASH_ATTR EPDSetRetainRAM(BOOL retain) {
+	retainRAM = retain;
+}
+
+/**
+ * @brief 控制器RAM是否保存着屏幕上的内容，可以进行局部刷新
+ * @note 连续局部刷新次数和残影由refresh_policy决定，驱动不再限制
+ * */
+BOOL ICACHE_FLASH_ATTR EPDCanPartialUpdate() {
+	return ramValid;
+}
+
 
 STATUS ICACHE_FLASH_ATTR EPDGetStatus() {
 	return epd_status;
 }
 
+/**
+ * @brief 本次更新是否仍在使用显存
+ * @note 从EPDFlush/EPDFlushWindow开始写入到刷新完成断电为止，期间写入任务和0x26同步都会读取显存，
+ *       写入与刷新之间epd_status短暂为IDLE，不能只依据EPDGetStatus判断
+ * */
+BOOL ICACHE_FLASH_ATTR EPDIsUpdating() {
+	return updating;
+}
+
+/**
+ * @brief 读取最近完成的刷新计时记录
+ * @param *records 记录存储区，按时间从旧到新排列
+ * @param max 最多读取的记录数
+ * @return 读取的记录数
+ * */
+uint8_t ICACHE_FLASH_ATTR EPDGetTimings(EPDTiming *records, uint8_t max) {
+	uint8_t i, count = (timingCount < max) ? timingCount : max;
+	// 最旧的记录位于timingHead之前timingCount个位置
+	uint8_t index = (timingHead + EPD_TIMING_RECORDS - count) % EPD_TIMING_RECORDS;
+
+	for(i = 0; i < count; i++) {
+		os_memcpy((records + i), &timings[index], sizeof(EPDTiming));
+		index = (index + 1) % EPD_TIMING_RECORDS;
+	}
+	return count;
+}
+
 void ICACHE_FLASH_ATTR EPDFillDisplayRAM(uint8_t *ptr, uint16_t offset, uint16_t length) {
 	uint32_t i = 0;
+	int32_t row;
 	for(i = 0; i < length; i++) {
-		*(buffer + offset + i) = *(ptr + i);
+		// 仅写入当前条带内的数据
+		row = ((offset + i) >> 4);
+		if(row >= bandRowStart && row <= bandRowEnd) {
+			*(buffer + offset + i - (bandRowStart << 4)) = *(ptr + i);
+		}
+	}
+}
+
+/**
+ * @brief 放弃本次刷新(如帧内容与屏幕相同)，控制器断电进入深度睡眠
+ * */
+STATUS ICACHE_FLASH_ATTR EPDCancelUpdate() {
+	if(IDLE != epd_status) {
+		return FAIL;
+	}
+	EPDDoSleep(FALSE);
+	return OK;
+}
+
+#ifdef EPD_BANDED_RENDER
+
+/**
+ * @brief 开始绘制第band个条带，清空条带缓存
+ * @param band 0 ~ (EPD_BAND_COUNT - 1)
+ * */
+void ICACHE_FLASH_ATTR EPDBandBegin(uint8_t band) {
+	bandRowStart = band * EPD_BAND_ROWS;
+	bandRowEnd = bandRowStart + EPD_BAND_ROWS - 1;
+	if(bandRowEnd > (EPD_HEIGHT - 1)) {
+		bandRowEnd = (EPD_HEIGHT - 1);
+	}
+	EPDDisplayClear();
+}
+
+/**
+ * @brief 当前条带对应的水平坐标范围，用于绘制时裁剪
+ * @param *xStart,*xEnd 水平方向范围(0~249)
+ * */
+void ICACHE_FLASH_ATTR EPDGetBandRect(uint16_t *xStart, uint16_t *xEnd) {
+	*xStart = (EPD_HEIGHT - 1) - bandRowEnd;
+	*xEnd = (EPD_HEIGHT - 1) - bandRowStart;
+}
+
+/**
+ * @brief 当前条带写入控制器0x24 RAM
+ * */
+STATUS ICACHE_FLASH_ATTR EPDBandFlush() {
+	if(IDLE != epd_status) {
+		return FAIL;
+	}
+	if(timings[timingHead].flush == 0) {
+		timings[timingHead].flush = system_get_time();
+	}
+	timings[timingHead].bytes += (bandRowEnd - bandRowStart + 1) * EPD_RAM_WIDTH;
+	EPDWriteWindow(0x24, buffer, bandRowStart, bandRowEnd, 0, (EPD_RAM_WIDTH - 1));
+	return OK;
+}
+
+#endif
+
+#ifdef EPD_ESTIMATE_ENERGY
+/**
+ * @brief 串口输出本次更新的耗时(测量值)与能耗估算值(uJ)
+ * @note 写入阶段只计MCU电流，刷新阶段计MCU+控制器电流，电流取EPD_EST_*常量
+ * @param refreshed 本次刷新是否正常完成
+ * */
+static void ICACHE_FLASH_ATTR EPDReportEnergyEstimate(BOOL refreshed) {
+	uint32_t now = system_get_time();
+	uint32_t writeMs = (timings[timingHead].refresh - updateStartTime) / 1000;
+	uint32_t refreshMs = (now - timings[timingHead].refresh) / 1000;
+	uint32_t energy;
+	// uA * ms / 1000 = uC, uC * mV / 1000 = uJ
+	energy = (EPD_EST_MCU_CURRENT_UA * (writeMs + refreshMs) / 1000) * EPD_EST_SUPPLY_MV / 1000;
+	energy += (EPD_EST_REFRESH_CURRENT_UA * refreshMs / 1000) * EPD_EST_SUPPLY_MV / 1000;
+
+	os_printf("epd update: %s, %s, %d bytes, write %d ms, refresh %d ms, estimated %d uJ\n",
+			(timings[timingHead].type == EPD_TIMING_PARTIAL) ? "partial" : "full", refreshed ? "ok" : "timeout",
+			bytesWritten, writeMs, refreshMs, energy);
+	if(retainRAM && refreshed) {
+		// 保持RAM的代价按休眠时长累计
+		os_printf("epd retain: estimated %d nW while sleeping\n", (EPD_EST_RETAIN_CURRENT_UA * EPD_EST_SUPPLY_MV));
 	}
 }
+#endif
 
-static void ICACHE_FLASH_ATTR EPDDoSleep() {
+/**
+ * @brief 刷新完成后进入深度睡眠
+ * @param refreshed 本次刷新是否正常完成
+ * */
+static void ICACHE_FLASH_ATTR EPDDoSleep(BOOL refreshed) {
+#ifdef EPD_BANDED_RENDER
+	// 没有整帧显存无法同步旧数据RAM
+	ramValid = FALSE;
+#else
+	ramValid = (retainRAM && refreshed && buffer != NULL);
+#endif
+	if(ramValid) {
+		// 刷新完成后屏幕内容即为新数据，同步到旧数据RAM作为下次局部刷新的比较基准
+		EPDWriteWindow(0x26, (buffer + syncRowStart * EPD_RAM_WIDTH), syncRowStart, syncRowEnd, syncColStart, syncColEnd);
+	}
 	// DEEP_SLEEP_MODE
 	HspiSendCMD(DEEP_SLEEP_MODE_CMD);
-    HspiSendDATA(DEEP_SLEEP_MODE2);
+    HspiSendDATA(ramValid ? DEEP_SLEEP_MODE1 : DEEP_SLEEP_MODE2);
     transfer_type = UNKNOWN_TYPE;
 	PIN_FUNC_SELECT(PERIPHS_IO_MUX_MTCK_U, FUNC_GPIO13);
 	PIN_PULLUP_DIS(PERIPHS_IO_MUX_MTCK_U);
@@ -417,10 +1005,19 @@ static void ICACHE_FLASH_ATTR EPDDoSleep() {
 	GPIO_OUTPUT_SET(HSPI_SCLK_PIN, GPIO_PIN_HIGH);
 
 	//GPIO_OUTPUT_SET(EPD_RESET_PIN, GPIO_PIN_LOW);
-	GPIO_OUTPUT_SET(EPD_BUSY_PIN, GPIO_PIN_HIGH);
+	// BUSY由控制器驱动，保持输入，保留RAM时控制器仍在输出高电平
 	GPIO_OUTPUT_SET(EPD_DC_PIN, GPIO_PIN_HIGH);
 	// disable EPD power control mosfet
-	gpio16_output_set(GPIO_PIN_HIGH);
+	if(!ramValid) {
+		gpio16_output_set(GPIO_PIN_HIGH);
+	}
+	// 本次计时记录完成
+	timings[timingHead].sleep = system_get_time();
+	timingHead = (timingHead + 1) % EPD_TIMING_RECORDS;
+	if(timingCount < EPD_TIMING_RECORDS) {
+		timingCount++;
+	}
+	updating = FALSE;
 }
 
 
@@ -18,6 +18,10 @@ static DoubleClickListener thisDoubleClickListener = NULL;
 
 static LongClickListener thisLongClickListener = NULL;
 
+// 共用GPIO中断向量的其他引脚监听(EPD BUSY)
+static PinIRQListener thisPinIRQListener = NULL;
+static uint8_t thisListenPin = 0xFF;
+
 static uint32_t firstTime  = 0, secondTime  = 0, elapse;
 static uint32_t clickCount = 0;
 
@@ -34,6 +38,11 @@ static void gpio_irq_handler(void *arg) {
 
     GPIO_REG_WRITE(GPIO_STATUS_W1TC_ADDRESS, pin_status);
 
+    // 先处理其他引脚，避免被按键消抖延时
+    if(thisPinIRQListener != NULL && (pin_status & BIT(thisListenPin))) {
+    	thisPinIRQListener();
+    }
+
     if(pin_status & BIT(USER_BUTTON_PIN)) {
     	// 消抖
     	os_delay_us(5000);
@@ -142,6 +151,28 @@ void ICACHE_FLASH_ATTR UserButtonIRQInit(void) {
 	ETS_GPIO_INTR_ENABLE();
 }
 
+/**
+ * @brief 仅关闭按键引脚中断，共用向量上的其他引脚中断不受影响
+ * */
+void ICACHE_FLASH_ATTR UserButtonIRQDisable(void) {
+	gpio_pin_intr_state_set(GPIO_ID_PIN(USER_BUTTON_PIN), GPIO_PIN_INTR_DISABLE);
+	GPIO_REG_WRITE(GPIO_STATUS_W1TC_ADDRESS, BIT(USER_BUTTON_PIN));
+}
+
+/**
+ * @brief 注册其他引脚的中断监听，与按键共用GPIO中断向量
+ * @note 引脚触发方式由调用者通过gpio_pin_intr_state_set设置，监听函数在中断中执行不能放在flash
+ * @param pin GPIO引脚
+ * @param listener 中断监听
+ * */
+void ICACHE_FLASH_ATTR UserButtonAddPinIRQListener(uint8_t pin, PinIRQListener listener) {
+	ETS_GPIO_INTR_DISABLE();
+	thisListenPin = pin;
+	thisPinIRQListener = listener;
+	ETS_GPIO_INTR_ATTACH(gpio_irq_handler, NULL);
+	ETS_GPIO_INTR_ENABLE();
+}
+
 uint8_t ICACHE_FLASH_ATTR UserButtonLevelRead(void) {
 	return GPIO_INPUT_GET(USER_BUTTON_PIN);
 }
@@ -6,8 +6,73 @@
  */
 
 #include "graphics/displayio.h"
+#include "user_interface.h"
 
 static BOOL ICACHE_FLASH_ATTR loadFontBitmap(uint8_t *buffer, wchar ch, Font *font);
+static BOOL ICACHE_FLASH_ATTR GuiIsVisible(int16_t left, int16_t top, int16_t right, int16_t bottom);
+static BOOL ICACHE_FLASH_ATTR GuiIsInside(int16_t left, int16_t top, int16_t right, int16_t bottom);
+static void ICACHE_FLASH_ATTR GuiPutPixel(int16_t x, int16_t y, uint8_t color, BOOL inside);
+static void ICACHE_FLASH_ATTR GuiBlitColumn(int16_t x, int16_t y, uint32_t bits, uint8_t height, uint8_t foreground, uint8_t background);
+static uint32_t ICACHE_FLASH_ATTR GuiHashUpdate(uint32_t hash, const uint8_t *data, uint32_t length);
+static void ICACHE_FLASH_ATTR GuiTranspose8(const uint8_t *in, uint8_t *out);
+static BOOL ICACHE_FLASH_ATTR GuiReadPwiColumn(FileReader *reader, uint8_t flags, uint8_t *column, uint32_t length,
+		uint8_t *runValue, uint32_t *runLeft);
+static void ICACHE_FLASH_ATTR GuiBlitPackedLines(uint8_t lines[][32], uint8_t rows, uint16_t xStart, uint16_t y, uint16_t width);
+#ifdef GUI_PROFILE_DRAW
+static void ICACHE_FLASH_ATTR GuiReportDrawProfile();
+#endif
+#ifndef EPD_BANDED_RENDER
+static uint32_t ICACHE_FLASH_ATTR GuiPackLayer(const uint8_t *src, uint32_t length, uint32_t *position, uint8_t *out, uint32_t capacity);
+static BOOL ICACHE_FLASH_ATTR GuiUnpackLayer(const uint8_t *data, uint32_t length, uint8_t *out, uint32_t size);
+static void ICACHE_FLASH_ATTR GuiDropLayers();
+#endif
+
+// 绘制裁剪区域，超出区域的图元直接跳过
+static Rect clipRect = {0, 0, (SCREEN_WIDTH - 1), (SCREEN_HEIGHT - 1)};
+// GuiPushClipRect保存的外层裁剪区域
+static Rect clipStack[GUI_CLIP_STACK_DEPTH];
+static uint8_t clipDepth = 0;
+
+#ifdef GUI_PROFILE_DRAW
+static inline uint32_t GuiGetCycleCount() {
+	uint32_t ccount;
+	__asm__ __volatile__("rsr %0, ccount" : "=a"(ccount));
+	return ccount;
+}
+
+// 本次绘制中GuiFillColor的调用次数、填充像素数和CPU周期数
+static uint32_t fillCalls = 0, fillPixels = 0, fillCycles = 0;
+// 本次绘制中GuiDrawChar绘制的字符数和CPU周期数(含读取字模)
+static uint32_t charCalls = 0, charCycles = 0;
+// 上一次输出时的字模缓存统计，用于计算本次绘制的命中次数
+static FontCacheStats lastCacheStats;
+#endif
+
+#ifdef EPD_BANDED_RENDER
+// 分带渲染时由GuiRenderBands逐带调用
+static GuiRenderCallback pendingRender = NULL;
+static uint32_t pendingArg = 0;
+#else
+// 上一次送显帧的行/列签名，用于计算变化区域
+static uint16_t rowSignature[EPD_HEIGHT];
+static uint32_t colSignature[EPD_RAM_WIDTH];
+static BOOL signatureValid = FALSE;
+// 只比较部分行后列签名不再对应当前帧
+static BOOL colSignatureValid = FALSE;
+// 上一次GuiRender的视图，用于判断显存中是否保留着同一视图的内容
+static GuiRenderCallback lastRender = NULL;
+static uint32_t lastArg = 0;
+static BOOL frameRetained = FALSE;
+// 显存被EPD更新占用时推迟的绘制，刷新完成后由GuiRenderDeferred执行
+static GuiRenderCallback deferredRender = NULL;
+static uint32_t deferredArg = 0;
+// 显存相对于签名的变化范围，renderDirty为本次绘制开始前的状态
+static uint8_t frameDirty = GUI_DIRTY_UNKNOWN;
+static uint8_t renderDirty = GUI_DIRTY_UNKNOWN;
+static Rect dirtyHint;
+// 各页面的静态图层和整帧缓存
+static GuiLayer layers[GUI_LAYER_SLOTS];
+#endif
 
 /**
  * @breif 在屏幕上绘制一像素
@@ -16,7 +81,7 @@ static BOOL ICACHE_FLASH_ATTR loadFontBitmap(uint8_t *buffer, wchar ch, Font *fo
  * @param color RGB565颜色
  * */
 void ICACHE_FLASH_ATTR GuiDrawPixel(uint16_t x, uint16_t y, uint8_t color) {
-	EPDDrawHorizontal(x, y, color);
+	GuiPutPixel((int16_t)x, (int16_t)y, color, FALSE);
 }
 
 /**
@@ -28,12 +93,37 @@ void ICACHE_FLASH_ATTR GuiDrawPixel(uint16_t x, uint16_t y, uint8_t color) {
  * @param color RGB565颜色
  * */
 void ICACHE_FLASH_ATTR GuiFillColor(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, uint8_t color) {
-	uint16_t i, j;
-    for(i = yStart; i <= yEnd; i++) {
-        for(j = xStart; j <= xEnd; j++) {
-        	EPDDrawHorizontal(j, i, color);
-        }
-    }
+	// 图形函数可能传入负坐标，按有符号数与裁剪区域求交
+	int16_t left = (int16_t)xStart, top = (int16_t)yStart;
+	int16_t right = (int16_t)xEnd, bottom = (int16_t)yEnd;
+	int16_t x;
+#ifdef GUI_PROFILE_DRAW
+	uint32_t ccount = GuiGetCycleCount();
+#endif
+
+	if(left < clipRect.left) left = clipRect.left;
+	if(top < clipRect.top) top = clipRect.top;
+	if(right > clipRect.right) right = clipRect.right;
+	if(bottom > clipRect.bottom) bottom = clipRect.bottom;
+	if(left > right || top > bottom) {
+		return;
+	}
+	if(top == bottom) {
+		// 单像素高的水平线(矩形边框等)每列只有一个像素，竖直段的首尾掩码计算反而更慢
+		for(x = left; x <= right; x++) {
+			EPDDrawHorizontal(x, top, color);
+		}
+	}else {
+		// 同一x的像素位于同一RAM行，按竖直段整字节填充
+		for(x = left; x <= right; x++) {
+			EPDFillSpan(x, top, bottom, color);
+		}
+	}
+#ifdef GUI_PROFILE_DRAW
+	fillCycles += (GuiGetCycleCount() - ccount);
+	fillCalls++;
+	fillPixels += (right - left + 1) * (bottom - top + 1);
+#endif
 }
 
 /**
@@ -52,8 +142,20 @@ void ICACHE_FLASH_ATTR GuiDrawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y
     int16_t drawx = x1;
     int16_t drawy = y1;
     int16_t n = 0;
+    BOOL inside;
 
-    GuiDrawPixel(drawx, drawy, color);
+    // 竖直线即为一段连续位，水平线逐RAM行填充，由GuiFillColor统一裁剪
+    if(dx == 0 || dy == 0) {
+    	GuiFillColor(((dx > 0) ? x1 : x2), ((dy > 0) ? y1 : y2), ((dx > 0) ? x2 : x1), ((dy > 0) ? y2 : y1), color);
+    	return;
+    }
+    // 外接矩形与裁剪区域比较一次，完全在区域内时逐点不再检查
+    if(!GuiIsVisible(((dx > 0) ? x1 : x2), ((dy > 0) ? y1 : y2), ((dx > 0) ? x2 : x1), ((dy > 0) ? y2 : y1))) {
+    	return;
+    }
+    inside = GuiIsInside(((dx > 0) ? x1 : x2), ((dy > 0) ? y1 : y2), ((dx > 0) ? x2 : x1), ((dy > 0) ? y2 : y1));
+
+    GuiPutPixel(drawx, drawy, color, inside);
 
     if(dxabs >= dyabs) {
         for(n = 0; n < dxabs; n++) {
@@ -63,7 +165,7 @@ void ICACHE_FLASH_ATTR GuiDrawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y
                 drawy += sgndy;
             }
             drawx += sgndx;
-            GuiDrawPixel(drawx, drawy, color);
+            GuiPutPixel(drawx, drawy, color, inside);
         }
     }else {
         for(n = 0; n < dyabs; n++) {
@@ -73,7 +175,7 @@ void ICACHE_FLASH_ATTR GuiDrawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y
                 drawx += sgndx;
             }
             drawy += sgndy;
-            GuiDrawPixel(drawx, drawy, color);
+            GuiPutPixel(drawx, drawy, color, inside);
         }
     }
 }
@@ -84,13 +186,19 @@ void ICACHE_FLASH_ATTR GuiDrawLine(int16_t x1, int16_t y1, int16_t x2, int16_t y
  *       x1==x2时，y2必须大于y1，且为正整数
  * */
 void ICACHE_FLASH_ATTR GuiDrawDashLine(int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint8_t c ) {
+	BOOL inside;
+
+	if(!GuiIsVisible(x1, y1, x2, y2)) {
+		return;
+	}
+	inside = GuiIsInside(x1, y1, x2, y2);
 	if(y1 == y2) {
 		// 水平虚线
 		while(x1 < x2) {
 			if((x1 + 1) > x2) break;
 
-			GuiDrawPixel(x1, y1, c);
-			GuiDrawPixel(x1 + 1, y1, c);
+			GuiPutPixel(x1, y1, c, inside);
+			GuiPutPixel(x1 + 1, y1, c, inside);
 
 			x1 += 2;
 
@@ -103,8 +211,8 @@ void ICACHE_FLASH_ATTR GuiDrawDashLine(int16_t x1, int16_t y1, int16_t x2, int16
 		while(y1 < y2) {
 			if((y1 + 1) > y2) break;
 
-			GuiDrawPixel(x1, y1, c);
-			GuiDrawPixel(x1, y1 + 1, c);
+			GuiPutPixel(x1, y1, c, inside);
+			GuiPutPixel(x1, y1 + 1, c, inside);
 
 			y1 += 2;
 
@@ -150,23 +258,25 @@ void ICACHE_FLASH_ATTR GuiDrawArc(int16_t x0, int16_t y0, int16_t r, uint8_t s,
     if ( x0 < 0 ) return;
     if ( y0 < 0 ) return;
     if ( r <= 0 ) return;
+    if (!GuiIsVisible(x0 - r, y0 - r, x0 + r, y0 + r)) return;
 
+    BOOL inside = GuiIsInside(x0 - r, y0 - r, x0 + r, y0 + r);
     int16_t xd = 1 - (r << 1);
     int16_t yd = 0, e = 0, x = r,  y = 0;
 
     while ( x >= y ) {
         // Q1
-        if ( s & 0x01 ) GuiDrawPixel(x0 + x, y0 - y, color);
-        if ( s & 0x02 ) GuiDrawPixel(x0 + y, y0 - x, color);
+        if ( s & 0x01 ) GuiPutPixel(x0 + x, y0 - y, color, inside);
+        if ( s & 0x02 ) GuiPutPixel(x0 + y, y0 - x, color, inside);
         // Q2
-        if ( s & 0x04 ) GuiDrawPixel(x0 - y, y0 - x, color);
-        if ( s & 0x08 ) GuiDrawPixel(x0 - x, y0 - y, color);
+        if ( s & 0x04 ) GuiPutPixel(x0 - y, y0 - x, color, inside);
+        if ( s & 0x08 ) GuiPutPixel(x0 - x, y0 - y, color, inside);
         // Q3
-        if ( s & 0x10 ) GuiDrawPixel(x0 - x, y0 + y, color);
-        if ( s & 0x20 ) GuiDrawPixel(x0 - y, y0 + x, color);
+        if ( s & 0x10 ) GuiPutPixel(x0 - x, y0 + y, color, inside);
+        if ( s & 0x20 ) GuiPutPixel(x0 - y, y0 + x, color, inside);
         // Q4
-        if ( s & 0x40 ) GuiDrawPixel(x0 + y, y0 + x, color);
-        if ( s & 0x80 ) GuiDrawPixel(x0 + x, y0 + y, color);
+        if ( s & 0x40 ) GuiPutPixel(x0 + y, y0 + x, color, inside);
+        if ( s & 0x80 ) GuiPutPixel(x0 + x, y0 + y, color, inside);
         y++;
         e += yd;
         yd += 2;
@@ -187,19 +297,21 @@ void ICACHE_FLASH_ATTR GuiDrawCircle(int16_t x0, int16_t y0, int16_t r, uint8_t
     if (x0 < 0) return;
     if (y0 < 0) return;
     if (r <= 0) return;
+    if (!GuiIsVisible(x0 - r, y0 - r, x0 + r, y0 + r)) return;
 
+    BOOL inside = GuiIsInside(x0 - r, y0 - r, x0 + r, y0 + r);
     int16_t xd = 1 - (r << 1);
     int16_t yd = 0, e = 0, x = r, y = 0;
 
     while (x >= y) {
-        GuiDrawPixel(x0 - x, y0 + y, c);
-        GuiDrawPixel(x0 - x, y0 - y, c);
-        GuiDrawPixel(x0 + x, y0 + y, c);
-        GuiDrawPixel(x0 + x, y0 - y, c);
-        GuiDrawPixel(x0 - y, y0 + x, c);
-        GuiDrawPixel(x0 - y, y0 - x, c);
-        GuiDrawPixel(x0 + y, y0 + x, c);
-        GuiDrawPixel(x0 + y, y0 - x, c);
+        GuiPutPixel(x0 - x, y0 + y, c, inside);
+        GuiPutPixel(x0 - x, y0 - y, c, inside);
+        GuiPutPixel(x0 + x, y0 + y, c, inside);
+        GuiPutPixel(x0 + x, y0 - y, c, inside);
+        GuiPutPixel(x0 - y, y0 + x, c, inside);
+        GuiPutPixel(x0 - y, y0 - x, c, inside);
+        GuiPutPixel(x0 + y, y0 + x, c, inside);
+        GuiPutPixel(x0 + y, y0 - x, c, inside);
         y++;
         e += yd;
         yd += 2;
@@ -216,6 +328,7 @@ void ICACHE_FLASH_ATTR GuiFillCircle(int16_t x0, int16_t y0, int16_t r, uint8_t
     if ( x0 < 0 ) return;
     if ( y0 < 0 ) return;
     if ( r <= 0 ) return;
+    if (!GuiIsVisible(x0 - r, y0 - r, x0 + r, y0 + r)) return;
 
     int16_t xd = 3 - (r << 1);
     int16_t x = 0, y = r;
@@ -255,6 +368,7 @@ void ICACHE_FLASH_ATTR GuiDrawRoundRect(int16_t x1, int16_t y1, int16_t x2, int1
 
     if(r > x2) return;
     if(r > y2) return;
+    if(!GuiIsVisible(x1, y1, x2, y2)) return;
 
     GuiFillColor(x1 + r, y1, x2 - r, y1, c);
     GuiFillColor(x1 + r, y2, x2 - r, y2, c);
@@ -281,6 +395,7 @@ void ICACHE_FLASH_ATTR GuiFillRoundRect(int16_t x1, int16_t y1, int16_t x2, int1
     }
 
     if (r <= 0) return;
+    if (!GuiIsVisible(x1, y1, x2, y2)) return;
 
     xd = 3 - (r << 1);
     x = 0;
@@ -323,6 +438,15 @@ void ICACHE_FLASH_ATTR GuiDrawMesh(int16_t x1, int16_t y1, int16_t x2, int16_t y
       y1 = n;
    }
 
+   if(gridSize == 0 || !GuiIsVisible(x1, y1, x2, y2)) {
+      return;
+   }
+   // 起点按格点对齐到裁剪区域内，终点截到裁剪区域
+   if(x1 < clipRect.left) x1 += ((clipRect.left - x1 + gridSize - 1) / gridSize) * gridSize;
+   if(y1 < clipRect.top) y1 += ((clipRect.top - y1 + gridSize - 1) / gridSize) * gridSize;
+   if(x2 > clipRect.right) x2 = clipRect.right;
+   if(y2 > clipRect.bottom) y2 = clipRect.bottom;
+
    for(m = y1; m <= y2; m += gridSize) {
       for(n = x1; n <= x2; n += gridSize) {
     	  EPDDrawHorizontal(n, m, c);
@@ -340,7 +464,7 @@ void ICACHE_FLASH_ATTR GuiDrawMesh(int16_t x1, int16_t y1, int16_t x2, int16_t y
  * @return TRUE:读取成功, FALSE:读取失败
  * */
 static BOOL ICACHE_FLASH_ATTR loadFontBitmap(uint8_t *buffer, wchar ch, Font *font) {
-    File *file = (File *)font->user_data;
+    File *file = FontGetFile(font);
     uint32_t offset = font->baseAddr;
     offset += font->calcOffset(font, ch);
     if(font->data == NULL && file != NULL) {
@@ -362,9 +486,13 @@ static BOOL ICACHE_FLASH_ATTR loadFontBitmap(uint8_t *buffer, wchar ch, Font *fo
 void ICACHE_FLASH_ATTR GuiDrawChar(wchar ch, uint16_t x, uint16_t y, Color foreground, Color background, Font *font, uint16_t height) {
 	uint32_t j, i;
 	uint32_t bitmapline;
+	// 转置后的字模列，最高位对应字模第一行
+	uint32_t columns[sizeof(uint32_t) * 8];
     // 最大支持单个字模 72字节数据
     uint8_t buffer[FONTBITMAP_BUFFER_SIZE];
-    File file;
+#ifdef GUI_PROFILE_DRAW
+    uint32_t ccount = GuiGetCycleCount();
+#endif
     // 字体范围检查
     if((ch < font->startChar) || (ch > font->endChar)) {
     	return;
@@ -373,35 +501,64 @@ void ICACHE_FLASH_ATTR GuiDrawChar(wchar ch, uint16_t x, uint16_t y, Color foreg
     if(font->lineBytes > sizeof(uint32_t) || font->fontBytes > FONTBITMAP_BUFFER_SIZE) {
     	return;
     }
-    // 对于直接调用GuiDrawChar绘制单个字符时，需要先打开字体文件
-    if(font->user_data == NULL) {
-    	if(!open_file(&file, (char *)font->filename, (char *)font->extname)) {
+    // 字符单元在裁剪区域外，无需读取字模
+    if(!GuiIsVisible((x + 1), y, (x + font->width), (y + height - 1))) {
+    	return;
+    }
+    // 字模缓存命中时无需访问字体文件
+    if(!FontCacheLookup(font, ch, buffer)) {
+    	if(FontGetFile(font) == NULL) {
     		return ;
     	}
-    	font->user_data = &file;
-    }
 
-    if(!loadFontBitmap(buffer, ch, font)) {
-    	// 读取字模数据失败时以foregroundColor填充
-    	os_memset(buffer, 0x55, (sizeof(uint8_t) * FONTBITMAP_BUFFER_SIZE));
+    	if(loadFontBitmap(buffer, ch, font)) {
+    		FontCacheInsert(font, ch, buffer);
+    	}else {
+    		// 读取字模数据失败时以foregroundColor填充
+    		os_memset(buffer, 0x55, (sizeof(uint8_t) * FONTBITMAP_BUFFER_SIZE));
+    	}
     }
-    // 字模绘制 // font->height
+    if(height > (sizeof(uint32_t) * 8)) {
+    	height = (sizeof(uint32_t) * 8);
+    }
+    // pwf字模已按列存储，每列拼成左对齐的列数据直接写入
+    if(FONT_LAYOUT_COLUMN == font->layout) {
+    	for(i = 0; i < font->width; i++) {
+    		bitmapline = 0;
+    		for(j = 0; j < font->lineBytes; j++) {
+    			bitmapline |= ((uint32_t)buffer[i * font->lineBytes + j] << (24 - (j << 3)));
+    		}
+    		GuiBlitColumn((x + i + 1), y, bitmapline, height, foreground, background);
+    	}
+#ifdef GUI_PROFILE_DRAW
+    	charCycles += (GuiGetCycleCount() - ccount);
+    	charCalls++;
+#endif
+    	return;
+    }
+    // 字模按行存储，显存中同一x的像素位于同一RAM行，先转置为按列存储
+    os_memset(columns, 0x00, sizeof(columns));
     for(j = 0; j < height; j++) {
+    	bitmapline = 0;
     	os_memcpy(&bitmapline, (buffer + j * font->lineBytes), font->lineBytes);
     	//字模为大端模式，需要对所使用字模字节序反转
     	bitmapline = font->endianSwap(bitmapline);
-        for(i = 1; i <= font->width; i++) {
-        	// (font->width - i)移位操作需要从(font->width - 1) ~ 0
-        	// font为字节正序即大端模式
-            if((bitmapline >> (font->lineBytes * 8 - i)) & 0x1) {
-            	EPDDrawHorizontal(x + i, y + j, foreground);
-            }else {
-            	EPDDrawHorizontal(x + i, y + j, background);
-            }
-        }
+    	// 左对齐，第i列(1~width)位于bit(32 - i)
+    	bitmapline <<= ((sizeof(uint32_t) - font->lineBytes) * 8);
+    	for(i = 0; bitmapline != 0; i++, bitmapline <<= 1) {
+    		if(bitmapline & 0x80000000) {
+    			columns[i] |= (0x80000000 >> j);
+    		}
+    	}
     }
-
-    font->user_data = NULL;
+    // 每列整字节写入
+    for(i = 1; i <= font->width; i++) {
+    	GuiBlitColumn((x + i), y, columns[i - 1], height, foreground, background);
+    }
+#ifdef GUI_PROFILE_DRAW
+    charCycles += (GuiGetCycleCount() - ccount);
+    charCalls++;
+#endif
 }
 
 /**
@@ -418,18 +575,12 @@ uint16_t ICACHE_FLASH_ATTR GuiDrawString(uint8_t *str, uint16_t xStart, uint16_t
 	uint16_t x = xStart, y = yStart;
 	uint8_t width;
 	wchar ch;
-	File fileCN, fileEN;
 
-	if(!open_file(&fileCN, (char *)font->filename, (char *)font->extname)) {
-		return xStart;
-	}
-	if(!open_file(&fileEN, (char *)engFont->filename, (char *)engFont->extname)) {
+	// 字体文件句柄由loadFont解析并常驻，文件不存在时不绘制
+	if(FontGetFile(font) == NULL || FontGetFile(engFont) == NULL) {
 		return xStart;
 	}
 
-	font->user_data = &fileCN;
-	engFont->user_data = &fileEN;
-
     while(*str != '\0') {
     	width = (*str >= 0x20 && *str <= 0x7E) ? engFont->width : font->width;
     	// 超出当前行宽自动换行
@@ -437,8 +588,6 @@ uint16_t ICACHE_FLASH_ATTR GuiDrawString(uint8_t *str, uint16_t xStart, uint16_t
             x = xStart;
 			y += (font->height + font->vspacing);
             if(y > (SCREEN_HEIGHT - font->height)) {
-            	font->user_data = NULL;
-            	engFont->user_data = NULL;
             	return x;
             }
         }
@@ -450,8 +599,6 @@ uint16_t ICACHE_FLASH_ATTR GuiDrawString(uint8_t *str, uint16_t xStart, uint16_t
 				x = xStart;
 				y += (font->height + font->vspacing);
 				if(y > (SCREEN_HEIGHT - font->height)) {
-					font->user_data = NULL;
-					engFont->user_data = NULL;
 					return x;
 				}
 				continue;
@@ -466,8 +613,6 @@ uint16_t ICACHE_FLASH_ATTR GuiDrawString(uint8_t *str, uint16_t xStart, uint16_t
 			x += font->width;
         }
     }
-    font->user_data = NULL;
-	engFont->user_data = NULL;
     return x;
 }
 
@@ -488,17 +633,14 @@ uint16_t ICACHE_FLASH_ATTR GuiDrawStringUTF8(uint8_t *str, uint16_t xStart, uint
 	uint32_t offset = 0, usc4 = 0;
 	uint16_t utf16[2];
 	uint16_t x = xStart, y = yStart;
-	File fileCN, fileEN;
+	Font *uniFont;
 
-	if(!open_file(&fileCN, (char *)font->filename, (char *)font->extname)) {
+	// 字体文件句柄由loadFont解析并常驻，文件不存在时不绘制
+	if(FontGetFile(font) == NULL || FontGetFile(engFont) == NULL) {
 		return xStart;
 	}
-	if(!open_file(&fileEN, (char *)engFont->filename, (char *)engFont->extname)) {
-		return xStart;
-	}
-
-	font->user_data = &fileCN;
-	engFont->user_data = &fileEN;
+	// 同尺寸的Unicode子集字库，存在时优先使用，免去GB2312转换
+	uniFont = FontGetUnicode(font);
 
 	while(*(str + offset) != '\0') {
 		// utf8转usc4
@@ -509,8 +651,6 @@ uint16_t ICACHE_FLASH_ATTR GuiDrawStringUTF8(uint8_t *str, uint16_t xStart, uint
 			x = xStart;
 			y += (font->height + font->vspacing);
 			if(y > (SCREEN_HEIGHT - font->height)) {
-				font->user_data = NULL;
-				engFont->user_data = NULL;
 				return x;
 			}
 		}
@@ -526,8 +666,6 @@ uint16_t ICACHE_FLASH_ATTR GuiDrawStringUTF8(uint8_t *str, uint16_t xStart, uint
 				x = xStart;
 				y += (font->height + font->vspacing);
 				if(y > (SCREEN_HEIGHT - font->height)) {
-					font->user_data = NULL;
-					engFont->user_data = NULL;
 					return x;
 				}
 				continue;
@@ -538,19 +676,24 @@ uint16_t ICACHE_FLASH_ATTR GuiDrawStringUTF8(uint8_t *str, uint16_t xStart, uint
 		}else {
 			// 多字节按照unicode码解析, usc4转usc2
 			length = UnicodeToUTF16(usc4, utf16);
-			if(length == 1) {
-				// usc2转gb2312
-				code.value = utf16[0];
-				code = QueryGB2312ByUnicode(code.value);
-				ch = (wchar)((code.bytes[0] << 8) | code.bytes[1]);
-				GuiDrawChar(ch, x, y, BLACK, WHITE, font, font->height);
+			// 字符在裁剪区域外时只计算位置，不查询编码
+			if(length == 1 && !GuiIsVisible((x + 1), y, (x + font->width), (y + font->height - 1))) {
+				x += font->width;
+			}else if(length == 1) {
+				if(uniFont != NULL && FontHasGlyph(uniFont, utf16[0])) {
+					GuiDrawChar(utf16[0], x, y, BLACK, WHITE, uniFont, font->height);
+				}else {
+					// usc2转gb2312
+					code.value = utf16[0];
+					code = QueryGB2312ByUnicode(code.value);
+					ch = (wchar)((code.bytes[0] << 8) | code.bytes[1]);
+					GuiDrawChar(ch, x, y, BLACK, WHITE, font, font->height);
+				}
 
 				x += font->width;
 			}
 		}
 	}
-	font->user_data = NULL;
-	engFont->user_data = NULL;
 	return x;
 }
 
@@ -563,12 +706,122 @@ uint16_t ICACHE_FLASH_ATTR GuiDrawStringUTF8(uint8_t *str, uint16_t xStart, uint
  * */
 void ICACHE_FLASH_ATTR GuiDrawBmpImage(char *fileName, char *extName, uint16_t xStart, uint16_t yStart) {
 	File file;
+	// 存在同名的预旋转pwi图片时优先使用
+	if(open_file(&file, fileName, PWI_EXTNAME) && GuiDrawPwiImageImpl(&file, xStart, yStart)) {
+		return;
+	}
 	if(!open_file(&file, fileName, extName)) {
 		return;
 	}
     GuiDrawBmpImageImpl(&file, xStart, yStart);
 }
 
+/**
+ * @brief 绘制pwi格式图片实现，按列解码后整字节写入显存
+ * @param *file 打开的pwi文件
+ * @param xStart 图片左边起始位置
+ * @param yStart 图片上边起始位置
+ * @return TRUE:已处理(包括超出屏幕不绘制), FALSE:不是受支持的pwi文件
+ * */
+BOOL ICACHE_FLASH_ATTR GuiDrawPwiImageImpl(File *file, uint16_t xStart, uint16_t yStart) {
+	PwiHeader header;
+	FileReader reader;
+	uint32_t columnBytes, chunkSize, x, row, bits, runLeft = 0;
+	uint8_t column[PWI_COLUMN_MAX + sizeof(uint32_t)];
+	uint8_t runValue = 0;
+	uint8_t *chunk;
+	// 申请不到块缓存时使用的小块缓存
+	uint32_t fallback[BMP_READER_FALLBACK_SIZE / sizeof(uint32_t)];
+
+	if(read_file(file, 0, (uint8_t *)&header, sizeof(PwiHeader)) != sizeof(PwiHeader)
+			|| header.magic != PWI_MAGIC || header.version != PWI_VERSION) {
+		return FALSE;
+	}
+	if((xStart + header.width > SCREEN_WIDTH) || (yStart + header.height) > SCREEN_HEIGHT || header.height == 0) {
+		return TRUE;
+	}
+	if(!GuiIsVisible(xStart, yStart, (xStart + header.width - 1), (yStart + header.height - 1))) {
+		return TRUE;
+	}
+	columnBytes = ((header.height + 7) >> 3);
+	// 小图标按文件大小申请，最大一整簇
+	chunkSize = ((file->length + 3) & ~0x3);
+	chunkSize = (chunkSize > DATA_AREA_SIZE) ? DATA_AREA_SIZE : chunkSize;
+	chunk = (uint8_t *)os_malloc(chunkSize);
+	if(!open_reader(&reader, file, ((chunk != NULL) ? chunk : (uint8_t *)fallback),
+			((chunk != NULL) ? chunkSize : BMP_READER_FALLBACK_SIZE))) {
+		if(chunk != NULL) {
+			os_free(chunk);
+		}
+		return TRUE;
+	}
+	seek_reader(&reader, sizeof(PwiHeader));
+	// 补齐到4字节，每次按32行写入
+	os_memset(column, 0x00, sizeof(column));
+	for(x = 0; x < header.width; x++) {
+		if(!GuiReadPwiColumn(&reader, header.flags, column, columnBytes, &runValue, &runLeft)) {
+			break;
+		}
+		for(row = 0; row < header.height; row += 32) {
+			bits = ((uint32_t)column[(row >> 3)] << 24) | ((uint32_t)column[(row >> 3) + 1] << 16)
+					| ((uint32_t)column[(row >> 3) + 2] << 8) | column[(row >> 3) + 3];
+			GuiBlitColumn((xStart + x), (yStart + row), bits,
+					(((header.height - row) > 32) ? 32 : (header.height - row)), WHITE, BLACK);
+		}
+	}
+	if(chunk != NULL) {
+		os_free(chunk);
+	}
+	return TRUE;
+}
+
+/**
+ * @brief 读取pwi图片的一列数据，压缩数据的连续段可以跨列
+ * @param *reader 文件读取器
+ * @param flags 图片标志
+ * @param *column 列数据输出
+ * @param length 列字节数
+ * @param *runValue,*runLeft 未用完的连续段字节值和剩余长度
+ * @return TRUE:读取成功, FALSE:数据不完整
+ * */
+static BOOL ICACHE_FLASH_ATTR GuiReadPwiColumn(FileReader *reader, uint8_t flags, uint8_t *column, uint32_t length,
+		uint8_t *runValue, uint32_t *runLeft) {
+	uint32_t cursor = 0, toWrite;
+	uint16_t count;
+	uint8_t byteValue;
+
+	if(!(flags & PWI_FLAG_RLE)) {
+		return (read_reader(reader, column, length) == length);
+	}
+	while(cursor < length) {
+		if(*runLeft > 0) {
+			toWrite = (*runLeft > (length - cursor)) ? (length - cursor) : (*runLeft);
+			os_memset((column + cursor), *runValue, toWrite);
+			cursor += toWrite;
+			*runLeft -= toWrite;
+			continue;
+		}
+		if(read_reader(reader, &byteValue, 1) != 1) {
+			return FALSE;
+		}
+		if((byteValue == 0x00) || (byteValue == 0xFF)) {
+			// 连续段长度，为0时后跟2字节长度
+			count = 0;
+			if(read_reader(reader, (uint8_t *)&count, 1) != 1) {
+				return FALSE;
+			}
+			if(count == 0 && read_reader(reader, (uint8_t *)&count, sizeof(uint16_t)) != sizeof(uint16_t)) {
+				return FALSE;
+			}
+			*runValue = byteValue;
+			*runLeft = count;
+		}else {
+			column[cursor++] = byteValue;
+		}
+	}
+	return TRUE;
+}
+
 /**
  * @brief 绘制bmp格式图片实现，仅支持单色1bit图片
  * @param *file 打开的bmp文件
@@ -576,13 +829,15 @@ void ICACHE_FLASH_ATTR GuiDrawBmpImage(char *fileName, char *extName, uint16_t x
  * @param yStart 图片上边起始位置
  * */
 void ICACHE_FLASH_ATTR GuiDrawBmpImageImpl(File *file, uint16_t xStart, uint16_t yStart) {
-    uint32_t temp = 0;
-    int32_t i, j;
-    uint16_t drawX, drawY = yStart, byteIndex;
-    uint32_t width, height, dataOffset;
-	// 行缓存, 字节对齐 250 / 8 + 1
-    uint8_t lineBuffer[32];
-    uint8_t bitValue;
+    FileReader reader;
+    uint32_t width, height, dataOffset, lineBytes;
+    uint32_t row, rows, k, c, j, x;
+    uint8_t *chunk;
+    // 申请不到整簇块缓存时使用的小块缓存
+    uint32_t fallback[BMP_READER_FALLBACK_SIZE / sizeof(uint32_t)];
+    // 8行块缓存，block[0]为块内最上一行，行字节对齐 250 / 8 + 1
+    uint8_t block[BITS_OF_BYTE][32];
+    uint8_t lines[BITS_OF_BYTE], columns[BITS_OF_BYTE];
 
     if(GuiCheckBMPFormat(file, &width, &height, &dataOffset) != 0) {
     	return;
@@ -590,26 +845,77 @@ void ICACHE_FLASH_ATTR GuiDrawBmpImageImpl(File *file, uint16_t xStart, uint16_t
     if((xStart + width > SCREEN_WIDTH) || (yStart + height) > SCREEN_HEIGHT) {
 		return;
     }
-    temp = width / (sizeof(uint32_t) * BITS_OF_BYTE);
+    if(!GuiIsVisible(xStart, yStart, (xStart + width - 1), (yStart + height - 1))) {
+    	return;
+    }
     // 图片行数据4字节对齐
-    temp = ((temp * sizeof(uint32_t) * BITS_OF_BYTE) < width) ? (temp + 1) : temp;
-    // temp = ((width % i) != 0) ? (temp + 1) : temp;
-    temp <<= 2;
-	// 像素填充
-	for(i = (height - 1); i >= 0; i--) {
-		drawX = xStart;
-		// 读入一行数据，其中包括填充的4字节对齐部分
-    	read_file(file, (dataOffset + (temp * i )), lineBuffer, temp);
-    	for(j = 0; j < width; j++) {
-    		// windows bmp扫描方式是按从左到右、从下到上
-    		byteIndex = (j / 8);
-    		bitValue = ((lineBuffer[byteIndex] >> (7 - (j - byteIndex * 8))) & 0x1);
-    		EPDDrawHorizontal(drawX++, drawY, bitValue);
+    lineBytes = (((width + 31) >> 5) << 2);
+
+    chunk = (uint8_t *)os_malloc(DATA_AREA_SIZE);
+    if(!open_reader(&reader, file, ((chunk != NULL) ? chunk : (uint8_t *)fallback),
+    		((chunk != NULL) ? DATA_AREA_SIZE : BMP_READER_FALLBACK_SIZE))) {
+    	if(chunk != NULL) {
+    		os_free(chunk);
+    	}
+    	return;
+    }
+    seek_reader(&reader, dataOffset);
+    // windows bmp扫描方式是按从左到右、从下到上，顺序读取时从图片底部开始，每8行转置后按列写入
+    for(row = 0; row < height; row += rows) {
+    	rows = ((height - row) > BITS_OF_BYTE) ? BITS_OF_BYTE : (height - row);
+    	os_memset(block, 0x00, sizeof(block));
+    	for(k = 0; k < rows; k++) {
+    		read_reader(&reader, block[rows - 1 - k], lineBytes);
+    	}
+    	for(c = 0; (c << 3) < width; c++) {
+    		for(k = 0; k < BITS_OF_BYTE; k++) {
+    			lines[k] = block[k][c];
+    		}
+    		GuiTranspose8(lines, columns);
+    		for(j = 0, x = (c << 3); j < BITS_OF_BYTE && x < width; j++, x++) {
+    			GuiBlitColumn((xStart + x), (yStart + height - row - rows), ((uint32_t)columns[j] << 24), rows, WHITE, BLACK);
+    		}
     	}
-    	drawY++;
+    }
+    if(chunk != NULL) {
+    	os_free(chunk);
     }
 }
 
+/**
+ * @brief 8x8位矩阵转置，输入为8行(高位在左)，输出为8列(高位在上)
+ * @param *in 8行数据，in[0]为第一行
+ * @param *out 8列数据，out[0]为第一列
+ * */
+static void ICACHE_FLASH_ATTR GuiTranspose8(const uint8_t *in, uint8_t *out) {
+	uint32_t x, y, t;
+	x = ((uint32_t)in[0] << 24) | ((uint32_t)in[1] << 16) | ((uint32_t)in[2] << 8) | in[3];
+	y = ((uint32_t)in[4] << 24) | ((uint32_t)in[5] << 16) | ((uint32_t)in[6] << 8) | in[7];
+
+	t = (x ^ (x >> 7)) & 0x00AA00AA;
+	x = x ^ t ^ (t << 7);
+	t = (y ^ (y >> 7)) & 0x00AA00AA;
+	y = y ^ t ^ (t << 7);
+
+	t = (x ^ (x >> 14)) & 0x0000CCCC;
+	x = x ^ t ^ (t << 14);
+	t = (y ^ (y >> 14)) & 0x0000CCCC;
+	y = y ^ t ^ (t << 14);
+
+	t = (x & 0xF0F0F0F0) | ((y >> 4) & 0x0F0F0F0F);
+	y = ((x << 4) & 0xF0F0F0F0) | (y & 0x0F0F0F0F);
+	x = t;
+
+	out[0] = (uint8_t)(x >> 24);
+	out[1] = (uint8_t)(x >> 16);
+	out[2] = (uint8_t)(x >> 8);
+	out[3] = (uint8_t)x;
+	out[4] = (uint8_t)(y >> 24);
+	out[5] = (uint8_t)(y >> 16);
+	out[6] = (uint8_t)(y >> 8);
+	out[7] = (uint8_t)y;
+}
+
 /**
  * @brief 检查BMP格式是否受支持
  * @param *file 打开的文件指针(open_file/open_file_raw)
@@ -620,30 +926,38 @@ void ICACHE_FLASH_ATTR GuiDrawBmpImageImpl(File *file, uint16_t xStart, uint16_t
  * */
 uint8_t ICACHE_FLASH_ATTR GuiCheckBMPFormat(File *file, uint32_t *width, uint32_t *height, uint32_t *dataOffset) {
     uint32_t temp = 0;
+    // 一次读入文件头至biCompression
+    uint32_t header[BMP_HEADER_LENGTH / sizeof(uint32_t)];
+    uint8_t *data = (uint8_t *)header;
+
+    if(read_file(file, 0, data, BMP_HEADER_LENGTH) != BMP_HEADER_LENGTH) {
+    	return 1;
+    }
     // 只支持Windows 3.1x, 95, NT... DIB(device-independent bitmap)格式
-	read_file(file, BFTYPE, (uint8_t *)&temp, BFTYPE_LENGTH);
+    os_memcpy(&temp, (data + BFTYPE), BFTYPE_LENGTH);
     if(BITMAP_DIB != temp) {
         return 1;
     }
     // biBitCount 只支持单色位图
-    read_file(file, BIBITCOUNT, (uint8_t *)&temp, BIBITCOUNT_LENGTH);
+    temp = 0;
+    os_memcpy(&temp, (data + BIBITCOUNT), BIBITCOUNT_LENGTH);
     if(MONOCHROME != temp) {
         return 1;
     }
     // 只支持BI_RGB无压缩类型
-    read_file(file, BICOMPRESSION, (uint8_t *)&temp, BICOMPRESSION_LENGTH);
+    os_memcpy(&temp, (data + BICOMPRESSION), BICOMPRESSION_LENGTH);
     if(BI_RGB != temp) {
         return 1;
     }
     // 图片大小不可超出屏幕尺寸
-    read_file(file, BIWIDTH, (uint8_t *)&temp, BIWIDTH_LENGTH);
+    os_memcpy(&temp, (data + BIWIDTH), BIWIDTH_LENGTH);
     if(temp > SCREEN_WIDTH) {
     	return 2;
     }
     if(width != NULL) {
     	os_memcpy(width, &temp, sizeof(uint32_t));
     }
-    read_file(file, BIHEIGHT, (uint8_t *)&temp, BIHEIGHT_LENGTH);
+    os_memcpy(&temp, (data + BIHEIGHT), BIHEIGHT_LENGTH);
     if(temp > SCREEN_HEIGHT) {
     	return 2;
     }
@@ -651,26 +965,26 @@ uint8_t ICACHE_FLASH_ATTR GuiCheckBMPFormat(File *file, uint32_t *width, uint32_
     	os_memcpy(height, &temp, sizeof(uint32_t));
     }
     if(dataOffset != NULL) {
-        read_file(file, BFOFFBITS, (uint8_t *)&temp, BFOFFBITS_LENGTH);
-    	os_memcpy(dataOffset, &temp, sizeof(uint32_t));
+    	os_memcpy(dataOffset, (data + BFOFFBITS), BFOFFBITS_LENGTH);
     }
     return 0;
 }
 
 /**
  * @brief 绘制存储在代码中的图片(压缩格式), 图片宽度1字节(8像素)对齐，高度不得超过屏幕高度
+ * 每解码8行转置为列字节，整字节写入显存
  * @param *data 压缩后的图片数据
  * @param xStart 图片左边起始位置
  * @param yStart 图片上边起始位置
  * */
 void ICACHE_FLASH_ATTR GuiDrawImagePacked(const uint8_t *data, uint16_t xStart, uint16_t yStart) {
-	uint16_t header, width, fileWidth, height;
-	uint32_t fileSize, cursor, i, toWrite;
-	uint16_t drawX, drawY;
-	uint8_t byteValue, bitValue, count;
-	// 行缓存, 字节对齐 250 / 8 + 1
-	uint8_t lineBuffer[32];
-	uint32_t lineCursor, lineOffset;
+	uint16_t header, width, fileWidth, height, count16;
+	uint32_t fileSize, cursor, count, toWrite;
+	uint16_t drawY;
+	uint8_t byteValue, rows;
+	// 8行缓存, 字节对齐 250 / 8 + 1
+	uint8_t lineBuffer[BITS_OF_BYTE][32];
+	uint32_t lineCursor;
 
 	os_memcpy(&header, data, PACKED_HEADER_LENGTH);
 	if(header != BITMAP_PACKED) {
@@ -682,69 +996,656 @@ void ICACHE_FLASH_ATTR GuiDrawImagePacked(const uint8_t *data, uint16_t xStart,
 	os_memcpy(&height, (data + PACKED_HEIGHT_OFFSET), PACKED_HEIGHT_LENGTH);
 
     // 图片大小不可超出屏幕尺寸
-    if((xStart + width > SCREEN_WIDTH) || (yStart + height) > SCREEN_HEIGHT) {
+    if((xStart + width > SCREEN_WIDTH) || (yStart + height) > SCREEN_HEIGHT || width == 0) {
 		return;
     }
+    if(!GuiIsVisible(xStart, yStart, (xStart + width - 1), (yStart + height - 1))) {
+    	return;
+    }
 
     // 存储结构为字节对齐，8像素对齐
-    fileWidth = (width / BITS_OF_BYTE);
-    fileWidth = (fileWidth * BITS_OF_BYTE < width) ? (fileWidth + 1) : fileWidth;
+    fileWidth = ((width + BITS_OF_BYTE - 1) / BITS_OF_BYTE);
 
-	fileSize -= PACKED_DATA_OFFSET;
+    // fileSize为包含文件头的总长度
 	cursor = PACKED_DATA_OFFSET;
 	drawY = yStart;
+	rows = 0;
 	lineCursor = 0;
 
-	while(cursor < fileSize) {
+	while((cursor < fileSize) && (drawY < (yStart + height))) {
 		byteValue = *(data + cursor);
 
 		if((byteValue == 0x00) || (byteValue == 0xFF)) {
+			// 文件末尾的填充字节
+			if((cursor + 1) >= fileSize) {
+				break;
+			}
 			// read compressed data length
 			count = *(data + cursor + 1);
 			if(count == 0x00) {
 				// more than 255 bytes
-				os_memcpy(&count, (data + cursor + 2), sizeof(uint16_t));
+				if((cursor + 3) >= fileSize) {
+					break;
+				}
+				os_memcpy(&count16, (data + cursor + 2), sizeof(uint16_t));
+				count = count16;
 				cursor += 4;
 			}else {
 				// less than 255 bytes
 				cursor += 2;
 			}
-
-			do{
-				toWrite = (count > (fileWidth - lineCursor)) ? (fileWidth - lineCursor) : (count);
-				os_memset((lineBuffer + lineCursor), byteValue, toWrite);
-				lineCursor += toWrite;
-				count -= toWrite;
-				// 行缓存满
-				if(lineCursor >= fileWidth) {
-					drawX = xStart;
-					// 只绘制图片实际宽度的内容
-					for(i = 0; i < width; i++) {
-						lineCursor = (i >> 3);
-						lineOffset = (i - (lineCursor << 3));
-						bitValue = (lineBuffer[lineCursor] >> lineOffset & 0x1);
-						EPDDrawHorizontal(drawX++, drawY, bitValue);
-					}
-					drawY++;
-					lineCursor = 0;
-				}
-			}while(count > 0);
-
 		}else {
 			// 未压缩的部分直接放入行缓存
+			count = 1;
 			cursor++;
-			lineBuffer[lineCursor++] = byteValue;
+		}
+
+		while((count > 0) && (drawY < (yStart + height))) {
+			toWrite = (count > (fileWidth - lineCursor)) ? (fileWidth - lineCursor) : (count);
+			os_memset((lineBuffer[rows] + lineCursor), byteValue, toWrite);
+			lineCursor += toWrite;
+			count -= toWrite;
+			// 行缓存满
 			if(lineCursor >= fileWidth) {
-				drawX = xStart;
-				for(i = 0; i < width; i++) {
-					lineCursor = (i >> 3);
-					lineOffset = (i - (lineCursor << 3));
-					bitValue = (lineBuffer[lineCursor] >> lineOffset & 0x1);
-					EPDDrawHorizontal(drawX++, drawY, bitValue);
-				}
-				drawY++;
 				lineCursor = 0;
+				rows++;
+				// 凑满8行或到达图片底部时写入显存
+				if((rows == BITS_OF_BYTE) || ((drawY + rows) >= (yStart + height))) {
+					GuiBlitPackedLines(lineBuffer, rows, xStart, drawY, width);
+					drawY += rows;
+					rows = 0;
+				}
+			}
+		}
+	}
+	// 数据提前结束时只绘制完整的行
+	if(rows > 0) {
+		GuiBlitPackedLines(lineBuffer, rows, xStart, drawY, width);
+	}
+}
+
+/**
+ * @brief 压缩图片的最多8行转置为列字节写入显存
+ * @param lines 行数据，行内低位在左
+ * @param rows 有效行数
+ * @param xStart 图片左边起始位置
+ * @param y 首行位置
+ * @param width 图片宽度
+ * */
+static void ICACHE_FLASH_ATTR GuiBlitPackedLines(uint8_t lines[][32], uint8_t rows, uint16_t xStart, uint16_t y, uint16_t width) {
+	uint8_t block[BITS_OF_BYTE], columns[BITS_OF_BYTE];
+	uint32_t i, j, x;
+
+	for(i = 0; (i << 3) < width; i++) {
+		for(j = 0; j < BITS_OF_BYTE; j++) {
+			block[j] = (j < rows) ? lines[j][i] : 0x00;
+		}
+		GuiTranspose8(block, columns);
+		// 转置按高位在左，压缩图片低位在左，columns[7]为该字节最左侧像素
+		for(j = 0; j < BITS_OF_BYTE; j++) {
+			x = ((i << 3) + j);
+			if(x >= width) {
+				break;
 			}
+			GuiBlitColumn((xStart + x), y, ((uint32_t)columns[7 - j] << 24), rows, WHITE, BLACK);
 		}
 	}
 }
+
+/**
+ * @brief 判断区域是否与裁剪区域相交
+ * */
+static BOOL ICACHE_FLASH_ATTR GuiIsVisible(int16_t left, int16_t top, int16_t right, int16_t bottom) {
+	// 嵌套后为空的裁剪区域不可见
+	if((clipRect.left > clipRect.right) || (clipRect.top > clipRect.bottom)) {
+		return FALSE;
+	}
+	return !((right < clipRect.left) || (left > clipRect.right) || (bottom < clipRect.top) || (top > clipRect.bottom));
+}
+
+/**
+ * @brief 判断区域是否完全位于裁剪区域内，是则绘制时无需逐点检查
+ * */
+static BOOL ICACHE_FLASH_ATTR GuiIsInside(int16_t left, int16_t top, int16_t right, int16_t bottom) {
+	return ((left >= clipRect.left) && (right <= clipRect.right) && (top >= clipRect.top) && (bottom <= clipRect.bottom));
+}
+
+/**
+ * @brief 绘制单个像素
+ * @param inside 所属图元已完全位于裁剪区域内
+ * */
+static void ICACHE_FLASH_ATTR GuiPutPixel(int16_t x, int16_t y, uint8_t color, BOOL inside) {
+	if(!inside && ((x < clipRect.left) || (x > clipRect.right) || (y < clipRect.top) || (y > clipRect.bottom))) {
+		return;
+	}
+	EPDDrawHorizontal(x, y, color);
+}
+
+/**
+ * @brief 按裁剪区域截取列数据后写入显存，参数同EPDBlitColumn
+ * */
+static void ICACHE_FLASH_ATTR GuiBlitColumn(int16_t x, int16_t y, uint32_t bits, uint8_t height, uint8_t foreground, uint8_t background) {
+	int16_t skip;
+
+	if((x < clipRect.left) || (x > clipRect.right) || (height == 0)) {
+		return;
+	}
+	// 底部超出裁剪区域的行直接截掉
+	if((y + height - 1) > clipRect.bottom) {
+		if(y > clipRect.bottom) {
+			return;
+		}
+		height = (clipRect.bottom - y + 1);
+	}
+	// 顶部超出的行从列数据高位移出
+	if(y < clipRect.top) {
+		skip = (clipRect.top - y);
+		if(skip >= height) {
+			return;
+		}
+		bits <<= skip;
+		height -= skip;
+		y = clipRect.top;
+	}
+	EPDBlitColumn(x, y, bits, height, foreground, background);
+}
+
+/**
+ * @brief 设置绘制裁剪区域，同时清空GuiPushClipRect压入的裁剪区域
+ * @param *rect 裁剪区域(屏幕坐标)，NULL恢复为全屏
+ * */
+void ICACHE_FLASH_ATTR GuiSetClipRect(const Rect *rect) {
+	clipDepth = 0;
+	if(rect == NULL) {
+		clipRect.left = 0;
+		clipRect.top = 0;
+		clipRect.right = (SCREEN_WIDTH - 1);
+		clipRect.bottom = (SCREEN_HEIGHT - 1);
+	}else {
+		os_memcpy(&clipRect, rect, sizeof(Rect));
+	}
+}
+
+/**
+ * @brief 压入裁剪区域，新的裁剪区域为当前区域与rect的交集
+ * @param *rect 裁剪区域(屏幕坐标)
+ * @return TRUE:已压入，绘制完成后需调用GuiPopClipRect
+ *         FALSE:交集为空或栈已满，未压入，不需要绘制也不需要弹出
+ * */
+BOOL ICACHE_FLASH_ATTR GuiPushClipRect(const Rect *rect) {
+	Rect clip;
+
+	clip.left = (rect->left > clipRect.left) ? rect->left : clipRect.left;
+	clip.top = (rect->top > clipRect.top) ? rect->top : clipRect.top;
+	clip.right = (rect->right < clipRect.right) ? rect->right : clipRect.right;
+	clip.bottom = (rect->bottom < clipRect.bottom) ? rect->bottom : clipRect.bottom;
+	if((clip.left > clip.right) || (clip.top > clip.bottom) || (clipDepth >= GUI_CLIP_STACK_DEPTH)) {
+		return FALSE;
+	}
+	os_memcpy(&clipStack[clipDepth++], &clipRect, sizeof(Rect));
+	os_memcpy(&clipRect, &clip, sizeof(Rect));
+	return TRUE;
+}
+
+/**
+ * @brief 弹出裁剪区域，恢复上一次GuiPushClipRect之前的区域
+ * */
+void ICACHE_FLASH_ATTR GuiPopClipRect() {
+	if(clipDepth > 0) {
+		os_memcpy(&clipRect, &clipStack[--clipDepth], sizeof(Rect));
+	}
+}
+
+/**
+ * @brief 获取当前裁剪区域
+ * @param *rect 裁剪区域(屏幕坐标)
+ * */
+void ICACHE_FLASH_ATTR GuiGetClipRect(Rect *rect) {
+	os_memcpy(rect, &clipRect, sizeof(Rect));
+}
+
+/**
+ * @brief FNV-1a哈希累加
+ * */
+static uint32_t ICACHE_FLASH_ATTR GuiHashUpdate(uint32_t hash, const uint8_t *data, uint32_t length) {
+	uint32_t i;
+	for(i = 0; i < length; i++) {
+		hash = (hash ^ *(data + i)) * 16777619UL;
+	}
+	return hash;
+}
+
+#ifdef GUI_PROFILE_DRAW
+/**
+ * @brief 输出本次绘制的图元耗时统计并清零
+ * */
+static void ICACHE_FLASH_ATTR GuiReportDrawProfile() {
+	FontCacheStats stats;
+	FontCacheGetStats(&stats);
+	os_printf("gui fill %d calls, %d px, %d cycles\n", fillCalls, fillPixels, fillCycles);
+	os_printf("gui char %d glyphs, %d cycles, cache %d hits %d misses\n", charCalls, charCycles,
+			(stats.hits - lastCacheStats.hits), (stats.misses - lastCacheStats.misses));
+	fillCalls = 0;
+	fillPixels = 0;
+	fillCycles = 0;
+	charCalls = 0;
+	charCycles = 0;
+	os_memcpy(&lastCacheStats, &stats, sizeof(FontCacheStats));
+}
+#endif
+
+#ifndef EPD_BANDED_RENDER
+/**
+ * @brief 在整帧显存中立即绘制视图
+ * */
+static void ICACHE_FLASH_ATTR GuiRenderFrame(GuiRenderCallback render, uint32_t arg) {
+	frameRetained = (render == lastRender && arg == lastArg);
+	lastRender = render;
+	lastArg = arg;
+	// 默认绘制回调可能修改整帧，只有通过GuiInvalidateRect声明的变化范围可以缩小比较区域
+	renderDirty = frameRetained ? frameDirty : GUI_DIRTY_UNKNOWN;
+	frameDirty = GUI_DIRTY_UNKNOWN;
+	FontCacheNewFrame();
+	render(arg);
+#ifdef GUI_PROFILE_DRAW
+	GuiReportDrawProfile();
+#endif
+}
+#endif
+
+/**
+ * @brief 绘制视图
+ * @note 整帧显存模式下立即绘制，分带渲染模式下保存回调，在送显时由GuiRenderBands逐带绘制
+ *       EPD更新仍在使用显存(EPDIsUpdating)时只保存最后一次绘制，由GuiRenderDeferred在刷新完成后执行
+ * @param render 绘制回调
+ * @param arg 回调参数
+ * */
+void ICACHE_FLASH_ATTR GuiRender(GuiRenderCallback render, uint32_t arg) {
+#ifdef EPD_BANDED_RENDER
+	pendingRender = render;
+	pendingArg = arg;
+#else
+	if(EPDIsUpdating()) {
+		deferredRender = render;
+		deferredArg = arg;
+		return;
+	}
+	// 新的绘制取代尚未执行的推迟绘制
+	deferredRender = NULL;
+	GuiRenderFrame(render, arg);
+#endif
+}
+
+/**
+ * @brief 执行EPD更新期间推迟的绘制，在刷新完成(MAIN_EVENT_EPD_FINISH)后调用
+ * @return 是否执行了推迟的绘制，为TRUE时需要重新送显
+ * */
+BOOL ICACHE_FLASH_ATTR GuiRenderDeferred() {
+#ifdef EPD_BANDED_RENDER
+	return FALSE;
+#else
+	GuiRenderCallback render = deferredRender;
+	if(render == NULL) {
+		return FALSE;
+	}
+	deferredRender = NULL;
+	GuiRenderFrame(render, deferredArg);
+	return TRUE;
+#endif
+}
+
+/**
+ * @brief 当前绘制的视图与上一次GuiRender相同，且显存中保留着上一次的绘制结果
+ * @note 分带渲染没有整帧显存，总是返回FALSE
+ * */
+BOOL ICACHE_FLASH_ATTR GuiIsFrameRetained() {
+#ifdef EPD_BANDED_RENDER
+	return FALSE;
+#else
+	return frameRetained;
+#endif
+}
+
+/**
+ * @brief 声明本次绘制只修改了rect区域，可多次调用累加，仅在GuiIsFrameRetained时有效
+ * @param *rect 修改的区域(屏幕坐标)，NULL表示没有修改
+ * */
+void ICACHE_FLASH_ATTR GuiInvalidateRect(const Rect *rect) {
+#ifndef EPD_BANDED_RENDER
+	if(!frameRetained || renderDirty == GUI_DIRTY_UNKNOWN) {
+		return;
+	}
+	if(rect != NULL) {
+		if(renderDirty == GUI_DIRTY_NONE) {
+			os_memcpy(&dirtyHint, rect, sizeof(Rect));
+		}else {
+			if(rect->left < dirtyHint.left) dirtyHint.left = rect->left;
+			if(rect->top < dirtyHint.top) dirtyHint.top = rect->top;
+			if(rect->right > dirtyHint.right) dirtyHint.right = rect->right;
+			if(rect->bottom > dirtyHint.bottom) dirtyHint.bottom = rect->bottom;
+		}
+		renderDirty = GUI_DIRTY_RECT;
+	}
+	frameDirty = renderDirty;
+#endif
+}
+
+/**
+ * @brief 显存内容被绘制流程以外的因素改变(如图片文件更新)，下一次绘制不再沿用上一帧
+ * */
+void ICACHE_FLASH_ATTR GuiInvalidateFrame() {
+#ifndef EPD_BANDED_RENDER
+	lastRender = NULL;
+	lastArg = 0;
+	// 静态图层可能包含已更换的图片
+	GuiDropLayers();
+#endif
+}
+
+#ifdef EPD_BANDED_RENDER
+
+/**
+ * @brief 逐带绘制GuiRender保存的视图，并写入控制器RAM
+ * @note 调用前需要完成EPDReset/EPDInit
+ * @return hash 整帧哈希，与GuiGetFrameHash一致
+ * */
+uint32_t ICACHE_FLASH_ATTR GuiRenderBands() {
+	uint32_t hash = 2166136261UL;
+	uint16_t xStart, xEnd;
+	uint8_t band;
+	Rect band_rect;
+
+	// 各条带绘制同一帧，字模缓存按一帧计算
+	FontCacheNewFrame();
+	for(band = 0; band < EPD_BAND_COUNT; band++) {
+		EPDBandBegin(band);
+		EPDGetBandRect(&xStart, &xEnd);
+		band_rect.left = xStart;
+		band_rect.top = 0;
+		band_rect.right = xEnd;
+		band_rect.bottom = (SCREEN_HEIGHT - 1);
+		GuiSetClipRect(&band_rect);
+		if(pendingRender != NULL) {
+			pendingRender(pendingArg);
+		}
+		// 条带按RAM行顺序依次写入，哈希与整帧计算结果相同
+		hash = GuiHashUpdate(hash, EPDGetDisplayRAM(), (EPD_RAM_WIDTH * (xEnd - xStart + 1)));
+		EPDBandFlush();
+	}
+	GuiSetClipRect(NULL);
+#ifdef GUI_PROFILE_DRAW
+	GuiReportDrawProfile();
+#endif
+	return (hash == 0) ? 1 : hash;
+}
+
+#else
+
+/**
+ * @brief 与上一次送显的帧比较，计算变化区域
+ * @note 按RAM行(水平x)和RAM列字节(垂直y)分别计算签名，变化区域按字节对齐
+ *       调用后签名即更新为当前帧，应在每次送显前调用一次
+ * @param *rect 变化区域(屏幕坐标)
+ * @return TRUE:有变化, FALSE:与上一帧相同
+ * */
+BOOL ICACHE_FLASH_ATTR GuiGetDirtyRegion(Rect *rect) {
+	uint8_t *ram = EPDGetDisplayRAM();
+	uint32_t colHash[EPD_RAM_WIDTH];
+	uint32_t rowHash;
+	int16_t rowMin = EPD_HEIGHT, rowMax = -1;
+	int16_t colMin = EPD_RAM_WIDTH, colMax = -1;
+	int16_t rowStart, rowEnd;
+	uint32_t i, j;
+	uint8_t value;
+
+	if(ram == NULL) {
+		return FALSE;
+	}
+	if(signatureValid && frameDirty == GUI_DIRTY_NONE) {
+		return FALSE;
+	}
+	// 变化范围已知时只比较其覆盖的RAM行，垂直方向取声明的范围
+	if(signatureValid && frameDirty == GUI_DIRTY_RECT) {
+		frameDirty = GUI_DIRTY_NONE;
+		rowStart = (EPD_HEIGHT - 1) - dirtyHint.right;
+		rowEnd = (EPD_HEIGHT - 1) - dirtyHint.left;
+		rowStart = (rowStart < 0) ? 0 : rowStart;
+		rowEnd = (rowEnd > (EPD_HEIGHT - 1)) ? (EPD_HEIGHT - 1) : rowEnd;
+		for(j = rowStart; (int16_t)j <= rowEnd; j++) {
+			rowHash = GuiHashUpdate(2166136261UL, (ram + j * EPD_RAM_WIDTH), EPD_RAM_WIDTH);
+			rowHash = (rowHash >> 16) ^ (rowHash & 0xFFFF);
+			if(rowSignature[j] != (uint16_t)rowHash) {
+				if(rowMin > j) rowMin = j;
+				rowMax = j;
+			}
+			rowSignature[j] = (uint16_t)rowHash;
+		}
+		colSignatureValid = FALSE;
+		if(rowMax < 0) {
+			return FALSE;
+		}
+		rect->left = (EPD_HEIGHT - 1) - rowMax;
+		rect->right = (EPD_HEIGHT - 1) - rowMin;
+		rect->top = ((dirtyHint.top < 0) ? 0 : (dirtyHint.top & ~0x7));
+		rect->bottom = ((dirtyHint.bottom | 0x7) >= SCREEN_HEIGHT) ? (SCREEN_HEIGHT - 1) : (dirtyHint.bottom | 0x7);
+		return TRUE;
+	}
+	frameDirty = GUI_DIRTY_NONE;
+
+	for(i = 0; i < EPD_RAM_WIDTH; i++) {
+		colHash[i] = 2166136261UL;
+	}
+	// FNV-1a
+	for(j = 0; j < EPD_HEIGHT; j++) {
+		rowHash = 2166136261UL;
+		for(i = 0; i < EPD_RAM_WIDTH; i++) {
+			value = *(ram + j * EPD_RAM_WIDTH + i);
+			rowHash = (rowHash ^ value) * 16777619UL;
+			colHash[i] = (colHash[i] ^ value) * 16777619UL;
+		}
+		rowHash = (rowHash >> 16) ^ (rowHash & 0xFFFF);
+		if(!signatureValid || rowSignature[j] != (uint16_t)rowHash) {
+			if(rowMin > j) rowMin = j;
+			rowMax = j;
+		}
+		rowSignature[j] = (uint16_t)rowHash;
+	}
+	for(i = 0; i < EPD_RAM_WIDTH; i++) {
+		if(!signatureValid || !colSignatureValid || colSignature[i] != colHash[i]) {
+			if(colMin > i) colMin = i;
+			colMax = i;
+		}
+		colSignature[i] = colHash[i];
+	}
+	signatureValid = TRUE;
+	colSignatureValid = TRUE;
+
+	if(rowMax < 0 || colMax < 0) {
+		return FALSE;
+	}
+	// RAM行与水平坐标逆序
+	rect->left = (EPD_HEIGHT - 1) - rowMax;
+	rect->right = (EPD_HEIGHT - 1) - rowMin;
+	rect->top = (colMin << 3);
+	rect->bottom = ((colMax << 3) + 7);
+	if(rect->bottom >= SCREEN_HEIGHT) {
+		rect->bottom = SCREEN_HEIGHT - 1;
+	}
+	return TRUE;
+}
+
+/**
+ * @brief 计算当前帧的32位哈希(FNV-1a)，用于判断帧内容是否与屏幕上一致
+ * @return hash 非0哈希值, 0保留为无效值
+ * */
+uint32_t ICACHE_FLASH_ATTR GuiGetFrameHash() {
+	uint8_t *ram = EPDGetDisplayRAM();
+	uint32_t hash = 2166136261UL;
+
+	if(ram == NULL) {
+		return 0;
+	}
+	hash = GuiHashUpdate(hash, ram, (EPD_RAM_WIDTH * EPD_HEIGHT));
+	return (hash == 0) ? 1 : hash;
+}
+
+/**
+ * @brief 将当前显存保存为图层，之后可用GuiRestoreLayer恢复
+ * @note 压缩后放入RAM，剩余空闲堆不足GUI_LAYER_HEAP_RESERVE时放弃保存，不写入flash
+ * @param slot 缓存槽 0 ~ (GUI_LAYER_SLOTS - 1)
+ * @param signature 图层内容签名，与已保存的相同时不重复保存
+ * @return TRUE:保存成功
+ * */
+BOOL ICACHE_FLASH_ATTR GuiSaveLayer(uint8_t slot, uint32_t signature) {
+	uint8_t *ram = EPDGetDisplayRAM();
+	const uint32_t size = (EPD_HEIGHT * EPD_RAM_WIDTH);
+	uint32_t position = 0, length = 0;
+	uint8_t chunk[128];
+	GuiLayer *layer;
+
+	if(ram == NULL || slot >= GUI_LAYER_SLOTS) {
+		return FALSE;
+	}
+	layer = &layers[slot];
+	if(layer->state != GUI_LAYER_EMPTY && layer->signature == signature) {
+		return TRUE;
+	}
+	if(layer->data != NULL) {
+		os_free(layer->data);
+		layer->data = NULL;
+	}
+	layer->state = GUI_LAYER_EMPTY;
+
+	// 先计算压缩后长度
+	while(position < size) {
+		length += GuiPackLayer(ram, size, &position, chunk, sizeof(chunk));
+	}
+	if(length > 0xFFFF) {
+		return FALSE;
+	}
+	// 空闲堆不足时不缓存，下次整帧绘制时重新绘制
+	if(system_get_free_heap_size() < (length + GUI_LAYER_HEAP_RESERVE)) {
+		return FALSE;
+	}
+	layer->data = (uint8_t *)os_malloc(length + 4);
+	if(layer->data == NULL) {
+		return FALSE;
+	}
+	position = 0;
+	GuiPackLayer(ram, size, &position, layer->data, (length + 4));
+	layer->state = GUI_LAYER_RAM;
+	layer->signature = signature;
+	layer->length = (uint16_t)length;
+	return TRUE;
+}
+
+/**
+ * @brief 签名一致时将图层恢复到显存
+ * @param slot 缓存槽 0 ~ (GUI_LAYER_SLOTS - 1)
+ * @param signature 图层内容签名
+ * @return TRUE:已恢复，FALSE:没有缓存或已过期，显存内容不确定
+ * */
+BOOL ICACHE_FLASH_ATTR GuiRestoreLayer(uint8_t slot, uint32_t signature) {
+	uint8_t *ram = EPDGetDisplayRAM();
+	const uint32_t size = (EPD_HEIGHT * EPD_RAM_WIDTH);
+	GuiLayer *layer;
+
+	if(ram == NULL || slot >= GUI_LAYER_SLOTS) {
+		return FALSE;
+	}
+	layer = &layers[slot];
+	if(layer->state == GUI_LAYER_EMPTY || layer->signature != signature) {
+		return FALSE;
+	}
+	if(GuiUnpackLayer(layer->data, layer->length, ram, size)) {
+		return TRUE;
+	}
+	os_free(layer->data);
+	layer->data = NULL;
+	layer->state = GUI_LAYER_EMPTY;
+	return FALSE;
+}
+
+/**
+ * @brief 压缩显存，0x00/0xFF连续段写为值+1字节长度，超过255时长度为0再跟2字节长度
+ * @param *position 输入/输出，已压缩的字节数，输出缓冲区满时返回，可继续调用
+ * @param capacity 输出缓冲区大小，至少4字节
+ * @return 本次输出的字节数
+ * */
+static uint32_t ICACHE_FLASH_ATTR GuiPackLayer(const uint8_t *src, uint32_t length, uint32_t *position, uint8_t *out, uint32_t capacity) {
+	uint32_t cursor = 0, run;
+	uint8_t value;
+
+	while((*position < length) && ((cursor + 4) <= capacity)) {
+		value = *(src + *position);
+		if(value != 0x00 && value != 0xFF) {
+			out[cursor++] = value;
+			(*position)++;
+			continue;
+		}
+		run = 1;
+		while(((*position + run) < length) && (*(src + *position + run) == value) && (run < 0xFFFF)) {
+			run++;
+		}
+		out[cursor++] = value;
+		if(run <= 0xFF) {
+			out[cursor++] = (uint8_t)run;
+		}else {
+			out[cursor++] = 0;
+			out[cursor++] = (uint8_t)(run & 0xFF);
+			out[cursor++] = (uint8_t)(run >> 8);
+		}
+		*position += run;
+	}
+	return cursor;
+}
+
+/**
+ * @brief 解压GuiPackLayer的数据
+ * @return TRUE:数据完整且正好填满size字节
+ * */
+static BOOL ICACHE_FLASH_ATTR GuiUnpackLayer(const uint8_t *data, uint32_t length, uint8_t *out, uint32_t size) {
+	uint32_t i = 0, cursor = 0, count;
+	uint8_t value;
+
+	while(cursor < size && i < length) {
+		value = data[i++];
+		if(value != 0x00 && value != 0xFF) {
+			out[cursor++] = value;
+			continue;
+		}
+		if(i >= length) {
+			return FALSE;
+		}
+		count = data[i++];
+		if(count == 0) {
+			if((i + 2) > length) {
+				return FALSE;
+			}
+			count = data[i] | ((uint32_t)data[i + 1] << 8);
+			i += 2;
+		}
+		if(count > (size - cursor)) {
+			return FALSE;
+		}
+		os_memset((out + cursor), value, count);
+		cursor += count;
+	}
+	return (cursor == size);
+}
+
+/**
+ * @brief 丢弃全部图层缓存
+ * */
+static void ICACHE_FLASH_ATTR GuiDropLayers() {
+	uint8_t i;
+	for(i = 0; i < GUI_LAYER_SLOTS; i++) {
+		if(layers[i].data != NULL) {
+			os_free(layers[i].data);
+			layers[i].data = NULL;
+		}
+		layers[i].state = GUI_LAYER_EMPTY;
+	}
+}
+
+#endif
@@ -7,7 +7,49 @@
 
 #include "graphics/font.h"
 
-static Font fonts[5];
+static Font fonts[7];
+
+#define FONT_COUNT    (sizeof(fonts) / sizeof(Font))
+
+// 文件字体常驻句柄
+static File fontFiles[FONT_COUNT];
+// 字体文件不存在标记，bit[n]对应fonts[n]，避免每次绘制重复扫描文件索引
+static uint32_t fontFileMissing = 0;
+// bin字库的偏移计算回调，pwf字体失效后回退时恢复
+static uint32_t (*rowCalcOffset[FONT_COUNT])(Font *font, wchar charCode);
+// pwf字体的编码区表
+static PwfBlock pwfBlocks[FONT_COUNT][PWF_BLOCKS_MAX];
+static uint8_t pwfBlockCount[FONT_COUNT];
+// Unicode子集字库的页索引和编码低字节表，打开字库时分配
+static uint16_t *unicodePages[FONT_COUNT];
+static uint8_t *unicodeLows[FONT_COUNT];
+
+/**
+ * 字模缓存槽，stamp为最近一次访问的时间戳，0表示空槽，frame为最近一次访问的帧序号
+ */
+typedef struct _font_cache_slot {
+	uint32_t stamp;
+	wchar code;
+	uint8_t font;
+	uint8_t frame;
+} FontCacheSlot;
+
+static FontCacheSlot cacheSlots[FONT_CACHE_SLOTS];
+static uint8_t cacheData[FONT_CACHE_SLOTS][FONT_CACHE_SLOT_SIZE];
+// 访问时钟，每次命中/插入递增
+static uint32_t cacheClock = 0;
+// 绘制帧序号，FontCacheNewFrame递增
+static uint8_t cacheFrame = 0;
+static uint32_t cacheHits = 0;
+static uint32_t cacheMisses = 0;
+
+static BOOL ICACHE_FLASH_ATTR fontOpenPWF(uint32_t index);
+static BOOL ICACHE_FLASH_ATTR fontOpenUnicode(uint32_t index, PwfHeader *header);
+static void ICACHE_FLASH_ATTR fontReleasePWF(uint32_t index);
+static int32_t ICACHE_FLASH_ATTR fontUnicodeIndex(uint32_t index, wchar code);
+static uint32_t ICACHE_FLASH_ATTR calcOffsetPWF(Font *font, wchar charCode);
+static BOOL ICACHE_FLASH_ATTR fontCacheable(Font *font);
+static void ICACHE_FLASH_ATTR fontCachePurge(uint8_t index);
 
 static uint32_t ICACHE_FLASH_ATTR calcOffset12CN(Font *font, wchar charCode);
 static uint32_t ICACHE_FLASH_ATTR calcOffset16CN(Font *font, wchar charCode);
@@ -18,7 +60,12 @@ static uint32_t ICACHE_FLASH_ATTR calcOffset12EN(Font *font, wchar charCode);
 static uint32_t ICACHE_FLASH_ATTR endianSwapEN(uint32_t bitmapline);
 
 void ICACHE_FLASH_ATTR loadFont(void) {
+	uint32_t i;
+	for(i = 0; i < FONT_COUNT; i++) {
+		fontReleasePWF(i);
+	}
 	os_memset(fonts, 0x00, sizeof(fonts));
+	FontCacheClear();
 
 	fonts[0].data = NULL;
 	fonts[0].user_data = NULL;
@@ -91,6 +138,42 @@ void ICACHE_FLASH_ATTR loadFont(void) {
 	fonts[4].fontBytes = 16;
 	os_strcpy((char *)(fonts[4].filename), "GB64SP");
 	os_strcpy((char *)(fonts[4].extname), "bin");
+
+	// Unicode子集字库没有bin格式，calcOffset在打开pwf文件时设置
+	fonts[5].data = NULL;
+	fonts[5].user_data = NULL;
+	fonts[5].baseAddr = 0;
+	fonts[5].calcOffset = NULL;
+	fonts[5].endianSwap = endianSwapEN;
+	fonts[5].startChar = 0x0000;
+	fonts[5].endChar = 0xFFFF;
+	fonts[5].width = 12;
+	fonts[5].height = 12;
+	fonts[5].lineBytes = 2;
+	fonts[5].fontBytes = 24;
+	os_strcpy((char *)(fonts[5].filename), "UNI12");
+	os_strcpy((char *)(fonts[5].extname), PWF_EXTNAME);
+
+	fonts[6].data = NULL;
+	fonts[6].user_data = NULL;
+	fonts[6].baseAddr = 0;
+	fonts[6].calcOffset = NULL;
+	fonts[6].endianSwap = endianSwapEN;
+	fonts[6].startChar = 0x0000;
+	fonts[6].endChar = 0xFFFF;
+	fonts[6].width = 16;
+	fonts[6].height = 16;
+	fonts[6].lineBytes = 2;
+	fonts[6].fontBytes = 32;
+	os_strcpy((char *)(fonts[6].filename), "UNI16");
+	os_strcpy((char *)(fonts[6].extname), PWF_EXTNAME);
+
+	// 预先解析全部字体文件句柄
+	fontFileMissing = 0;
+	for(i = 0; i < FONT_COUNT; i++) {
+		rowCalcOffset[i] = fonts[i].calcOffset;
+		FontGetFile(fonts + i);
+	}
 }
 
 
@@ -99,6 +182,358 @@ Font * ICACHE_FLASH_ATTR getFont(FontType tp) {
 	return (fonts + cursor);
 }
 
+/**
+ * @brief 获取字体文件句柄，首次调用时打开文件并常驻
+ * @param *font 字体
+ * @return 文件句柄, NULL:字体文件不存在
+ * */
+File * ICACHE_FLASH_ATTR FontGetFile(Font *font) {
+	uint32_t index;
+	if(font->user_data != NULL) {
+		return (File *)font->user_data;
+	}
+	if(font < fonts || font >= (fonts + FONT_COUNT)) {
+		return NULL;
+	}
+	index = (uint32_t)(font - fonts);
+	if(fontFileMissing & (1 << index)) {
+		return NULL;
+	}
+	// 优先使用同名的pwf字体，否则回退到bin字库
+	if(!fontOpenPWF(index)) {
+		font->layout = FONT_LAYOUT_ROW;
+		font->baseAddr = 0;
+		font->calcOffset = rowCalcOffset[index];
+		font->lineBytes = ((font->width + 7) >> 3);
+		font->fontBytes = (font->lineBytes * font->height);
+		if(rowCalcOffset[index] == NULL
+				|| !open_file((fontFiles + index), (char *)font->filename, (char *)font->extname)) {
+			fontFileMissing |= (1 << index);
+			return NULL;
+		}
+	}
+	font->user_data = (fontFiles + index);
+	return (fontFiles + index);
+}
+
+/**
+ * @brief 文件被重命名/删除/覆盖写后调用，失效同名字体的文件句柄和字模缓存
+ * @note 不区分拓展名，bin和pwf文件变更都需要重新选择字库
+ * @param *filename 原始格式文件名(空缺填充0xFF)，NULL时失效全部字体
+ * */
+void ICACHE_FLASH_ATTR FontInvalidateFile(uint8_t *filename) {
+	uint32_t i;
+	File temp;
+	for(i = 0; i < FONT_COUNT; i++) {
+		if(filename != NULL) {
+			make_file(&temp, (char *)fonts[i].filename, (char *)fonts[i].extname);
+			if(os_memcmp(temp.filename, filename, FILENAME_SIZE) != 0) {
+				continue;
+			}
+		}
+		fonts[i].user_data = NULL;
+		fontFileMissing &= ~(1 << i);
+		fontReleasePWF(i);
+		fontCachePurge((uint8_t)i);
+	}
+}
+
+/**
+ * @brief 打开pwf字体文件并加载编码区表，字体尺寸必须与bin字库一致
+ * @param index 字体在fonts表中的索引
+ * @return TRUE:使用pwf字体, FALSE:文件不存在或格式不匹配
+ * */
+static BOOL ICACHE_FLASH_ATTR fontOpenPWF(uint32_t index) {
+	Font *font = (fonts + index);
+	File *file = (fontFiles + index);
+	PwfHeader header;
+	uint32_t size;
+
+	fontReleasePWF(index);
+	if(!open_file(file, (char *)font->filename, PWF_EXTNAME)) {
+		return FALSE;
+	}
+	if(read_file(file, 0, (uint8_t *)&header, sizeof(PwfHeader)) != sizeof(PwfHeader)) {
+		return FALSE;
+	}
+	if(header.magic != PWF_MAGIC || header.version != PWF_VERSION
+			|| header.width != font->width || header.height != font->height
+			|| header.columnBytes != ((header.height + 7) >> 3) || header.columnBytes > sizeof(uint32_t)
+			|| header.glyphBytes != (header.width * header.columnBytes)) {
+		return FALSE;
+	}
+	if(header.encoding == PWF_ENCODING_UNICODE) {
+		return fontOpenUnicode(index, &header);
+	}
+	if(header.encoding != PWF_ENCODING_BLOCK || header.blockCount == 0 || header.blockCount > PWF_BLOCKS_MAX) {
+		return FALSE;
+	}
+	size = (header.blockCount * sizeof(PwfBlock));
+	if(read_file(file, sizeof(PwfHeader), (uint8_t *)pwfBlocks[index], size) != size) {
+		return FALSE;
+	}
+	pwfBlockCount[index] = header.blockCount;
+
+	font->layout = FONT_LAYOUT_COLUMN;
+	font->baseAddr = (sizeof(PwfHeader) + size);
+	font->calcOffset = calcOffsetPWF;
+	font->lineBytes = header.columnBytes;
+	font->fontBytes = (uint8_t)header.glyphBytes;
+	return TRUE;
+}
+
+/**
+ * @brief 加载Unicode子集字库的页索引和编码低字节表
+ * @param index 字体在fonts表中的索引
+ * @param *header 已校验尺寸的文件头
+ * @return TRUE:加载成功, FALSE:索引表无效或内存不足
+ * */
+static BOOL ICACHE_FLASH_ATTR fontOpenUnicode(uint32_t index, PwfHeader *header) {
+	Font *font = (fonts + index);
+	File *file = (fontFiles + index);
+	uint32_t size = ((PWF_UNICODE_PAGES + 1) * sizeof(uint16_t)), i;
+	uint16_t *pages;
+	uint8_t *lows;
+
+	if(header->blockCount != 0 || header->glyphCount == 0 || header->glyphCount > PWF_UNICODE_GLYPHS_MAX) {
+		return FALSE;
+	}
+	pages = (uint16_t *)os_malloc(size);
+	lows = (uint8_t *)os_malloc(header->glyphCount);
+	unicodePages[index] = pages;
+	unicodeLows[index] = lows;
+	if(pages == NULL || lows == NULL) {
+		fontReleasePWF(index);
+		return FALSE;
+	}
+	if(read_file(file, sizeof(PwfHeader), (uint8_t *)pages, size) != size
+			|| read_file(file, (sizeof(PwfHeader) + size), lows, header->glyphCount) != header->glyphCount
+			|| pages[PWF_UNICODE_PAGES] != header->glyphCount) {
+		fontReleasePWF(index);
+		return FALSE;
+	}
+	for(i = 0; i < PWF_UNICODE_PAGES; i++) {
+		if(pages[i] > pages[i + 1]) {
+			fontReleasePWF(index);
+			return FALSE;
+		}
+	}
+
+	font->layout = FONT_LAYOUT_COLUMN;
+	font->baseAddr = (sizeof(PwfHeader) + size + header->glyphCount);
+	font->calcOffset = calcOffsetPWF;
+	font->lineBytes = header->columnBytes;
+	font->fontBytes = (uint8_t)header->glyphBytes;
+	return TRUE;
+}
+
+/**
+ * @brief 释放Unicode子集字库的索引表
+ * */
+static void ICACHE_FLASH_ATTR fontReleasePWF(uint32_t index) {
+	if(unicodePages[index] != NULL) {
+		os_free(unicodePages[index]);
+		unicodePages[index] = NULL;
+	}
+	if(unicodeLows[index] != NULL) {
+		os_free(unicodeLows[index]);
+		unicodeLows[index] = NULL;
+	}
+}
+
+/**
+ * @brief 在Unicode子集字库中查找字符，页内二分查找
+ * @return 字模序号，-1:字库中不存在该字符
+ * */
+static int32_t ICACHE_FLASH_ATTR fontUnicodeIndex(uint32_t index, wchar code) {
+	uint8_t page = ((code >> 8) & 0xFF), low = (code & 0xFF);
+	int32_t start = unicodePages[index][page];
+	int32_t end = (int32_t)unicodePages[index][page + 1] - 1;
+	int32_t middle;
+
+	while(start <= end) {
+		middle = ((start + end) >> 1);
+		if(unicodeLows[index][middle] == low) {
+			return middle;
+		}else if(unicodeLows[index][middle] < low) {
+			start = (middle + 1);
+		}else {
+			end = (middle - 1);
+		}
+	}
+	return -1;
+}
+
+/**
+ * @brief 获取与指定字体尺寸相同且已加载的Unicode子集字库
+ * @param *font GB2312字体
+ * @return Unicode子集字库, NULL:不存在
+ * */
+Font * ICACHE_FLASH_ATTR FontGetUnicode(Font *font) {
+	uint32_t i;
+	for(i = FONT12x12_UNI; i <= FONT16x16_UNI; i++) {
+		if(fonts[i].width == font->width && fonts[i].height == font->height
+				&& FontGetFile(fonts + i) != NULL && unicodePages[i] != NULL) {
+			return (fonts + i);
+		}
+	}
+	return NULL;
+}
+
+/**
+ * @brief 查询字体是否包含字符
+ * @note 编码区字库范围内的字符均视为存在，Unicode子集字库按索引表查找
+ * */
+BOOL ICACHE_FLASH_ATTR FontHasGlyph(Font *font, wchar ch) {
+	uint32_t index = (uint32_t)(font - fonts);
+	if((ch < font->startChar) || (ch > font->endChar)) {
+		return FALSE;
+	}
+	if(font >= fonts && font < (fonts + FONT_COUNT) && unicodePages[index] != NULL) {
+		return (fontUnicodeIndex(index, ch) >= 0);
+	}
+	return TRUE;
+}
+
+/**
+ * @brief pwf字体按编码区计算字模偏移，不在任何编码区的字符返回第一个字模
+ * */
+static uint32_t ICACHE_FLASH_ATTR calcOffsetPWF(Font *font, wchar charCode) {
+	uint32_t index = (uint32_t)(font - fonts), i;
+	uint8_t low = (charCode & 0xFF), high = ((charCode >> 8) & 0xFF);
+	int32_t glyph;
+	PwfBlock *block;
+
+	if(unicodePages[index] != NULL) {
+		glyph = fontUnicodeIndex(index, charCode);
+		return (glyph < 0) ? 0 : (glyph * font->fontBytes);
+	}
+
+	for(i = 0; i < pwfBlockCount[index]; i++) {
+		block = &pwfBlocks[index][i];
+		if(low >= block->lowFirst && low <= block->lowLast && high >= block->highFirst && high <= block->highLast) {
+			return (block->base + (low - block->lowFirst) * (block->highLast - block->highFirst + 1)
+					+ (high - block->highFirst)) * font->fontBytes;
+		}
+	}
+	return 0;
+}
+
+/**
+ * @brief 从缓存中读取字模
+ * @param *font 字体
+ * @param ch 字符
+ * @param *buffer 字模数据输出缓冲区，至少font->fontBytes字节
+ * @return TRUE:命中, FALSE:未命中
+ * */
+BOOL ICACHE_FLASH_ATTR FontCacheLookup(Font *font, wchar ch, uint8_t *buffer) {
+	uint32_t i;
+	uint8_t index;
+	if(!fontCacheable(font)) {
+		return FALSE;
+	}
+	index = (uint8_t)(font - fonts);
+	for(i = 0; i < FONT_CACHE_SLOTS; i++) {
+		if(cacheSlots[i].stamp != 0 && cacheSlots[i].code == ch && cacheSlots[i].font == index) {
+			cacheSlots[i].stamp = ++cacheClock;
+			cacheSlots[i].frame = cacheFrame;
+			os_memcpy(buffer, cacheData[i], font->fontBytes);
+			cacheHits++;
+			return TRUE;
+		}
+	}
+	cacheMisses++;
+	return FALSE;
+}
+
+/**
+ * @brief 写入字模到缓存，缓存已满时替换最近FONT_CACHE_PIN_FRAMES帧内未使用的槽中最久未使用的一个，
+ *        没有可替换的槽时不缓存
+ * @param *font 字体
+ * @param ch 字符
+ * @param *buffer 从文件读取的字模数据
+ * */
+void ICACHE_FLASH_ATTR FontCacheInsert(Font *font, wchar ch, const uint8_t *buffer) {
+	uint32_t i, victim = FONT_CACHE_SLOTS;
+	if(!fontCacheable(font)) {
+		return;
+	}
+	for(i = 0; i < FONT_CACHE_SLOTS; i++) {
+		if(cacheSlots[i].stamp == 0) {
+			victim = i;
+			break;
+		}
+		if((uint8_t)(cacheFrame - cacheSlots[i].frame) < FONT_CACHE_PIN_FRAMES) {
+			continue;
+		}
+		if(victim == FONT_CACHE_SLOTS || cacheSlots[i].stamp < cacheSlots[victim].stamp) {
+			victim = i;
+		}
+	}
+	if(victim == FONT_CACHE_SLOTS) {
+		return;
+	}
+	cacheSlots[victim].stamp = ++cacheClock;
+	cacheSlots[victim].frame = cacheFrame;
+	cacheSlots[victim].code = ch;
+	cacheSlots[victim].font = (uint8_t)(font - fonts);
+	os_memcpy(cacheData[victim], buffer, font->fontBytes);
+}
+
+/**
+ * @brief 清空字模缓存，字体文件变更后调用
+ * */
+void ICACHE_FLASH_ATTR FontCacheClear(void) {
+	os_memset(cacheSlots, 0x00, sizeof(cacheSlots));
+	cacheClock = 0;
+}
+
+/**
+ * @brief 开始新的绘制帧，由GuiRender在每帧绘制前调用
+ * */
+void ICACHE_FLASH_ATTR FontCacheNewFrame(void) {
+	cacheFrame++;
+}
+
+/**
+ * @brief 获取字模缓存统计
+ * @param *stats 统计结果
+ * */
+void ICACHE_FLASH_ATTR FontCacheGetStats(FontCacheStats *stats) {
+	uint32_t i;
+	stats->hits = cacheHits;
+	stats->misses = cacheMisses;
+	stats->entries = 0;
+	for(i = 0; i < FONT_CACHE_SLOTS; i++) {
+		if(cacheSlots[i].stamp != 0) {
+			stats->entries++;
+		}
+	}
+}
+
+/**
+ * @brief 移除指定字体的全部缓存字模
+ * @param index 字体在fonts表中的索引
+ * */
+static void ICACHE_FLASH_ATTR fontCachePurge(uint8_t index) {
+	uint32_t i;
+	for(i = 0; i < FONT_CACHE_SLOTS; i++) {
+		if(cacheSlots[i].font == index) {
+			cacheSlots[i].stamp = 0;
+		}
+	}
+}
+
+/**
+ * @brief 仅缓存fonts表中的文件字体，内存字体直接访问无需缓存
+ * */
+static BOOL ICACHE_FLASH_ATTR fontCacheable(Font *font) {
+	if(font < fonts || font >= (fonts + FONT_COUNT)) {
+		return FALSE;
+	}
+	return (font->data == NULL && font->fontBytes <= FONT_CACHE_SLOT_SIZE);
+}
+
 static uint32_t ICACHE_FLASH_ATTR calcOffset12CN(Font *font, wchar charCode) {
     // 默认的gb2312编码大端模式， 区码在低字节位码在高字节
     uint8_t LSB = (charCode >> 8) & 0xFF;
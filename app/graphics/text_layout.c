@@ -0,0 +1,371 @@
+/*
+ * text_layout.c
+ * @brief 文本排版，只在文本或排版参数变化时重新排版，绘制时直接按字形列表调用GuiDrawChar
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#include "graphics/text_layout.h"
+#include "utils/strings.h"
+
+/**
+ * @brief 排版过程状态
+ * */
+typedef struct _text_cursor {
+	TextLayout *layout;
+	const Rect *box;
+	Font *font;
+	Font *engFont;
+	Font *uniFont;
+	uint16_t x;
+	// 当前行第一个字形序号
+	uint16_t lineStart;
+	uint8_t line;
+	uint8_t maxLines;
+} TextCursor;
+
+static uint32_t ICACHE_FLASH_ATTR TextMeasureUnit(uint8_t *text, uint32_t offset, TextCursor *cursor, uint16_t *width);
+static BOOL ICACHE_FLASH_ATTR TextEmit(TextCursor *cursor, uint32_t usc4, uint8_t length);
+static BOOL ICACHE_FLASH_ATTR TextNewLine(TextCursor *cursor);
+static void ICACHE_FLASH_ATTR TextEllipsis(TextCursor *cursor);
+static BOOL ICACHE_FLASH_ATTR TextResolve(TextCursor *cursor, uint16_t unicode, TextGlyph *glyph);
+static BOOL ICACHE_FLASH_ATTR TextHasContent(uint8_t *text);
+static BOOL ICACHE_FLASH_ATTR TextIsOpening(uint32_t unicode);
+static BOOL ICACHE_FLASH_ATTR TextIsClosing(uint32_t unicode);
+static uint32_t ICACHE_FLASH_ATTR TextHash(uint32_t hash, const uint8_t *data, uint32_t length);
+
+// 不出现在行首的标点 ，。、；：？！）》」』”’】〕…
+static const uint16_t closingMarks[] = {0xFF0C, 0x3002, 0x3001, 0xFF1B, 0xFF1A, 0xFF1F, 0xFF01, 0xFF09,
+		0x300B, 0x300D, 0x300F, 0x201D, 0x2019, 0x3011, 0x3015, 0x2026};
+// 不出现在行尾的标点 （《「『“‘【〔
+static const uint16_t openingMarks[] = {0xFF08, 0x300A, 0x300C, 0x300E, 0x201C, 0x2018, 0x3010, 0x3014};
+
+/**
+ * @brief 文本或排版参数变化时重新排版
+ * @param *layout 排版结果，首次使用前清零
+ * @param *text UTF8文本
+ * @param *box 排版区域，第一行顶部对齐box->top
+ * @param *font 中文字体，行高以中文字体为准
+ * @param *engFont 英文字体
+ * @param lineSpacing 行间距
+ * @return TRUE:已重新排版, FALSE:沿用上一次排版结果
+ * */
+BOOL ICACHE_FLASH_ATTR TextLayoutUpdate(TextLayout *layout, uint8_t *text, const Rect *box,
+		Font *font, Font *engFont, uint8_t lineSpacing) {
+	TextCursor cursor;
+	uint32_t key, offset = 0, position, end, usc4;
+	uint16_t width;
+	uint8_t params[4], length;
+	BOOL full = FALSE;
+
+	cursor.uniFont = FontGetUnicode(font);
+	params[0] = font->width;
+	params[1] = font->height;
+	params[2] = engFont->width;
+	params[3] = (lineSpacing & 0x7F) | ((cursor.uniFont != NULL) ? 0x80 : 0x00);
+	key = TextHash(2166136261UL, text, os_strlen((const char *)text));
+	key = TextHash(key, (const uint8_t *)box, sizeof(Rect));
+	key = TextHash(key, params, sizeof(params));
+	key = (key == 0) ? 1 : key;
+	if(layout->key == key) {
+		return FALSE;
+	}
+
+	layout->count = 0;
+	layout->lines = 0;
+	layout->truncated = FALSE;
+	layout->top = (uint8_t)box->top;
+	layout->lineHeight = font->height + lineSpacing;
+	// 字体文件不存在时不排版，下次重试
+	layout->key = 0;
+	if(FontGetFile(font) == NULL || FontGetFile(engFont) == NULL) {
+		return TRUE;
+	}
+	cursor.layout = layout;
+	cursor.box = box;
+	cursor.font = font;
+	cursor.engFont = engFont;
+	cursor.x = box->left;
+	cursor.lineStart = 0;
+	cursor.line = 0;
+	cursor.maxLines = (box->bottom - box->top + 1 + lineSpacing) / layout->lineHeight;
+	if(cursor.maxLines > TEXT_LAYOUT_LINES_MAX) {
+		cursor.maxLines = TEXT_LAYOUT_LINES_MAX;
+	}
+	if(cursor.maxLines == 0) {
+		return TRUE;
+	}
+
+	while(text[offset] != '\0') {
+		if(UTF8ToUnicode((text + offset), &usc4) == 0) {
+			// utf8超范围
+			break;
+		}
+		end = TextMeasureUnit(text, offset, &cursor, &width);
+		if(text[offset] == '\n') {
+			if(!TextNewLine(&cursor)) {
+				if(TextHasContent(text + end)) {
+					TextEllipsis(&cursor);
+				}
+				break;
+			}
+		}else if(text[offset] == ' ') {
+			// 放不下的行尾空格丢弃，换行由下一个单元触发
+			if((cursor.x + width - 1) <= box->right) {
+				full = !TextEmit(&cursor, ' ', 1);
+			}
+		}else if(text[offset] > ' ') {
+			// 整个单元放不下时换行，超过一行宽度的单元在TextEmit中逐字符断开
+			if(cursor.x > box->left && (cursor.x + width - 1) > box->right && !TextNewLine(&cursor)) {
+				TextEllipsis(&cursor);
+				break;
+			}
+			for(position = offset; position < end && !full; position += length) {
+				length = UTF8ToUnicode((text + position), &usc4);
+				full = !TextEmit(&cursor, usc4, length);
+			}
+		}
+		if(full) {
+			TextEllipsis(&cursor);
+			break;
+		}
+		offset = end;
+	}
+	layout->lines = cursor.line + 1;
+	layout->key = key;
+	return TRUE;
+}
+
+/**
+ * @brief 按排版结果绘制
+ * */
+void ICACHE_FLASH_ATTR TextLayoutDraw(const TextLayout *layout, Font *font, Font *engFont) {
+	const TextGlyph *glyph;
+	Font *uniFont, *glyphFont;
+	uint16_t i;
+
+	if(FontGetFile(font) == NULL || FontGetFile(engFont) == NULL) {
+		return;
+	}
+	uniFont = FontGetUnicode(font);
+	for(i = 0; i < layout->count; i++) {
+		glyph = &layout->glyphs[i];
+		if(TEXT_GLYPH_FONT(glyph) == TEXT_GLYPH_ENG) {
+			glyphFont = engFont;
+		}else {
+			glyphFont = (TEXT_GLYPH_FONT(glyph) == TEXT_GLYPH_UNICODE) ? uniFont : font;
+		}
+		if(glyphFont == NULL || (TEXT_GLYPH_FONT(glyph) == TEXT_GLYPH_ENG && glyph->code == ' ')) {
+			continue;
+		}
+		// 限制英文字高为中文高度
+		GuiDrawChar(glyph->code, glyph->x, TEXT_GLYPH_Y(layout, glyph), BLACK, WHITE, glyphFont, font->height);
+	}
+}
+
+/**
+ * @brief 测量一个不可拆分的排版单元: 英文单词、单个中文字符或单个空白字符，
+ *        前面的开始标点和后面的闭合标点并入同一单元
+ * @param offset 单元起始位置
+ * @param *width 单元宽度输出
+ * @return 单元结束位置
+ * */
+static uint32_t ICACHE_FLASH_ATTR TextMeasureUnit(uint8_t *text, uint32_t offset, TextCursor *cursor, uint16_t *width) {
+	uint32_t position = offset, usc4;
+	uint8_t length;
+	BOOL wide = FALSE;
+
+	*width = 0;
+	if(text[position] <= ' ') {
+		*width = (text[position] == ' ') ? cursor->engFont->width : 0;
+		return (position + 1);
+	}
+	while(text[position] != '\0') {
+		length = UTF8ToUnicode((text + position), &usc4);
+		if(length <= 1 || !TextIsOpening(usc4)) {
+			break;
+		}
+		*width += cursor->font->width;
+		position += length;
+	}
+	if(text[position] <= ' ') {
+		return position;
+	}
+	length = UTF8ToUnicode((text + position), &usc4);
+	if(length == 0) {
+		return position;
+	}else if(length == 1) {
+		while(text[position] > ' ' && text[position] < 0x80) {
+			*width += cursor->engFont->width;
+			position++;
+		}
+	}else {
+		// 辅助平面字符不绘制
+		*width += (usc4 > 0xFFFF) ? 0 : cursor->font->width;
+		position += length;
+		wide = TRUE;
+	}
+	while(text[position] != '\0') {
+		length = UTF8ToUnicode((text + position), &usc4);
+		if(length > 1 && TextIsClosing(usc4)) {
+			*width += cursor->font->width;
+		}else if(length == 1 && wide && (usc4 == ',' || usc4 == '.' || usc4 == ';' || usc4 == ':'
+				|| usc4 == '!' || usc4 == '?' || usc4 == ')')) {
+			*width += cursor->engFont->width;
+		}else {
+			break;
+		}
+		position += length;
+	}
+	return position;
+}
+
+/**
+ * @brief 放置一个字形，超出行宽时换行
+ * @return FALSE:区域或字形数已满
+ * */
+static BOOL ICACHE_FLASH_ATTR TextEmit(TextCursor *cursor, uint32_t usc4, uint8_t length) {
+	TextLayout *layout = cursor->layout;
+	TextGlyph *glyph;
+	uint16_t utf16[2];
+	uint8_t width;
+
+	if(length > 1 && UnicodeToUTF16(usc4, utf16) != 1) {
+		return TRUE;
+	}
+	width = (length == 1) ? cursor->engFont->width : cursor->font->width;
+	if((cursor->x + width - 1) > cursor->box->right && !TextNewLine(cursor)) {
+		return FALSE;
+	}
+	if(layout->count >= TEXT_LAYOUT_GLYPHS_MAX) {
+		return FALSE;
+	}
+	glyph = &layout->glyphs[layout->count];
+	glyph->x = (uint8_t)cursor->x;
+	if(length == 1) {
+		glyph->attr = TEXT_GLYPH_ATTR(TEXT_GLYPH_ENG, cursor->line);
+		glyph->code = (wchar)(usc4 & 0xFF);
+	}else {
+		TextResolve(cursor, utf16[0], glyph);
+	}
+	layout->count++;
+	cursor->x += width;
+	return TRUE;
+}
+
+/**
+ * @brief 换到下一行
+ * @return FALSE:已是区域内最后一行
+ * */
+static BOOL ICACHE_FLASH_ATTR TextNewLine(TextCursor *cursor) {
+	if((cursor->line + 1) >= cursor->maxLines) {
+		return FALSE;
+	}
+	cursor->line++;
+	cursor->x = cursor->box->left;
+	cursor->lineStart = cursor->layout->count;
+	return TRUE;
+}
+
+/**
+ * @brief 在当前行末尾放置省略号，放不下时去掉行尾字形，字库中没有省略号时使用"..."
+ * */
+static void ICACHE_FLASH_ATTR TextEllipsis(TextCursor *cursor) {
+	TextLayout *layout = cursor->layout;
+	TextGlyph ellipsis, *glyph;
+	uint16_t x = cursor->box->left, width;
+	uint8_t count, i;
+
+	if(TextResolve(cursor, TEXT_ELLIPSIS, &ellipsis)) {
+		count = 1;
+		width = cursor->font->width;
+	}else {
+		ellipsis.attr = TEXT_GLYPH_ATTR(TEXT_GLYPH_ENG, cursor->line);
+		ellipsis.code = '.';
+		count = 3;
+		width = 3 * cursor->engFont->width;
+	}
+	while(layout->count > cursor->lineStart) {
+		glyph = &layout->glyphs[layout->count - 1];
+		x = glyph->x + ((TEXT_GLYPH_FONT(glyph) == TEXT_GLYPH_ENG) ? cursor->engFont->width : cursor->font->width);
+		if(!(TEXT_GLYPH_FONT(glyph) == TEXT_GLYPH_ENG && glyph->code == ' ')
+				&& (x + width - 1) <= cursor->box->right && (layout->count + count) <= TEXT_LAYOUT_GLYPHS_MAX) {
+			break;
+		}
+		layout->count--;
+		x = cursor->box->left;
+	}
+	if((x + width - 1) > cursor->box->right || (layout->count + count) > TEXT_LAYOUT_GLYPHS_MAX) {
+		return;
+	}
+	for(i = 0; i < count; i++) {
+		glyph = &layout->glyphs[layout->count++];
+		glyph->code = ellipsis.code;
+		glyph->attr = ellipsis.attr;
+		glyph->x = (uint8_t)x;
+		x += (width / count);
+	}
+	layout->truncated = TRUE;
+}
+
+/**
+ * @brief 查询字符在中文字体中的编码，同尺寸的Unicode子集字库优先
+ * @return FALSE:字库中没有该字符
+ * */
+static BOOL ICACHE_FLASH_ATTR TextResolve(TextCursor *cursor, uint16_t unicode, TextGlyph *glyph) {
+	Short code;
+
+	if(cursor->uniFont != NULL && FontHasGlyph(cursor->uniFont, unicode)) {
+		glyph->attr = TEXT_GLYPH_ATTR(TEXT_GLYPH_UNICODE, cursor->line);
+		glyph->code = unicode;
+		return TRUE;
+	}
+	code = QueryGB2312ByUnicode(unicode);
+	glyph->attr = TEXT_GLYPH_ATTR(TEXT_GLYPH_GB2312, cursor->line);
+	glyph->code = (wchar)((code.bytes[0] << 8) | code.bytes[1]);
+	return (code.value != 0);
+}
+
+/**
+ * @brief 剩余文本中是否还有可见字符
+ * */
+static BOOL ICACHE_FLASH_ATTR TextHasContent(uint8_t *text) {
+	while(*text != '\0') {
+		if(*text > ' ') {
+			return TRUE;
+		}
+		text++;
+	}
+	return FALSE;
+}
+
+static BOOL ICACHE_FLASH_ATTR TextIsOpening(uint32_t unicode) {
+	uint8_t i;
+	for(i = 0; i < (sizeof(openingMarks) / sizeof(uint16_t)); i++) {
+		if(openingMarks[i] == unicode) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+static BOOL ICACHE_FLASH_ATTR TextIsClosing(uint32_t unicode) {
+	uint8_t i;
+	for(i = 0; i < (sizeof(closingMarks) / sizeof(uint16_t)); i++) {
+		if(closingMarks[i] == unicode) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/**
+ * @brief FNV-1a哈希累加
+ * */
+static uint32_t ICACHE_FLASH_ATTR TextHash(uint32_t hash, const uint8_t *data, uint32_t length) {
+	uint32_t i;
+	for(i = 0; i < length; i++) {
+		hash = (hash ^ *(data + i)) * 16777619UL;
+	}
+	return hash;
+}
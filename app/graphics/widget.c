@@ -0,0 +1,271 @@
+/*
+ * widget.c
+ * @brief 保留模式控件层
+ * @note 显存保留着同一视图的上一帧时，只清除并重绘绑定数据变化的控件，
+ *       与其区域重叠的控件一起重绘以保持叠放次序，变化区域通过GuiInvalidateRect上报；
+ *       切换回页面时从整帧缓存恢复该页面上一帧，再按保留帧处理；
+ *       整帧绘制时WIDGET_STATIC控件从页面的静态图层缓存恢复
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#include "graphics/widget.h"
+
+static uint32_t ICACHE_FLASH_ATTR WidgetHash(uint32_t hash, const uint8_t *data, uint32_t length);
+static uint32_t ICACHE_FLASH_ATTR WidgetSignature(const Widget *widget, const void **sources, char *content);
+static void ICACHE_FLASH_ATTR WidgetDraw(const Widget *widget, const void **sources, char *content);
+static BOOL ICACHE_FLASH_ATTR WidgetIntersects(const Rect *a, const Rect *b);
+#ifndef EPD_BANDED_RENDER
+static uint32_t ICACHE_FLASH_ATTR WidgetStaticMask(const WidgetTree *tree);
+static uint32_t ICACHE_FLASH_ATTR WidgetFrameSignature(const WidgetTree *tree);
+#endif
+static uint8_t ICACHE_FLASH_ATTR WidgetDrawMask(const WidgetTree *tree, uint32_t mask, const void **sources, char *content);
+
+/**
+ * @brief 绘制控件树
+ * @param *tree 控件树
+ * @param *sources 数据源，按WidgetSource排列
+ * @return 本次绘制的控件数
+ * */
+uint8_t ICACHE_FLASH_ATTR WidgetTreeRender(WidgetTree *tree, const void **sources) {
+	char content[WIDGET_CONTENT_SIZE];
+	const Widget *widget;
+	uint32_t dirty = 0, closure, signature;
+	uint8_t i, j, drawn = 0;
+#ifndef EPD_BANDED_RENDER
+	uint32_t layerMask;
+#endif
+	BOOL retained;
+	Rect area;
+
+	if(tree->count > WIDGET_TREE_MAX) {
+		return 0;
+	}
+	retained = (tree->valid && GuiIsFrameRetained());
+#ifndef EPD_BANDED_RENDER
+	// 切换回该页面时恢复其上一帧，之后只重绘变化的控件
+	if(!retained && tree->valid && tree->layer < GUI_LAYER_PAGES) {
+		retained = GuiRestoreLayer((GUI_LAYER_FRAME_BASE + tree->layer), WidgetFrameSignature(tree));
+	}
+#endif
+
+	for(i = 0; i < tree->count; i++) {
+		signature = WidgetSignature((tree->widgets + i), sources, content);
+		if(!retained || signature != tree->signatures[i]) {
+			dirty |= (1UL << i);
+		}
+		tree->signatures[i] = signature;
+	}
+	tree->valid = TRUE;
+
+	if(!retained) {
+#ifndef EPD_BANDED_RENDER
+		// 整帧绘制时先恢复静态图层，只绘制动态控件
+		layerMask = (tree->layer < GUI_LAYER_PAGES) ? WidgetStaticMask(tree) : 0;
+		if(layerMask != 0) {
+			signature = WidgetHash(2166136261UL, (const uint8_t *)&layerMask, sizeof(uint32_t));
+			for(i = 0; i < tree->count; i++) {
+				if(layerMask & (1UL << i)) {
+					signature = WidgetHash(signature, (const uint8_t *)&tree->signatures[i], sizeof(uint32_t));
+				}
+			}
+			if(!GuiRestoreLayer(tree->layer, signature)) {
+				EPDDisplayClear();
+				drawn = WidgetDrawMask(tree, layerMask, sources, content);
+				GuiSaveLayer(tree->layer, signature);
+			}
+			dirty &= ~layerMask;
+		}else {
+			EPDDisplayClear();
+		}
+#else
+		EPDDisplayClear();
+#endif
+	}else {
+		// 与重绘控件重叠的控件一起重绘，保证结果与整帧绘制相同
+		do {
+			closure = dirty;
+			for(i = 0; i < tree->count; i++) {
+				if(!(dirty & (1UL << i))) {
+					continue;
+				}
+				for(j = 0; j < tree->count; j++) {
+					if(!(dirty & (1UL << j)) && WidgetIntersects(&tree->widgets[i].rect, &tree->widgets[j].rect)) {
+						dirty |= (1UL << j);
+					}
+				}
+			}
+		}while(closure != dirty);
+		// 先清除全部重绘区域，再按叠放次序绘制
+		for(i = 0; i < tree->count; i++) {
+			if(!(dirty & (1UL << i))) {
+				continue;
+			}
+			widget = (tree->widgets + i);
+			GuiFillColor(widget->rect.left, widget->rect.top, widget->rect.right, widget->rect.bottom, WHITE);
+			if(drawn == 0) {
+				os_memcpy(&area, &widget->rect, sizeof(Rect));
+			}else {
+				if(widget->rect.left < area.left) area.left = widget->rect.left;
+				if(widget->rect.top < area.top) area.top = widget->rect.top;
+				if(widget->rect.right > area.right) area.right = widget->rect.right;
+				if(widget->rect.bottom > area.bottom) area.bottom = widget->rect.bottom;
+			}
+			drawn++;
+		}
+		GuiInvalidateRect((drawn > 0) ? &area : NULL);
+		drawn = 0;
+	}
+
+	drawn += WidgetDrawMask(tree, dirty, sources, content);
+#ifndef EPD_BANDED_RENDER
+	// 没有控件重绘时整帧签名不变，不重复压缩保存
+	if(drawn > 0 && tree->layer < GUI_LAYER_PAGES) {
+		GuiSaveLayer((GUI_LAYER_FRAME_BASE + tree->layer), WidgetFrameSignature(tree));
+	}
+#endif
+	return drawn;
+}
+
+/**
+ * @brief 按叠放次序绘制mask中的控件，每个控件裁剪到自身区域
+ * @return 绘制的控件数
+ * */
+static uint8_t ICACHE_FLASH_ATTR WidgetDrawMask(const WidgetTree *tree, uint32_t mask, const void **sources, char *content) {
+	uint8_t i, drawn = 0;
+
+	for(i = 0; i < tree->count; i++) {
+		if(!(mask & (1UL << i))) {
+			continue;
+		}
+		// 分带渲染时不在当前条带的控件直接跳过
+		if(GuiPushClipRect(&tree->widgets[i].rect)) {
+			WidgetDraw((tree->widgets + i), sources, content);
+			GuiPopClipRect();
+			drawn++;
+		}
+	}
+	return drawn;
+}
+
+#ifndef EPD_BANDED_RENDER
+
+/**
+ * @brief 整帧签名，由全部控件签名组成，用于页面整帧缓存
+ * */
+static uint32_t ICACHE_FLASH_ATTR WidgetFrameSignature(const WidgetTree *tree) {
+	return WidgetHash(2166136261UL, (const uint8_t *)tree->signatures, (tree->count * sizeof(uint32_t)));
+}
+
+/**
+ * @brief 可放入静态图层的控件，与动态控件重叠的静态控件按动态控件处理，
+ *        保证先恢复静态图层再绘制动态控件与按叠放次序绘制结果相同
+ * */
+static uint32_t ICACHE_FLASH_ATTR WidgetStaticMask(const WidgetTree *tree) {
+	uint32_t mask = 0, last;
+	uint8_t i, j;
+
+	for(i = 0; i < tree->count; i++) {
+		if(tree->widgets[i].type & WIDGET_STATIC) {
+			mask |= (1UL << i);
+		}
+	}
+	do {
+		last = mask;
+		for(i = 0; i < tree->count; i++) {
+			if(!(mask & (1UL << i))) {
+				continue;
+			}
+			for(j = 0; j < tree->count; j++) {
+				if(!(mask & (1UL << j)) && WidgetIntersects(&tree->widgets[i].rect, &tree->widgets[j].rect)) {
+					mask &= ~(1UL << i);
+					break;
+				}
+			}
+		}
+	}while(last != mask);
+	return mask;
+}
+
+#endif
+
+/**
+ * @brief 计算控件签名，包含绑定字段和格式化后的内容
+ * @param *content 格式化内容输出
+ * */
+static uint32_t ICACHE_FLASH_ATTR WidgetSignature(const Widget *widget, const void **sources, char *content) {
+	const WidgetBinding *binding;
+	uint32_t hash = 2166136261UL;
+	uint8_t i;
+
+	for(i = 0; i < WIDGET_BINDING_MAX; i++) {
+		binding = &widget->bindings[i];
+		if(binding->length == 0 || binding->source >= WIDGET_SOURCE_COUNT || sources[binding->source] == NULL) {
+			continue;
+		}
+		hash = WidgetHash(hash, ((const uint8_t *)sources[binding->source] + binding->offset), binding->length);
+	}
+	if(widget->format != NULL) {
+		content[0] = '\0';
+		widget->format(widget, sources, content);
+		content[WIDGET_CONTENT_SIZE - 1] = '\0';
+		hash = WidgetHash(hash, (const uint8_t *)content, os_strlen(content));
+	}
+	return hash;
+}
+
+/**
+ * @brief 按控件类型绘制
+ * */
+static void ICACHE_FLASH_ATTR WidgetDraw(const Widget *widget, const void **sources, char *content) {
+	const WidgetBinding *binding = &widget->bindings[0];
+	char *text = content;
+
+	if(widget->format != NULL) {
+		content[0] = '\0';
+		widget->format(widget, sources, content);
+		content[WIDGET_CONTENT_SIZE - 1] = '\0';
+	}else if(binding->length > 0 && binding->source < WIDGET_SOURCE_COUNT && sources[binding->source] != NULL) {
+		// 无format时直接使用第一个绑定的字符串字段
+		text = (char *)sources[binding->source] + binding->offset;
+	}else {
+		content[0] = '\0';
+	}
+
+	switch(widget->type & WIDGET_TYPE_MASK) {
+		case WIDGET_TEXT:
+			GuiDrawStringUTF8((uint8_t *)text, widget->rect.left, widget->rect.top,
+					getFont(widget->font), getFont(widget->engFont));
+			break;
+		case WIDGET_ICON:
+			if(text[0] != '\0') {
+				GuiDrawBmpImage(text, "bmp", widget->rect.left, widget->rect.top);
+			}
+			break;
+		case WIDGET_BITMAP:
+			if(widget->draw != NULL) {
+				widget->draw(widget, sources, text);
+			}
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * @brief 判断两个区域是否相交
+ * */
+static BOOL ICACHE_FLASH_ATTR WidgetIntersects(const Rect *a, const Rect *b) {
+	return !((a->right < b->left) || (a->left > b->right) || (a->bottom < b->top) || (a->top > b->bottom));
+}
+
+/**
+ * @brief FNV-1a哈希累加
+ * */
+static uint32_t ICACHE_FLASH_ATTR WidgetHash(uint32_t hash, const uint8_t *data, uint32_t length) {
+	uint32_t i;
+	for(i = 0; i < length; i++) {
+		hash = (hash ^ *(data + i)) * 16777619UL;
+	}
+	return hash;
+}
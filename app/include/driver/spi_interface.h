@@ -213,6 +213,21 @@ void SPIMasterCfgCmd(SpiNum spiNum, uint32_t cmd);
  */
 int32_t SPIMasterSendData(SpiNum spiNum, SpiData *pInData);
 
+/**
+ * @brief Send a continuous byte stream from master, filling all 64 bytes of
+ *        W0~W15 per transaction.
+ *
+ * @param [in] spiNum
+ *             Indicates which submode to be used, SPI or HSPI.
+ * @param [in] data
+ *             Pointer to the bytes to be send, no alignment required.
+ * @param [in] length
+ *             Number of bytes, no upper limit.
+ *
+ * @return int32_t, -1:indicates failure,others indicates success.
+ */
+int32_t SPIMasterSendBurst(SpiNum spiNum, const uint8_t *data, uint32_t length);
+
 /**
  * @brief Receive data from slave by master.
  *
@@ -6,8 +6,10 @@
 #include "gpio.h"
 #include "mem.h"
 #include "osapi.h"
+#include "user_interface.h"
 #include "gpio16.h"
 #include "spi_interface.h"
+#include "driver/user_button.h"
 #include "graphics/color.h"
 #include "utils/eventbus.h"
 #include "utils/eventdef.h"
@@ -54,10 +56,67 @@ typedef enum _transfer_type {
 #define EPD_RAM_WIDTH    16
 
 // epd刷新超时(显示完成后拉低EPD_BUSY_PIN)时间，正常应在4秒左右
+// 刷新完成由BUSY下降沿中断通知，此值仅作为看门狗
 #define EPD_REFRESH_TIMEOUT    10000
 
+// MAIN_EVENT_EPD_FINISH事件参数
+#define EPD_FINISH_OK         0
+#define EPD_FINISH_TIMEOUT    1
+// 初始化或写入RAM失败，未开始刷新
+#define EPD_FINISH_ERROR      2
+
+// 显存异步写入任务，USER_TASK_PRIO_0已由uart接收任务占用
+#define EPD_FLUSH_TASK_PRIO         USER_TASK_PRIO_1
+#define EPD_FLUSH_TASK_QUEUE_LEN    2
+// 每次任务写入的RAM行数(整行时512字节)
+#define EPD_FLUSH_CHUNK_ROWS        32
+
+/**
+ * 分带渲染模式，不分配整屏显存(4000字节)，只使用EPD_BAND_ROWS行的条带缓存
+ * 视图逐带绘制并写入控制器RAM，由控制器保存整帧
+ * 该模式下没有整帧显存，不支持局部刷新和显存读取
+ * */
+//#define EPD_BANDED_RENDER
+
+// 条带行数(RAM行，即水平方向像素)，每带EPD_BAND_ROWS * EPD_RAM_WIDTH字节
+#define EPD_BAND_ROWS     25
+#define EPD_BAND_COUNT    ((EPD_HEIGHT + EPD_BAND_ROWS - 1) / EPD_BAND_ROWS)
+
+#ifdef EPD_BANDED_RENDER
+#define EPD_BUFFER_ROWS    EPD_BAND_ROWS
+#else
+#define EPD_BUFFER_ROWS    EPD_HEIGHT
+#endif
+
 //#define USE_SOFT_SPI
 
+// 串口输出每次写入控制器RAM耗费的CPU周期数
+//#define EPD_PROFILE_FLUSH
+
+/**
+ * 保留控制器RAM: 保持运行、modem sleep和light sleep期间EPD不断电，控制器以DEEP_SLEEP_MODE1保留RAM，
+ * 下一次更新只写入变化区域并使用局部刷新波形，代价是休眠期间控制器约1uA的保持电流
+ * 未定义时与原驱动相同，每次刷新后以DEEP_SLEEP_MODE2断电，总是全局刷新
+ * */
+//#define EPD_RETAIN_IN_LIGHT_SLEEP
+
+/**
+ * 串口输出每次刷新的耗时与能耗估算值
+ * 只有各阶段时长是测量值，能耗 = 时长 x 下列电流 x 供电电压，电流并非实测，
+ * 结果只能用于比较全局/局部刷新的相对差异，实际能耗需用电流表测量后修改下列常量
+ * 目前没有DEEP_SLEEP_MODE1(保留RAM)与DEEP_SLEEP_MODE2每次更新能耗的实测数据
+ * */
+//#define EPD_ESTIMATE_ENERGY
+
+// 供电电压(mV)，开发板3V3电源
+#define EPD_EST_SUPPLY_MV            3300
+// MCU在EPD更新期间(写入RAM/等待BUSY，射频关闭)的电流(uA)，取ESP8266EX数据手册Modem-sleep典型值15mA
+#define EPD_EST_MCU_CURRENT_UA       15000
+// 控制器刷新波形期间的电流(uA)，假设值，未找到面板的刷新电流规格，需按实测修改
+#define EPD_EST_REFRESH_CURRENT_UA   4000
+// DEEP_SLEEP_MODE1保留RAM时的电流(uA)，取SSD1675B数据手册深度睡眠模式1的1uA(见DEEP_SLEEP_MODE1)
+#define EPD_EST_RETAIN_CURRENT_UA    1
+
 /**
  * After this command initiated, the chip will enter Deep Sleep Mode, BUSY pad will keep output high.
  * Remark: To Exit Deep Sleep mode, User required to send HWRESET to the driver
@@ -74,6 +133,52 @@ typedef enum _transfer_type {
 
 #define READ_INTERNAL_TEMP_CMD    (0x1B)
 
+// 温度读取失败
+#define EPD_TEMPERATURE_INVALID    (-128)
+// 等待温度加载完成的最长时间(us)
+#define EPD_TEMPERATURE_TIMEOUT    5000
+
+// LUT长度，第16~23字节为波形各阶段帧数
+#define EPD_LUT_SIZE           30
+#define EPD_LUT_PHASE_START    16
+#define EPD_LUT_PHASE_COUNT    8
+
+// 保留的刷新计时记录个数
+#define EPD_TIMING_RECORDS    8
+
+#define EPD_TIMING_FULL       0
+#define EPD_TIMING_PARTIAL    1
+
+// 一次EPD更新各阶段的开始时间(system_get_time, us)，未执行的阶段为0
+typedef struct _epd_timing {
+	// EPDReset 复位
+	uint32_t reset;
+	// EPDInit 初始化及LUT加载
+	uint32_t init;
+	// EPDFlush/EPDFlushWindow 写入RAM
+	uint32_t flush;
+	// EPDTurnOnDisplay 开始刷新，等待BUSY
+	uint32_t refresh;
+	// BUSY释放或超时
+	uint32_t finish;
+	// 进入深度睡眠完成
+	uint32_t sleep;
+	// EPD_TIMING_FULL / EPD_TIMING_PARTIAL
+	uint8_t type;
+	// EPD_FINISH_OK / EPD_FINISH_TIMEOUT / EPD_FINISH_ERROR
+	uint8_t result;
+	// 写入0x24 RAM的字节数
+	uint16_t bytes;
+} EPDTiming;
+
+typedef struct _epd_waveform {
+	// 适用的温度范围(摄氏度)
+	sint8_t minTemperature;
+	sint8_t maxTemperature;
+	// 全局刷新LUT
+	const uint8_t *lut;
+} EPDWaveform;
+
 extern const uint8_t LUT_FULL_UPDATE[];
 extern const uint8_t LUT_PARTIAL_UPDATE[];
 
@@ -89,18 +194,44 @@ void ICACHE_FLASH_ATTR EPDReset();
 
 STATUS ICACHE_FLASH_ATTR EPDInit(const uint8_t *lut);
 
+sint8_t ICACHE_FLASH_ATTR EPDReadTemperature();
+
+void ICACHE_FLASH_ATTR EPDSetTemperature(sint8_t temperature);
+
 void ICACHE_FLASH_ATTR EPDDrawVertical(uint16_t x, uint16_t y, uint8_t color);
 void ICACHE_FLASH_ATTR EPDDrawHorizontal(uint16_t x, uint16_t y, uint8_t color);
+void ICACHE_FLASH_ATTR EPDFillSpan(uint16_t x, uint16_t yStart, uint16_t yEnd, uint8_t color);
+void ICACHE_FLASH_ATTR EPDBlitColumn(uint16_t x, uint16_t y, uint32_t bits, uint8_t height, uint8_t foreground, uint8_t background);
 
 STATUS ICACHE_FLASH_ATTR EPDFlush();
 
 STATUS ICACHE_FLASH_ATTR EPDFillData(uint8_t *data);
 
+STATUS ICACHE_FLASH_ATTR EPDFlushWindow(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd);
+
+void ICACHE_FLASH_ATTR EPDSetRetainRAM(BOOL retain);
+
+BOOL ICACHE_FLASH_ATTR EPDCanPartialUpdate();
+
+STATUS ICACHE_FLASH_ATTR EPDCancelUpdate();
+
+#ifdef EPD_BANDED_RENDER
+void ICACHE_FLASH_ATTR EPDBandBegin(uint8_t band);
+
+void ICACHE_FLASH_ATTR EPDGetBandRect(uint16_t *xStart, uint16_t *xEnd);
+
+STATUS ICACHE_FLASH_ATTR EPDBandFlush();
+#endif
+
 STATUS ICACHE_FLASH_ATTR EPDTurnOnDisplay();
 // STATUS ICACHE_FLASH_ATTR EPDTurnOnDisplayEx();
 
 STATUS ICACHE_FLASH_ATTR EPDGetStatus();
 
+BOOL ICACHE_FLASH_ATTR EPDIsUpdating();
+
+uint8_t ICACHE_FLASH_ATTR EPDGetTimings(EPDTiming *records, uint8_t max);
+
 void ICACHE_FLASH_ATTR EPDFillDisplayRAM(uint8_t *ptr, uint16_t offset, uint16_t length);
 
 #endif
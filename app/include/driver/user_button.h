@@ -25,6 +25,8 @@ typedef void (* DoubleClickListener)(void);
 
 typedef void (* LongClickListener)(void);
 
+typedef void (* PinIRQListener)(void);
+
 // 长按最短持续时间(us)
 #define LONG_CLICK_TIME       (3000000)
 
@@ -43,6 +45,10 @@ void ICACHE_FLASH_ATTR UserButtonInit(void);
 
 void ICACHE_FLASH_ATTR UserButtonIRQInit(void);
 
+void ICACHE_FLASH_ATTR UserButtonIRQDisable(void);
+
+void ICACHE_FLASH_ATTR UserButtonAddPinIRQListener(uint8_t pin, PinIRQListener listener);
+
 uint8_t ICACHE_FLASH_ATTR UserButtonLevelRead(void);
 
 void ICACHE_FLASH_ATTR UserButtonAddClickListener(ClickListener clickListener);
@@ -50,8 +50,14 @@
 
 #define BIHEIGHT           22
 #define BIHEIGHT_LENGTH    4
+
+// 格式检查读入的文件头长度，至biCompression结束，4字节对齐
+#define BMP_HEADER_LENGTH    36
 // end of bmp-dib header
 
+// 顺序读取bmp数据申请不到整簇缓存时使用的块缓存大小
+#define BMP_READER_FALLBACK_SIZE    128
+
 // start of bmp-packed header
 #define BITMAP_PACKED     0xFEFD
 #define PACKED_HEADER_LENGTH    2
@@ -68,6 +74,80 @@
 #define PACKED_DATA_OFFSET    10
 // end of bmp-packed header
 
+// start of pwi header，预旋转图片由tools/make_pwi.py从bmp转换生成
+// 数据按列存储，每列(height + 7) / 8字节，首字节最高位为第一行，与显存RAM行排列一致
+#define PWI_EXTNAME       "pwi"
+#define PWI_MAGIC         0x00495750
+#define PWI_VERSION       1
+// 数据经过RLE压缩，方式同bmp-packed：0x00/0xFF后跟1字节长度，长度为0时再跟2字节长度，其余字节为原始数据
+#define PWI_FLAG_RLE      0x01
+// 单列最大字节数
+#define PWI_COLUMN_MAX    ((SCREEN_HEIGHT + 7) / 8)
+
+typedef struct _pwi_header {
+	// 'P' 'W' 'I' '\0'
+	uint32_t magic;
+	uint8_t version;
+	uint8_t flags;
+	uint16_t width;
+	uint16_t height;
+	uint16_t reserved;
+} PwiHeader;
+// end of pwi header
+
+/**
+ * @brief 屏幕矩形区域，边界包含在内
+ * */
+typedef struct _rect {
+	int16_t left;
+	int16_t top;
+	int16_t right;
+	int16_t bottom;
+} Rect;
+
+// 裁剪区域栈深度，GuiPushClipRect嵌套层数上限
+#define GUI_CLIP_STACK_DEPTH    8
+
+// 每次绘制后串口输出填充图元和字符绘制耗费的CPU周期数，以及字模缓存命中次数
+//#define GUI_PROFILE_DRAW
+
+// 显存相对于上一次计算变化区域时的变化范围
+#define GUI_DIRTY_NONE       0
+#define GUI_DIRTY_RECT       1
+#define GUI_DIRTY_UNKNOWN    2
+
+// 图层缓存页面数，每个页面占用一个静态图层槽和一个整帧缓存槽
+#define GUI_LAYER_PAGES           4
+#define GUI_LAYER_SLOTS           (GUI_LAYER_PAGES * 2)
+// 整帧缓存槽起始序号，每次绘制后更新，只放入RAM
+#define GUI_LAYER_FRAME_BASE      GUI_LAYER_PAGES
+#define GUI_LAYER_NONE            0xFF
+// 图层放入RAM后至少保留的空闲堆，不足时不缓存
+// 天气请求期间的临时分配: HTTP缓冲区(HTTP_CONTENT_MAX)6KB，TCP连接和接收pbuf约4KB
+#define GUI_LAYER_HEAP_RESERVE    (10 * 1024)
+// 缓存状态
+#define GUI_LAYER_EMPTY           0
+#define GUI_LAYER_RAM             1
+
+/**
+ * @brief 图层缓存(静态图层或页面整帧)，整帧显存按pwi的0x00/0xFF连续段方式压缩
+ * */
+typedef struct _gui_layer {
+	// 图层内容签名，由绘制者计算
+	uint32_t signature;
+	// 压缩后长度
+	uint16_t length;
+	uint8_t state;
+	uint8_t reserved;
+	// 压缩数据
+	uint8_t *data;
+} GuiLayer;
+
+/**
+ * @brief 视图绘制回调，分带渲染时每个条带调用一次，必须可以重复执行
+ * */
+typedef void (* GuiRenderCallback)(uint32_t arg);
+
 /**
  * @brief 底层绘制api，调用屏幕驱动
  * */
@@ -96,9 +176,30 @@ uint16_t ICACHE_FLASH_ATTR GuiDrawStringUTF8(uint8_t *str, uint16_t xStart, uint
 void ICACHE_FLASH_ATTR GuiDrawBmpImageImpl(File *file, uint16_t xStart, uint16_t yStart);
 void ICACHE_FLASH_ATTR GuiDrawBmpImage(char *fileName, char *extName, uint16_t xStart, uint16_t yStart);
 void ICACHE_FLASH_ATTR GuiDrawImagePacked(const uint8_t *data, uint16_t xStart, uint16_t yStart);
+BOOL ICACHE_FLASH_ATTR GuiDrawPwiImageImpl(File *file, uint16_t xStart, uint16_t yStart);
 
 //void ICACHE_FLASH_ATTR GuiDrawBmpRaw(const uint8_t *data, uint16_t xStart, uint16_t yStart);
 
 uint8_t ICACHE_FLASH_ATTR GuiCheckBMPFormat(File *file, uint32_t *width, uint32_t *height, uint32_t *dataOffset);
 
+void ICACHE_FLASH_ATTR GuiSetClipRect(const Rect *rect);
+BOOL ICACHE_FLASH_ATTR GuiPushClipRect(const Rect *rect);
+void ICACHE_FLASH_ATTR GuiPopClipRect();
+void ICACHE_FLASH_ATTR GuiGetClipRect(Rect *rect);
+
+void ICACHE_FLASH_ATTR GuiRender(GuiRenderCallback render, uint32_t arg);
+BOOL ICACHE_FLASH_ATTR GuiRenderDeferred();
+BOOL ICACHE_FLASH_ATTR GuiIsFrameRetained();
+void ICACHE_FLASH_ATTR GuiInvalidateRect(const Rect *rect);
+void ICACHE_FLASH_ATTR GuiInvalidateFrame();
+
+#ifdef EPD_BANDED_RENDER
+uint32_t ICACHE_FLASH_ATTR GuiRenderBands();
+#else
+BOOL ICACHE_FLASH_ATTR GuiGetDirtyRegion(Rect *rect);
+uint32_t ICACHE_FLASH_ATTR GuiGetFrameHash();
+BOOL ICACHE_FLASH_ATTR GuiSaveLayer(uint8_t slot, uint32_t signature);
+BOOL ICACHE_FLASH_ATTR GuiRestoreLayer(uint8_t slot, uint32_t signature);
+#endif
+
 #endif
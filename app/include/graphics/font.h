@@ -3,6 +3,10 @@
  * @brief 字体定义结构体
  * @brief 添加文件字体支持，文件系统依赖spifs
  * @brief 添加每个字体的字节序反转接口endianSwap
+ * @brief 添加文件字体的LRU字模缓存
+ * @brief 文件字体句柄常驻，文件变更时由FontInvalidateFile失效
+ * @brief 添加按列预旋转的pwf字体格式，存在同名pwf文件时优先使用
+ * @brief 添加以Unicode编码索引的子集pwf字体，UTF8字符串直接查字模
  * Created on: Jun 1, 2020
  * Author: Yanye
  */
@@ -38,7 +42,7 @@ struct _font {
 	uint8_t width;
 	// 字体高度(pixel)
 	uint8_t height;
-	// 逐行扫描, 每行的字节数(byte)
+	// 逐行扫描, 每行的字节数(byte)；FONT_LAYOUT_COLUMN时为每列的字节数
 	uint8_t lineBytes;
 	// 单个bitmap字体总字节数(byte)，出于结构体对齐添加，实际上根据height * lineBytes可以计算出
 	uint8_t fontBytes;
@@ -50,7 +54,9 @@ struct _font {
 	int16_t hspacing;
 	// 字体绘制垂直间隔, 默认0
 	int16_t vspacing;
-	// 用户定义数据
+	// 字模数据排列方式 FontLayout
+	uint8_t layout;
+	// 文件字体为常驻的文件句柄(File *)，由FontGetFile维护
 	void *user_data;
 };
 
@@ -64,11 +70,121 @@ typedef enum _font_type {
 	// 6x12 点阵 ASCII标准字符
 	FONT06x12_EN,
 	// 国标特殊字符内码组成为ACA1~ACDF 共计 64 个字符
-	FONT08x16_EXT
+	FONT08x16_EXT,
+	// 12x12 点阵 Unicode编码子集字库(仅pwf)
+	FONT12x12_UNI,
+	// 16x16 点阵 Unicode编码子集字库(仅pwf)
+	FONT16x16_UNI
 } FontType;
 
+/**
+ * 字模数据排列方式
+ */
+typedef enum _font_layout {
+	// 逐行扫描，行内高位在左，需要endianSwap并转置后绘制(bin字库)
+	FONT_LAYOUT_ROW = 0,
+	// 逐列扫描，列内首字节最高位为第一行，与显存RAM行排列一致(pwf字库)
+	FONT_LAYOUT_COLUMN
+} FontLayout;
+
+/**
+ * pwf字体文件格式(小端):
+ * [PwfHeader 16bytes][PwfBlock * blockCount][glyph * glyphCount]
+ * 字符编码为字符串中按小端读取的wchar，低字节为首字节(GB2312区码)，高字节为第二字节(位码)
+ * 每个block覆盖低字节[lowFirst, lowLast] x 高字节[highFirst, highLast]的矩形编码区，
+ * 以低字节为主序连续存储，字模序号 = base + (low - lowFirst) * (highLast - highFirst + 1) + (high - highFirst)
+ * 每个字模为width列，每列columnBytes字节
+ * 由tools/make_pwf.py从bin字库转换生成
+ *
+ * encoding = PWF_ENCODING_UNICODE时为Unicode子集字库，blockCount = 0:
+ * [PwfHeader 16bytes][uint16_t pageStart[257]][uint8_t low[glyphCount]][glyph * glyphCount]
+ * 编码高字节为页号，pageStart[page]~pageStart[page + 1]为该页的字模序号范围，
+ * low[]为各字模编码低字节，页内升序排列
+ */
+#define PWF_EXTNAME            "pwf"
+#define PWF_MAGIC              0x00465750
+#define PWF_VERSION            1
+// 单个字体文件最多支持的编码区数量
+#define PWF_BLOCKS_MAX         4
+// Unicode子集字库的页数和最大字模数量
+#define PWF_UNICODE_PAGES      256
+#define PWF_UNICODE_GLYPHS_MAX 4096
+
+typedef enum _pwf_encoding {
+	// 按编码区矩形排列，GB2312/ASCII
+	PWF_ENCODING_BLOCK = 0,
+	// 按Unicode页索引排列
+	PWF_ENCODING_UNICODE
+} PwfEncoding;
+
+typedef struct _pwf_header {
+	// 'P' 'W' 'F' '\0'
+	uint32_t magic;
+	uint8_t version;
+	uint8_t width;
+	uint8_t height;
+	// 每列字节数 = (height + 7) / 8
+	uint8_t columnBytes;
+	// 单个字模字节数 = width * columnBytes
+	uint16_t glyphBytes;
+	uint16_t glyphCount;
+	uint8_t blockCount;
+	// PwfEncoding
+	uint8_t encoding;
+	uint8_t reserved[2];
+} PwfHeader;
+
+typedef struct _pwf_block {
+	uint8_t lowFirst;
+	uint8_t lowLast;
+	uint8_t highFirst;
+	uint8_t highLast;
+	// 本区第一个字模的序号
+	uint16_t base;
+	uint16_t reserved;
+} PwfBlock;
+
+// 字模缓存总容量(byte)，按FONT_CACHE_SLOT_SIZE划分缓存槽
+#define FONT_CACHE_SIZE            2048
+// 单个缓存槽字节数，大于该值的字模不缓存(16x16中文字模32字节)
+#define FONT_CACHE_SLOT_SIZE       32
+#define FONT_CACHE_SLOTS           (FONT_CACHE_SIZE / FONT_CACHE_SLOT_SIZE)
+// 最近FONT_CACHE_PIN_FRAMES帧(GuiRender)内使用过的字模不被替换，页面字符多于缓存槽数时超出的字模不缓存，
+// 避免逐帧重绘同一页面时LRU按绘制顺序循环替换全部字模
+#define FONT_CACHE_PIN_FRAMES      2
+
+/**
+ * 字模缓存统计
+ */
+typedef struct _font_cache_stats {
+	// 命中次数
+	uint32_t hits;
+	// 未命中次数
+	uint32_t misses;
+	// 已占用缓存槽数
+	uint32_t entries;
+} FontCacheStats;
+
 void ICACHE_FLASH_ATTR loadFont(void);
 
 Font * ICACHE_FLASH_ATTR getFont(FontType tp);
 
+File * ICACHE_FLASH_ATTR FontGetFile(Font *font);
+
+void ICACHE_FLASH_ATTR FontInvalidateFile(uint8_t *filename);
+
+Font * ICACHE_FLASH_ATTR FontGetUnicode(Font *font);
+
+BOOL ICACHE_FLASH_ATTR FontHasGlyph(Font *font, wchar ch);
+
+BOOL ICACHE_FLASH_ATTR FontCacheLookup(Font *font, wchar ch, uint8_t *buffer);
+
+void ICACHE_FLASH_ATTR FontCacheInsert(Font *font, wchar ch, const uint8_t *buffer);
+
+void ICACHE_FLASH_ATTR FontCacheClear(void);
+
+void ICACHE_FLASH_ATTR FontCacheNewFrame(void);
+
+void ICACHE_FLASH_ATTR FontCacheGetStats(FontCacheStats *stats);
+
 #endif
@@ -0,0 +1,66 @@
+/*
+ * text_layout.h
+ * @brief 文本排版，UTF8文本只在内容变化时解码、查询编码和断行，之后按字形列表重放绘制
+ * @note 断行规则: 英文单词不拆开，中文字符之间可断行，
+ *       闭合标点不出现在行首，开始标点不出现在行尾，超出区域时最后一行以省略号结尾
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#ifndef _TEXT_LAYOUT_H_
+#define _TEXT_LAYOUT_H_
+
+#include "c_types.h"
+#include "graphics/displayio.h"
+#include "graphics/font.h"
+
+// 最多字形数，整屏宽一行最多放31个8px宽的英文字形，16px字体共5行
+#define TEXT_LAYOUT_GLYPHS_MAX    155
+// 最多行数，受字形属性中行号位数限制
+#define TEXT_LAYOUT_LINES_MAX     64
+
+// 字形使用的字体
+#define TEXT_GLYPH_ENG            0
+#define TEXT_GLYPH_GB2312         1
+#define TEXT_GLYPH_UNICODE        2
+
+// 省略号 U+2026
+#define TEXT_ELLIPSIS             0x2026
+
+// 字形属性: 高2位为字体，低6位为行号
+#define TEXT_GLYPH_ATTR(font, line)    (((font) << 6) | ((line) & 0x3F))
+#define TEXT_GLYPH_FONT(glyph)         ((glyph)->attr >> 6)
+#define TEXT_GLYPH_LINE(glyph)         ((glyph)->attr & 0x3F)
+// 字形的屏幕纵坐标
+#define TEXT_GLYPH_Y(layout, glyph)    ((layout)->top + TEXT_GLYPH_LINE(glyph) * (layout)->lineHeight)
+
+/**
+ * @brief 排版后的字形，code为对应字体中的编码，x为屏幕坐标
+ * */
+typedef struct _text_glyph {
+	uint16_t code;
+	uint8_t x;
+	uint8_t attr;
+} TextGlyph;
+
+/**
+ * @brief 排版结果，key为文本、区域和字体参数的签名
+ * */
+typedef struct _text_layout {
+	uint32_t key;
+	uint16_t count;
+	uint8_t lines;
+	// 文本超出区域，最后一行以省略号结尾
+	uint8_t truncated;
+	// 第一行顶部和行高(含行间距)
+	uint8_t top;
+	uint8_t lineHeight;
+	TextGlyph glyphs[TEXT_LAYOUT_GLYPHS_MAX];
+} TextLayout;
+
+BOOL ICACHE_FLASH_ATTR TextLayoutUpdate(TextLayout *layout, uint8_t *text, const Rect *box,
+		Font *font, Font *engFont, uint8_t lineSpacing);
+
+void ICACHE_FLASH_ATTR TextLayoutDraw(const TextLayout *layout, Font *font, Font *engFont);
+
+#endif /* _TEXT_LAYOUT_H_ */
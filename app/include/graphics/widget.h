@@ -0,0 +1,110 @@
+/*
+ * widget.h
+ * @brief 保留模式控件层，控件绑定数据字段，只重绘数据变化的控件
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#ifndef _WIDGET_H_
+#define _WIDGET_H_
+
+#include "c_types.h"
+#include "graphics/displayio.h"
+#include "graphics/font.h"
+
+// 单个控件最多绑定的字段数
+#define WIDGET_BINDING_MAX     4
+// 单个控件树最多控件数，不超过脏标记位数32
+#define WIDGET_TREE_MAX        24
+// 控件格式化内容缓冲区大小(备忘录正文一节)
+#define WIDGET_CONTENT_SIZE    256
+
+// 控件类型标志，只随天气/日期数据变化的控件，整帧绘制时放入页面的静态图层缓存
+#define WIDGET_STATIC          0x80
+#define WIDGET_TYPE_MASK       0x7F
+
+// 绑定字段在数据结构中的偏移
+#define WIDGET_OFFSET(type, field)    ((uint16_t)((uint8_t *)&(((type *)0)->field) - (uint8_t *)0))
+// 绑定单个字段
+#define WIDGET_BIND(source, type, field)    {(source), sizeof(((type *)0)->field), WIDGET_OFFSET(type, field)}
+
+/**
+ * @brief 控件类型
+ * */
+typedef enum _widget_type {
+	// 格式化后的UTF8字符串，在区域左上角以font/engFont绘制
+	WIDGET_TEXT = 0,
+	// 格式化后的bmp文件名，在区域左上角绘制
+	WIDGET_ICON,
+	// 由draw回调自行绘制
+	WIDGET_BITMAP
+} WidgetType;
+
+/**
+ * @brief 控件绑定的数据源，WidgetTreeRender传入的sources按此顺序排列
+ * */
+typedef enum _widget_source {
+	WIDGET_SOURCE_CALENDAR = 0,
+	WIDGET_SOURCE_WEATHER,
+	WIDGET_SOURCE_STATUS,
+	WIDGET_SOURCE_FORECAST,
+	WIDGET_SOURCE_COUNT
+} WidgetSource;
+
+/**
+ * @brief 数据字段绑定，length为0表示未使用
+ * */
+typedef struct _widget_binding {
+	uint8_t source;
+	uint8_t length;
+	uint16_t offset;
+} WidgetBinding;
+
+struct _widget;
+typedef struct _widget Widget;
+
+/**
+ * @brief 生成控件内容(字符串或文件名)，内容参与变化比较
+ * */
+typedef void (* WidgetFormatCallback)(const Widget *widget, const void **sources, char *content);
+/**
+ * @brief 绘制WIDGET_BITMAP控件，绘制时已裁剪到控件区域
+ * */
+typedef void (* WidgetDrawCallback)(const Widget *widget, const void **sources, const char *content);
+
+struct _widget {
+	// 控件区域，重绘前以白色清除，绘制裁剪到该区域
+	Rect rect;
+	// WidgetType，可附加WIDGET_STATIC
+	uint8_t type;
+	// WIDGET_TEXT的中文/英文字体(FontType)
+	uint8_t font;
+	uint8_t engFont;
+	// 控件参数，供回调区分共用同一回调的控件
+	uint8_t param;
+	// 绑定的字段，字段内容变化时重绘
+	WidgetBinding bindings[WIDGET_BINDING_MAX];
+	// 可选，WIDGET_TEXT无format时绘制第一个绑定字段
+	WidgetFormatCallback format;
+	// WIDGET_BITMAP绘制回调
+	WidgetDrawCallback draw;
+};
+
+/**
+ * @brief 控件树，按数组顺序绘制，后面的控件叠放在前面的控件之上
+ * */
+typedef struct _widget_tree {
+	const Widget *widgets;
+	uint8_t count;
+	// signatures对应显存中的内容
+	uint8_t valid;
+	// 图层缓存页面序号(< GUI_LAYER_PAGES)，GUI_LAYER_NONE不缓存
+	uint8_t layer;
+	uint8_t reserved;
+	// 上一次绘制时各控件的绑定字段和内容签名
+	uint32_t signatures[WIDGET_TREE_MAX];
+} WidgetTree;
+
+uint8_t ICACHE_FLASH_ATTR WidgetTreeRender(WidgetTree *tree, const void **sources);
+
+#endif /* _WIDGET_H_ */
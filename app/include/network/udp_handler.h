@@ -21,11 +21,15 @@
 #include "driver/ssd1675b.h"
 #include "driver/dht11.h"
 
+#include "graphics/font.h"
+#include "graphics/displayio.h"
+
 #include "utils/sysconf.h"
 #include "utils/sparse_array.h"
 #include "utils/eventbus.h"
 #include "utils/eventdef.h"
 #include "utils/rtc_mem.h"
+#include "utils/strings.h"
 
 //#define UDP_HANDLER_DEBUG
 
@@ -69,7 +73,8 @@ typedef enum _package_type{
 	SensorReadPackage = 0x21,
 	DateReadPackage = 0x22,
 	DeviceInfoReadPackage = 0x23,
-	FreezeFramePackage = 0x24
+	FreezeFramePackage = 0x24,
+	EpdTimingReadPackage = 0x25
 } PackageType;
 
 typedef enum _file_op_status {
@@ -175,6 +180,7 @@ typedef enum _file_op_status {
 #define DISPLAY_PACKAGE_LENGTH            (1464)
 #define DISPLAY_PACKAGE_ID_MAX            (2)
 #define DISPLAY_PACKAGE_ID_OUTOF_RANGE    (0x01)
+#define DISPLAY_BUFFER_UNAVAILABLE        (0x02)
 
 // @interface freezeFrame
 #define FREEZE_PACKAGE_CRC_ERROR                (0x1)
@@ -184,6 +190,10 @@ typedef enum _file_op_status {
 
 // @interface deviceInfoRead
 
+// @interface epdTimingRead
+// 每条记录: reset, init, flush, refresh, finish, sleep(uint32_t), type, result(uint8_t), bytes(uint16_t)
+#define EPD_TIMING_RECORD_SIZE    (28)
+
 #define UDP_TIMER_EVENT_REBOOT       100
 #define UDP_TIMER_EVENT_NETUPDATE    101
 #define UDP_TIMER_EVENT_FREEZE       102
@@ -82,6 +82,20 @@ typedef struct _file {
     uint32_t length; // 文件大小
 } File;
 
+/**
+ * @brief 顺序读取器，保存当前簇位置，按块缓存读取，避免每次读取重复遍历簇链
+ */
+typedef struct _file_reader {
+    File *file;
+    uint8_t *buffer;       // 块缓存，由调用者提供，大小4字节对齐
+    uint32_t capacity;    // 块缓存大小(字节)
+    uint32_t cluster;    // 当前簇物理地址
+    uint32_t clusterStart; // 当前簇第一个字节对应的文件偏移
+    uint32_t chunkStart;  // 块缓存中数据对应的文件偏移
+    uint32_t chunkLength; // 块缓存中有效数据长度
+    uint32_t position;   // 当前读取位置
+} FileReader;
+
 /**
  * @brief 文件操作结果码
  */
@@ -207,6 +221,12 @@ Result ICACHE_FLASH_ATTR write_finish(File *file);
 
 uint32_t ICACHE_FLASH_ATTR read_file(File *file, uint32_t offset, uint8_t *buffer, uint32_t size);
 
+BOOL ICACHE_FLASH_ATTR open_reader(FileReader *reader, File *file, uint8_t *buffer, uint32_t capacity);
+
+void ICACHE_FLASH_ATTR seek_reader(FileReader *reader, uint32_t position);
+
+uint32_t ICACHE_FLASH_ATTR read_reader(FileReader *reader, uint8_t *buffer, uint32_t length);
+
 BOOL ICACHE_FLASH_ATTR open_file(File *file, char *filename, char *extname);
 
 BOOL ICACHE_FLASH_ATTR open_file_raw(File *file, uint8_t *filename, uint8_t *extname);
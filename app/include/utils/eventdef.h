@@ -20,6 +20,7 @@
 #define POWERTOGGLE_SHUTDOWN         0     // 电源切换-关机
 #define POWERTOGGLE_UPDATE           1     // 电源切换-更新固件
 #define POWERTOGGLE_IDLE_TIMEOUT     2     // 电源切换-空闲超时
+#define MAIN_EVENT_EPD_FLUSHED       205   // 显存已写入控制器，可以开始刷新
 
 #define BASIC_CTRL_EVENT_UPDATE         300
 // arg参数
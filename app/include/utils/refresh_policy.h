@@ -0,0 +1,62 @@
+/*
+ * refresh_policy.h
+ * @brief 全局/局部刷新决策，按残影预算决定本次刷新使用的波形
+ * @note 不依赖SDK接口，状态(RefreshBudget)由调用者保存在RTC内存中
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#ifndef _UTILS_REFRESH_POLICY_H_
+#define _UTILS_REFRESH_POLICY_H_
+
+#include "c_types.h"
+
+// 连续局部刷新次数上限N，达到后强制一次全局刷新
+#define REFRESH_PARTIAL_MAX        8
+// 残影预算，累计代价超过后强制全局刷新
+#define REFRESH_GHOSTING_BUDGET    100
+// 局部刷新可用的面板温度范围(摄氏度)，范围外波形不可靠
+#define REFRESH_TEMP_MIN           0
+#define REFRESH_TEMP_MAX           50
+// 低于此温度粒子运动变慢，局部刷新残影代价加倍
+#define REFRESH_TEMP_COLD          10
+// 温度未知时使用的值，与EPD_TEMPERATURE_INVALID一致
+#define REFRESH_TEMP_UNKNOWN       (-128)
+
+// 非天气页面(开机/配置/提示/自定义图片)
+#define REFRESH_PAGE_IMAGE         0xFF
+
+typedef enum _refresh_type {
+	REFRESH_FULL = 0,
+	REFRESH_PARTIAL
+} RefreshType;
+
+// 保存在RTC内存中的刷新状态 4bytes
+typedef struct _refresh_budget {
+	// 自上次全局刷新以来累计的残影代价
+	uint8_t ghosting;
+	// 自上次全局刷新以来的局部刷新次数
+	uint8_t partials;
+	// 上一次刷新的页面
+	uint8_t page;
+	uint8_t dummy;
+} RefreshBudget;
+
+typedef struct _refresh_request {
+	// 控制器RAM保存着上一帧，可以局部刷新
+	BOOL canPartial;
+	// 当前页面id，REFRESH_PAGE_IMAGE为非天气页面
+	uint8_t page;
+	// 页面类型的残影权重，每次局部刷新的基础代价
+	uint8_t weight;
+	// 面板温度(摄氏度)，REFRESH_TEMP_UNKNOWN表示未知
+	sint8_t temperature;
+	// 变化区域面积(像素)
+	uint32_t dirtyArea;
+} RefreshRequest;
+
+RefreshType ICACHE_FLASH_ATTR RefreshPolicyDecide(RefreshBudget *budget, const RefreshRequest *request);
+
+void ICACHE_FLASH_ATTR RefreshPolicyReset(RefreshBudget *budget);
+
+#endif /* _UTILS_REFRESH_POLICY_H_ */
@@ -134,8 +134,14 @@ typedef struct _night_span {
 // 系统空闲计数
 #define IDLE_TICK_POS            81
 
+// 当前屏幕显示内容的帧哈希，与CURRENT_PAGE_POS配合，0表示屏幕内容未知
+#define FRAME_HASH_POS           82
+
+// 局部刷新残影预算RefreshBudget结构 4bytes
+#define REFRESH_BUDGET_POS       83
+
 // must update
 #define RTCMEM_START       64
-#define RTCMEM_END         81
+#define RTCMEM_END         83
 
 #endif /* APP_USER_RTC_MEM_H_ */
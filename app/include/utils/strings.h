@@ -16,10 +16,18 @@
 #define KMP_SUB_MAX_LENGTH    18
 #define PARSE_ERROR    0
 
+// utf16.lut采样索引，每UTF16_INDEX_STRIDE组记录一次首个unicode，最大支持8192组(GB2312共7445字符)
+#define UTF16_INDEX_STRIDE    32
+#define UTF16_INDEX_SIZE      256
+// 最近转换字符缓存，直接映射，必须为2的幂
+#define UTF16_MEMO_SIZE       16
+
 typedef uint8_t byte;
 
 Short ICACHE_FLASH_ATTR QueryGB2312ByUnicode(uint16_t unicode);
 
+void ICACHE_FLASH_ATTR InvalidateGB2312Query(uint8_t *filename);
+
 uint8_t * ICACHE_FLASH_ATTR UnicodeToGB2312(uint8_t *unicode);
 
 uint8_t ICACHE_FLASH_ATTR UTF8ToUnicode(uint8_t *utf8, uint32_t *unicode);
@@ -54,6 +54,7 @@ static ICACHE_FLASH_ATTR void displayBufferRead(struct espconn *espc, uint8_t *d
 static ICACHE_FLASH_ATTR void sensorRead(struct espconn *espc, uint8_t *data, uint32_t length);
 static ICACHE_FLASH_ATTR void deviceInfoRead(struct espconn *espc, uint8_t *data, uint32_t length);
 static ICACHE_FLASH_ATTR void freezeFrame(struct espconn *espc, uint8_t *data, uint32_t length);
+static ICACHE_FLASH_ATTR void epdTimingRead(struct espconn *espc, uint8_t *data, uint32_t length);
 
 void ICACHE_FLASH_ATTR handlerInit() {
 	if(buffer == NULL) {
@@ -95,6 +96,7 @@ void ICACHE_FLASH_ATTR handlerInit() {
 	sparseArray->put(sparseArray, (size_t)SensorReadPackage, (size_t)sensorRead);
 	sparseArray->put(sparseArray, (size_t)DeviceInfoReadPackage, (size_t)deviceInfoRead);
 	sparseArray->put(sparseArray, (size_t)FreezeFramePackage, (size_t)freezeFrame);
+	sparseArray->put(sparseArray, (size_t)EpdTimingReadPackage, (size_t)epdTimingRead);
 }
 
 void ICACHE_FLASH_ATTR handlerDelete() {
@@ -636,6 +638,9 @@ static ICACHE_FLASH_ATTR void onFileUpInfoRequest(struct espconn *espc, uint8_t
 	os_memcpy(currentFile.extname, (data + 9), EXTNAME_SIZE);
 	os_memcpy(&finfo, (data + 17), sizeof(FileInfo));
 	os_memcpy(&method, (data + 25), sizeof(uint8_t));
+	// 文件内容即将变更，失效同名字体和查找表的常驻句柄
+	FontInvalidateFile(currentFile.filename);
+	InvalidateGB2312Query(currentFile.filename);
 	// 根据写入方式处理，默认FILE_METHOD_NORMAL
 	if(FILE_METHOD_OVERRIDE == method) {
 		if(open_file_raw(&currentFile, currentFile.filename, currentFile.extname)) {
@@ -712,6 +717,10 @@ static ICACHE_FLASH_ATTR void onFileUpDataRequest(struct espconn *espc, uint8_t
 	if(currentFile.length >= totalSize) {
 		result = write_finish(&currentFile);
 		buffer[1] = (result == APPEND_FILE_FINISH) ? FILE_WRITTEN_ACK : result;
+		FontInvalidateFile(currentFile.filename);
+		InvalidateGB2312Query(currentFile.filename);
+		// 图片可能已更换，下一帧整帧重绘
+		GuiInvalidateFrame();
 		// 重置状态机
 		fileOpState = FILE_OP_INIT;
 	}
@@ -849,6 +858,13 @@ static ICACHE_FLASH_ATTR void onFileRenameRequest(struct espconn *espc, uint8_t
 			read_finfo(&currentFile, &finfo);
 			result = rename_file_raw(&currentFile, newfilename, newextname);
 			buffer[1] = (FILE_RENAME_SUCCESS == result) ? UDP_RESULT_SUCCESS : RENAME_NO_PERMISSION;
+			if(FILE_RENAME_SUCCESS == result) {
+				FontInvalidateFile(data + 1);
+				InvalidateGB2312Query(data + 1);
+				FontInvalidateFile(newfilename);
+				InvalidateGB2312Query(newfilename);
+				GuiInvalidateFrame();
+			}
 		}else {
 			buffer[1] = RENAME_FILE_NOT_EXIST;
 		}
@@ -902,6 +918,9 @@ static ICACHE_FLASH_ATTR void onFileDeleteRequest(struct espconn *espc, uint8_t
 			return;
 		}
 		delete_file(&currentFile);
+		FontInvalidateFile(filename);
+		InvalidateGB2312Query(filename);
+		GuiInvalidateFrame();
 		buffer[1] = DELETE_SUCCESS;
 		espconn_send(espc, buffer, 2);
 		return;
@@ -1004,6 +1023,10 @@ static ICACHE_FLASH_ATTR void onFsFormatRequest(struct espconn *espc, uint8_t *d
 			temp = spifs_erase_sector(sectorStart);
 		}
 		buffer[1] = (temp) ? UDP_RESULT_SUCCESS : FS_FORMAT_OUTOF_RANGE;
+		// 擦除后全部字体和查找表句柄失效
+		FontInvalidateFile(NULL);
+		InvalidateGB2312Query(NULL);
+		GuiInvalidateFrame();
 	}
 
 	espconn_send(espc, buffer, 2);
@@ -1070,6 +1093,12 @@ static ICACHE_FLASH_ATTR void displayBufferRead(struct espconn *espc, uint8_t *d
 		espconn_send(espc, buffer, 2);
 		return;
 	}
+#ifdef EPD_BANDED_RENDER
+	// 分带渲染没有整帧显存
+	buffer[1] = DISPLAY_BUFFER_UNAVAILABLE;
+	espconn_send(espc, buffer, 2);
+	return;
+#endif
 
 	displayBuffer = EPDGetDisplayRAM();
 	buffer[1] = UDP_RESULT_SUCCESS;
@@ -1135,6 +1164,34 @@ static ICACHE_FLASH_ATTR void deviceInfoRead(struct espconn *espc, uint8_t *data
 	espconn_send(espc, buffer, len);
 }
 
+/**
+ * @brief 读取最近的EPD刷新计时记录
+ * @note 返回: type, result, count, recordSize, 记录数据(从旧到新)
+ * */
+static ICACHE_FLASH_ATTR void epdTimingRead(struct espconn *espc, uint8_t *data, uint32_t length) {
+	uint32_t usertoken;
+	EPDTiming records[EPD_TIMING_RECORDS];
+	uint8_t count, i;
+
+	os_memcpy(&usertoken, (data + 1), sizeof(uint32_t));
+	buffer[0] = (uint8_t)EpdTimingReadPackage;
+
+	if(checkTokenAlive(usertoken) != OK) {
+		buffer[1] = TOKEN_NOT_EXIST;
+		espconn_send(espc, buffer, 2);
+		return;
+	}
+
+	count = EPDGetTimings(records, EPD_TIMING_RECORDS);
+	buffer[1] = UDP_RESULT_SUCCESS;
+	buffer[2] = count;
+	buffer[3] = EPD_TIMING_RECORD_SIZE;
+	for(i = 0; i < count; i++) {
+		os_memcpy((buffer + 4 + i * EPD_TIMING_RECORD_SIZE), (records + i), EPD_TIMING_RECORD_SIZE);
+	}
+	espconn_send(espc, buffer, (4 + count * EPD_TIMING_RECORD_SIZE));
+}
+
 static ICACHE_FLASH_ATTR void freezeFrame(struct espconn *espc, uint8_t *data, uint32_t length) {
 	uint32_t usertoken;
 	uint16_t crc;
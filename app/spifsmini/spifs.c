@@ -301,7 +301,7 @@ static void align_write_impl(uint8_t *buffer, uint32_t offset, uint32_t write_ad
     uint32_t data_align, temp, towrite;
 
 	// (buffer + offset)对齐处理，判断写入地址是否在平台指针边界
-    addr_align = ((size_t)(buffer + offset)) & (sizeof(size_t) - 1);
+    addr_align = ((size_t)((buffer + offset) - (uint8_t *)0)) & (sizeof(size_t) - 1);
 	if(addr_align != 0) {
 		// 当前(buffer + offset)不对齐，写出不对齐部分，随后(buffer + offset)对齐到4字节边界
 		temp = EMPTY_INT_VALUE;
@@ -431,6 +431,87 @@ uint32_t ICACHE_FLASH_ATTR read_file(File *file, uint32_t offset, uint8_t *buffe
     return i;
 }
 
+/**
+ * @brief 创建顺序读取器，仅在创建时检查一次文件权限
+ * @param *reader 读取器
+ * @param *file 已打开的文件
+ * @param *buffer 块缓存，取DATA_AREA_SIZE时每次读取一整簇
+ * @param capacity 块缓存大小(字节)，需要4字节对齐
+ * @return TRUE:创建成功, FALSE:文件无效或不可读
+ * */
+BOOL ICACHE_FLASH_ATTR open_reader(FileReader *reader, File *file, uint8_t *buffer, uint32_t capacity) {
+    FileInfo finfo;
+#ifdef SPIFS_USE_NULL_CHECK
+    if(reader == NULL || buffer == NULL || file == NULL || (file->block & file->cluster & file->length) == EMPTY_INT_VALUE) {
+        return FALSE;
+    }
+#endif
+    read_finfo(file, &finfo);
+    if(!(finfo.state.del & finfo.state.dep) || capacity < sizeof(uint32_t)) {
+        return FALSE;
+    }
+    reader->file = file;
+    reader->buffer = buffer;
+    reader->capacity = (capacity & ~(sizeof(uint32_t) - 1));
+    reader->cluster = file->cluster;
+    reader->clusterStart = 0;
+    reader->chunkStart = 0;
+    reader->chunkLength = 0;
+    reader->position = 0;
+    return TRUE;
+}
+
+/**
+ * @brief 设置读取位置，向后移动时从当前簇继续遍历簇链
+ * */
+void ICACHE_FLASH_ATTR seek_reader(FileReader *reader, uint32_t position) {
+    reader->position = position;
+}
+
+/**
+ * @brief 从当前位置顺序读取，块缓存未命中时读取位置所在的对齐块
+ * @param *reader 读取器
+ * @param *buffer 存储数据缓冲区，无对齐要求
+ * @param length 读出字节数
+ * @return 实际读取的大小(bytes)，到达文件末尾时小于length
+ * */
+uint32_t ICACHE_FLASH_ATTR read_reader(FileReader *reader, uint8_t *buffer, uint32_t length) {
+    uint32_t cursor = 0, offset, toread, temp;
+    File *file = reader->file;
+
+    while(length > 0 && reader->position < file->length) {
+        if(reader->position < reader->chunkStart || reader->position >= (reader->chunkStart + reader->chunkLength)) {
+            // 位置在当前簇之前时从首簇重新遍历
+            if(reader->position < reader->clusterStart) {
+                reader->cluster = file->cluster;
+                reader->clusterStart = 0;
+            }
+            while(reader->position >= (reader->clusterStart + DATA_AREA_SIZE)) {
+                spi_flash_read((reader->cluster + SECTOR_MARK_SIZE + DATA_AREA_SIZE), &temp, sizeof(uint32_t));
+                reader->cluster = temp;
+                reader->clusterStart += DATA_AREA_SIZE;
+            }
+            // 块在簇内按capacity对齐，不跨簇，不超出文件末尾
+            offset = (reader->position - reader->clusterStart);
+            offset -= (offset % reader->capacity);
+            reader->chunkStart = (reader->clusterStart + offset);
+            toread = (DATA_AREA_SIZE - offset);
+            toread = (toread > reader->capacity) ? reader->capacity : toread;
+            toread = ((file->length - reader->chunkStart) < toread) ? (file->length - reader->chunkStart) : toread;
+            align_read_impl(reader->buffer, 0, (reader->cluster + SECTOR_MARK_SIZE + offset), toread);
+            reader->chunkLength = toread;
+        }
+        offset = (reader->position - reader->chunkStart);
+        toread = (reader->chunkLength - offset);
+        toread = (toread > length) ? length : toread;
+        os_memcpy((buffer + cursor), (reader->buffer + offset), toread);
+        cursor += toread;
+        length -= toread;
+        reader->position += toread;
+    }
+    return cursor;
+}
+
 /**
  * @param *buffer 可由malloc或者静态分配
  * @param offset buffer中的写入偏移量(读取->写入buffer)
@@ -442,7 +523,7 @@ static void align_read_impl(uint8_t *buffer, uint32_t offset, uint32_t read_addr
     size_t addr_align;
 
 	// (buffer + offset)对齐处理，判断读入缓存地址是否在平台指针边界
-	addr_align = ((size_t)(buffer + offset)) & (sizeof(size_t) - 1);
+	addr_align = ((size_t)((buffer + offset) - (uint8_t *)0)) & (sizeof(size_t) - 1);
 
 	if(addr_align != 0) {
 		// 当前(buffer + offset)不对齐，读取不对齐部分填充，随后(buffer + offset)对齐到4字节边界
@@ -33,6 +33,7 @@
 #include "utils/hardware.h"
 #include "utils/misc.h"
 #include "utils/fixed_file.h"
+#include "utils/refresh_policy.h"
 
 #include "model/basic_weather.h"
 #include "model/forecast_weather.h"
@@ -70,6 +71,19 @@ enum {
 	DisplayGallery,
 };
 
+#ifndef EPD_BANDED_RENDER
+// 各页面局部刷新的残影权重，下标对应DisplayNone(无网络页面)...DisplayGallery
+static const uint8_t PageGhostWeight[] = {10, 6, 6, 8, 25};
+// 图片类页面的残影权重，整屏变化时超出预算直接全局刷新
+#define IMAGE_GHOST_WEIGHT    40
+#endif
+// 当前帧对应的页面，由render回调记录
+static uint8_t renderPage = REFRESH_PAGE_IMAGE;
+// 正在刷新的帧哈希，刷新正常完成后才写入FRAME_HASH_POS
+static uint32_t refreshingHash = 0;
+// EPD更新期间收到的送显请求，刷新完成后重新提交
+static BOOL updateDeferred = FALSE;
+
 #define EAGLE_FLASH_BIN_ADDR				      (SYSTEM_PARTITION_CUSTOMER_BEGIN + 1)
 #define EAGLE_IROM0TEXT_BIN_ADDR			      (SYSTEM_PARTITION_CUSTOMER_BEGIN + 2)
 #define SYSTEM_PARTITION_RF_CAL_ADDR              (0x3FB000)
@@ -107,6 +121,14 @@ void ICACHE_FLASH_ATTR lightSleepWakeupCallback(void);
 static void ICACHE_FLASH_ATTR requestInternetUpdate(void);
 static void ICACHE_FLASH_ATTR invalidateView(void);
 
+static void ICACHE_FLASH_ATTR renderView(uint32_t arg);
+static void ICACHE_FLASH_ATTR renderPackedImage(uint32_t arg);
+static void ICACHE_FLASH_ATTR renderBmpImage(uint32_t arg);
+static void ICACHE_FLASH_ATTR renderNightSpan(uint32_t arg);
+static void ICACHE_FLASH_ATTR renderCustomImage(uint32_t arg);
+
+static sint8_t ICACHE_FLASH_ATTR readPanelTemperature(void);
+
 static struct espconn udp_espconn;
 static void ICACHE_FLASH_ATTR udp_server_setup(uint8 if_index);
 static void ICACHE_FLASH_ATTR udp_recv_callback(void *arg, char *pdata, unsigned short len);
@@ -115,6 +137,7 @@ static void ICACHE_FLASH_ATTR wifi_mode_setup(SystemConfig *cfg);
 
 static void ICACHE_FLASH_ATTR requestFinishedHandler(uint32_t eventId, uint32_t arg);
 static void ICACHE_FLASH_ATTR epdFinishedHandler(uint32_t eventId, uint32_t arg);
+static void ICACHE_FLASH_ATTR epdFlushedHandler(uint32_t eventId, uint32_t arg);
 static void ICACHE_FLASH_ATTR displayImageHandler(uint32_t eventId, uint32_t arg);
 static void ICACHE_FLASH_ATTR closeTimerHandler(uint32_t eventId, uint32_t arg);
 static void ICACHE_FLASH_ATTR powerToggleHandler(uint32_t eventId, uint32_t arg);
@@ -245,7 +268,6 @@ void ICACHE_FLASH_ATTR lightSleepWakeupCallback(void) {
 	UpdateInfo info;
 	PowerMode powermode;
 	NightSpan nightSpan;
-	Font *eng16px;
 	uint32_t seconds, level;
 
 	wifi_fpm_close();
@@ -275,16 +297,7 @@ void ICACHE_FLASH_ATTR lightSleepWakeupCallback(void) {
 		}else {
 			nightSpan.isEntered = 1;
 			system_rtc_mem_write(NIGHT_SPAN_POS, (const void *)&nightSpan, sizeof(NightSpan));
-			// 绘制背景图
-			GuiDrawBmpImage("stopmode", "bmp", 0, 0);
-			// 图片上绘制时间信息
-			eng16px = getFont(FONT08x16_EN);
-			// 开始时间
-			GuiDrawChar(('0' + nightSpan.start / 10), 120, 57, BLACK, WHITE, eng16px, 16);
-			GuiDrawChar(('0' + nightSpan.start % 10), 129, 57, BLACK, WHITE, eng16px, 16);
-			// 结束时间
-			GuiDrawChar(('0' + nightSpan.end / 10), 162, 57, BLACK, WHITE, eng16px, 16);
-			GuiDrawChar(('0' + nightSpan.end % 10), 171, 57, BLACK, WHITE, eng16px, 16);
+			GuiRender(renderNightSpan, ((nightSpan.start << 8) | nightSpan.end));
 			postEventDelay(EVENT_UPDATE_EPD, 100);
 		}
 		return;
@@ -383,6 +396,7 @@ void ICACHE_FLASH_ATTR user_init(void) {
 	EventBusGetDefault()->regist(displayImageHandler, MAIN_EVENT_DISPLAY_IMAGE);
 	EventBusGetDefault()->regist(requestFinishedHandler, MAIN_EVENT_REQUEST_FINISH);
 	EventBusGetDefault()->regist(epdFinishedHandler, MAIN_EVENT_EPD_FINISH);
+	EventBusGetDefault()->regist(epdFlushedHandler, MAIN_EVENT_EPD_FLUSHED);
 	EventBusGetDefault()->regist(closeTimerHandler, MAIN_EVENT_CLOSE_TIMER);
 	EventBusGetDefault()->regist(powerToggleHandler, MAIN_EVENT_POWERTOGGLE);
 	// 控制器初始化也仅是注册事件回调
@@ -418,7 +432,7 @@ static void ICACHE_FLASH_ATTR wifi_mode_setup(SystemConfig *cfg) {
 		wifi_set_opmode(SOFTAP_MODE);
 		softap_info_setup(DEFAULT_SOFTAP_SSID, DEFAULT_SOFTAP_PASS);
 		// 工程模式top
-		GuiDrawImagePacked(factory_image, 0, 0);
+		GuiRender(renderPackedImage, (uint32_t)factory_image);
 
 		postEventDelay(EVENT_UPDATE_EPD, 100);
 		os_timer_arm(&idleTimer, 60000, TRUE);
@@ -431,7 +445,7 @@ static void ICACHE_FLASH_ATTR wifi_mode_setup(SystemConfig *cfg) {
 		tempVar = POWER_BY_RESET_SET;
 		system_rtc_mem_write(POWER_ON_REASON_POS, (const void *)&tempVar, sizeof(uint32_t));
 		// 显示开机图片
-		GuiDrawBmpImage("connect", "bmp", 0, 0);
+		GuiRender(renderBmpImage, (uint32_t)"connect");
 		postEventDelay(EVENT_UPDATE_EPD, 100);
 		// 在epdFinishedHandler中连接wifi
 
@@ -441,10 +455,10 @@ static void ICACHE_FLASH_ATTR wifi_mode_setup(SystemConfig *cfg) {
 		softap_info_setup(DEFAULT_SOFTAP_SSID, DEFAULT_SOFTAP_PASS);
 
 		if(cfg->status.hasResource == STATUS_VALID) {
-			GuiDrawBmpImage("splash", "bmp", 0, 0);
+			GuiRender(renderBmpImage, (uint32_t)"splash");
 		}else {
 			// 未配置,且不含资源文件
-			GuiDrawImagePacked(factory_image, 0, 0);
+			GuiRender(renderPackedImage, (uint32_t)factory_image);
 		}
 		postEventDelay(EVENT_UPDATE_EPD, 100);
 		os_timer_arm(&idleTimer, 60000, TRUE);
@@ -609,7 +623,7 @@ static void ICACHE_FLASH_ATTR wifi_event_callback(System_Event_t *evt) {
 					os_timer_arm(&idleTimer, 60000, TRUE);
 					wifi_set_opmode(SOFTAP_MODE);
 					softap_info_setup(DEFAULT_SOFTAP_SSID, DEFAULT_SOFTAP_PASS);
-					GuiDrawBmpImage("nowifi", "bmp", 0, 0);
+					GuiRender(renderBmpImage, (uint32_t)"nowifi");
 					postEventDelay(EVENT_UPDATE_EPD, 50);
 				}
 
@@ -657,18 +671,14 @@ static void ICACHE_FLASH_ATTR requestInternetUpdate(void) {
 static void ICACHE_FLASH_ATTR invalidateView(void) {
 	// in context
 	TempHumEntity *temphum;
-	Calendar *calendar;
 	BasicWeather *weather;
 	StatusBar *status;
-	ForecastWeather *forecastWeather;
 	// in rtc men
 	uint32_t dpid, position;
 	PowerMode powermode;
 
 	status = Context.getStatusBar();
-	calendar = Context.getCalendar();
 	weather = Context.getBasicWeather();
-	forecastWeather = Context.getForecastWeathers();
 /*
  * data  : 0x3ffe8000 ~ 0x3ffe894c, len: 2380
 rodata: 0x3ffe8950 ~ 0x3ffebf4c, len: 13820
@@ -695,37 +705,109 @@ free_heap_size:21976
 	status->syspowermode = powermode.type;
 	// 刷新页面
 	if(weather->weatherIcon < 0) {
-		// weather->weatherIcon为负数表示网页解析失败
-		invalidateNoInternet(calendar, status);
+		// weather->weatherIcon为负数表示网页解析失败, DisplayNone对应无网络页面
+		GuiRender(renderView, DisplayNone);
 	}else {
 		// 交替显示
 		if(ViewPages[position] == DisplayNone) {
 			position = 0;
 		}
 		dpid = ViewPages[position];
-
-		switch(dpid) {
-			case DisplayBasic:
-				invalidateBasic(calendar, weather, status);
-				break;
-			case DisplayForecast:
-				invalidateForecast(calendar, weather, forecastWeather, status);
-				break;
-			case DisplayNote:
-				invalidateNoteView(calendar, weather, status);
-				break;
-			case DisplayGallery:
-				invalidateGalleryView();
-				break;
-			default:
-				break;
-		}
+		GuiRender(renderView, dpid);
 		position = (position < (VIEW_PAGE_MAX - 1)) ? (position + 1) : 0;
 		// 回写当前页面标记
 		system_rtc_mem_write(CURRENT_PAGE_POS, (const void *)&position, sizeof(uint32_t));
 	}
 }
 
+/**
+ * @brief 绘制页面，数据收集在invalidateView中完成，此处只做绘制，分带渲染时会被重复调用
+ * @param arg 页面id, DisplayNone为无网络页面
+ * */
+static void ICACHE_FLASH_ATTR renderView(uint32_t arg) {
+	Calendar *calendar;
+	BasicWeather *weather;
+	StatusBar *status;
+
+	status = Context.getStatusBar();
+	calendar = Context.getCalendar();
+	weather = Context.getBasicWeather();
+	renderPage = arg;
+
+	switch(arg) {
+		case DisplayNone:
+			invalidateNoInternet(calendar, status);
+			break;
+		case DisplayBasic:
+			invalidateBasic(calendar, weather, status);
+			break;
+		case DisplayForecast:
+			invalidateForecast(calendar, weather, Context.getForecastWeathers(), status);
+			break;
+		case DisplayNote:
+			invalidateNoteView(calendar, weather, status);
+			break;
+		case DisplayGallery:
+			invalidateGalleryView();
+			break;
+		default:
+			break;
+	}
+}
+
+/**
+ * @brief 绘制全屏内置图片
+ * @param arg 压缩图片数据指针
+ * */
+static void ICACHE_FLASH_ATTR renderPackedImage(uint32_t arg) {
+	renderPage = REFRESH_PAGE_IMAGE;
+	EPDDisplayClear();
+	GuiDrawImagePacked((const uint8_t *)arg, 0, 0);
+}
+
+/**
+ * @brief 绘制全屏bmp图片
+ * @param arg 文件名指针(扩展名固定为bmp)
+ * */
+static void ICACHE_FLASH_ATTR renderBmpImage(uint32_t arg) {
+	renderPage = REFRESH_PAGE_IMAGE;
+	GuiDrawBmpImage((char *)arg, "bmp", 0, 0);
+}
+
+/**
+ * @brief 绘制夜间不更新提示页面
+ * @param arg 高8bit开始时间，低8bit结束时间
+ * */
+static void ICACHE_FLASH_ATTR renderNightSpan(uint32_t arg) {
+	Font *eng16px;
+	uint8_t start = ((arg >> 8) & 0xFF);
+	uint8_t end = (arg & 0xFF);
+	renderPage = REFRESH_PAGE_IMAGE;
+	// 绘制背景图
+	GuiDrawBmpImage("stopmode", "bmp", 0, 0);
+	// 图片上绘制时间信息
+	eng16px = getFont(FONT08x16_EN);
+	// 开始时间
+	GuiDrawChar(('0' + start / 10), 120, 57, BLACK, WHITE, eng16px, 16);
+	GuiDrawChar(('0' + start % 10), 129, 57, BLACK, WHITE, eng16px, 16);
+	// 结束时间
+	GuiDrawChar(('0' + end / 10), 162, 57, BLACK, WHITE, eng16px, 16);
+	GuiDrawChar(('0' + end % 10), 171, 57, BLACK, WHITE, eng16px, 16);
+}
+
+// displayImageHandler设置的自定义图片
+static File customImage;
+
+/**
+ * @brief 绘制自定义图片
+ * @param arg 高16bit left，低16bit top
+ * */
+static void ICACHE_FLASH_ATTR renderCustomImage(uint32_t arg) {
+	renderPage = REFRESH_PAGE_IMAGE;
+	EPDDisplayClear();
+	GuiDrawBmpImageImpl(&customImage, ((arg >> 16) & 0xFFFF), (arg & 0xFFFF));
+}
+
 /**
  * @brief request请求队列完成回调
  * */
@@ -764,6 +846,32 @@ static void ICACHE_FLASH_ATTR epdFinishedHandler(uint32_t eventId, uint32_t arg)
 	PowerMode powermode;
 	SystemConfig *config = NULL;
 	uint32_t bootFlag;
+	uint32_t frameHash = 0;
+	RefreshBudget budget;
+
+	if(arg == EPD_FINISH_OK) {
+		// 屏幕上已是该帧，跳过相同帧时refreshingHash为0
+		if(refreshingHash != 0) {
+			system_rtc_mem_write(FRAME_HASH_POS, (const void *)&refreshingHash, sizeof(uint32_t));
+			refreshingHash = 0;
+		}
+	}else {
+		// 刷新失败或超时，屏幕内容未知，下一帧不能跳过且需要全局刷新
+		refreshingHash = 0;
+		system_rtc_mem_write(FRAME_HASH_POS, (const void *)&frameHash, sizeof(uint32_t));
+		RefreshPolicyReset(&budget);
+		system_rtc_mem_write(REFRESH_BUDGET_POS, (const void *)&budget, sizeof(RefreshBudget));
+	}
+
+	// 刷新期间推迟的绘制和送显请求，送显完成后再进行电源状态切换
+	if(GuiRenderDeferred()) {
+		updateDeferred = TRUE;
+	}
+	if(updateDeferred) {
+		updateDeferred = FALSE;
+		postEventDelay(EVENT_UPDATE_EPD, 100);
+		return;
+	}
 
 	// 由reset启动显示图片完成后再联网
 	system_rtc_mem_read(POWER_ON_REASON_POS, (void *)&bootFlag, sizeof(uint32_t));
@@ -818,13 +926,24 @@ static void ICACHE_FLASH_ATTR epdFinishedHandler(uint32_t eventId, uint32_t arg)
 	}
 }
 
+/**
+ * @brief 显存写入控制器完成回调，开始刷新屏幕
+ * @param eventId 事件ID(固定值和mainEventHandler绑定)
+ * @param arg 未使用
+ * */
+static void ICACHE_FLASH_ATTR epdFlushedHandler(uint32_t eventId, uint32_t arg) {
+	if(EPDTurnOnDisplay() != OK) {
+		EventBusGetDefault()->post(MAIN_EVENT_EPD_FINISH, EPD_FINISH_ERROR);
+	}
+}
+
 /**
  * @brief 显示自定义图片回调
  * @param eventId 事件ID(固定值和mainEventHandler绑定)
  * @param arg 附加的整形参数
  * */
 static void ICACHE_FLASH_ATTR displayImageHandler(uint32_t eventId, uint32_t arg) {
-	File file;
+	File *file = &customImage;
 	uint8_t fileblock[FILENAME_FULLSIZE];
 	uint32_t width, height, top, left;
 	PowerMode powermode;
@@ -836,9 +955,9 @@ static void ICACHE_FLASH_ATTR displayImageHandler(uint32_t eventId, uint32_t arg
 	}
 	// arg传递的为File.block
 	spi_flash_read(arg, (uint32_t *)fileblock, FILENAME_FULLSIZE);
-	open_file_raw(&file, fileblock, fileblock + 8);
+	open_file_raw(file, fileblock, fileblock + 8);
 	// 二次检查bmp文件格式，并获取宽/高信息
-	if(GuiCheckBMPFormat(&file, &width, &height, NULL) != 0) {
+	if(GuiCheckBMPFormat(file, &width, &height, NULL) != 0) {
 		return;
 	}
 
@@ -866,8 +985,7 @@ static void ICACHE_FLASH_ATTR displayImageHandler(uint32_t eventId, uint32_t arg
 		top = (SCREEN_HEIGHT - height);
 	}
 
-	EPDDisplayClear();
-	GuiDrawBmpImageImpl(&file, left, top);
+	GuiRender(renderCustomImage, ((left << 16) | top));
 
 	if((freezeFrame.type == FREEZE_TYPE_FIXED) || (freezeFrame.type == FREEZE_TYPE_SLEEP)) {
 		// 固定显示/冻结显示都关闭clockTimer
@@ -906,24 +1024,22 @@ static void ICACHE_FLASH_ATTR powerToggleHandler(uint32_t eventId, uint32_t arg)
 	os_timer_disarm(&clockTimer);
 	uint32_t size, calc;
 
-	EPDDisplayClear();
-
 	if(arg == POWERTOGGLE_SHUTDOWN) {
 		size = shutdown_size;
 		calc = (size / 4);
 		if((calc * 4) < size) {
 			calc++;
 		}
-		GuiDrawImagePacked(shutdown_image, 0, 0);
+		GuiRender(renderPackedImage, (uint32_t)shutdown_image);
 
 	}else if(arg == POWERTOGGLE_UPDATE) {
 		system_rtc_mem_read(POWERMODE_INFO_POS, (void *)&powermode, sizeof(PowerMode));
 		powermode.type = POWER_REBOOT;
 		system_rtc_mem_write(POWERMODE_INFO_POS, (const void *)&powermode, sizeof(PowerMode));
-		GuiDrawImagePacked(update_image, 0, 0);
+		GuiRender(renderPackedImage, (uint32_t)update_image);
 
 	}else if(arg == POWERTOGGLE_IDLE_TIMEOUT) {
-		GuiDrawImagePacked(idle_image, 0, 0);
+		GuiRender(renderPackedImage, (uint32_t)idle_image);
 	}
 
 	postEventDelay(EVENT_UPDATE_EPD, 100);
@@ -939,6 +1055,18 @@ static void ICACHE_FLASH_ATTR udp_recv_callback(void *arg, char *pdata, unsigned
 	handlerDispatch(&udp_espconn, (uint8_t *)pdata, len);
 }
 
+/**
+ * @brief 读取面板温度，优先使用控制器内部温度传感器，失败时使用DHT11缓存值
+ * @note 需在EPDReset之后调用
+ * */
+static sint8_t ICACHE_FLASH_ATTR readPanelTemperature(void) {
+	sint8_t temperature = EPDReadTemperature();
+	if(temperature == EPD_TEMPERATURE_INVALID) {
+		temperature = DHT11Read()->tempHighPart;
+	}
+	return temperature;
+}
+
 /**
  * @brief epd刷新定时器回调
  * @param timer_arg
@@ -948,15 +1076,97 @@ static void ICACHE_FLASH_ATTR postDelayTimerCallback(void *timer_arg) {
 	PowerMode powermode;
 	SystemRunTime *runtime;
 	uint32_t pageFlag = 0x0;
+#ifndef EPD_BANDED_RENDER
+	Rect dirty;
+	RefreshBudget budget;
+	RefreshRequest request;
+#endif
+	uint32_t frameHash, lastHash;
+	STATUS status;
 
 	os_timer_disarm(&postDelayTimer);
 
-	if(delayEventId == EVENT_UPDATE_EPD && EPDGetStatus() == IDLE) {
+	if(delayEventId == EVENT_UPDATE_EPD && (EPDGetStatus() != IDLE || EPDIsUpdating())) {
+		// 上一帧尚未刷新完成，由epdFinishedHandler重新提交
+		updateDeferred = TRUE;
+
+	}else if(delayEventId == EVENT_UPDATE_EPD) {
+#ifdef EPD_BANDED_RENDER
+		// 分带渲染时绘制与写入同时进行，哈希在写入完成后才能得到
 		EPDGpioSetup();
 		EPDReset();
-		EPDInit(LUT_FULL_UPDATE);
-		EPDFlush();
-		EPDTurnOnDisplay();
+		EPDSetTemperature(readPanelTemperature());
+		status = EPDInit(LUT_FULL_UPDATE);
+		frameHash = GuiRenderBands();
+		system_rtc_mem_read(FRAME_HASH_POS, (void *)&lastHash, sizeof(uint32_t));
+		if(status == OK && frameHash == lastHash) {
+			EPDCancelUpdate();
+			EventBusGetDefault()->post(MAIN_EVENT_EPD_FINISH, EPD_FINISH_OK);
+			return;
+		}
+		// 刷新完成前屏幕内容不确定，先清除已显示帧的哈希
+		refreshingHash = frameHash;
+		lastHash = 0;
+		system_rtc_mem_write(FRAME_HASH_POS, (const void *)&lastHash, sizeof(uint32_t));
+		if(status == OK) {
+			status = EPDTurnOnDisplay();
+		}
+		if(status != OK) {
+			EPDCancelUpdate();
+			EventBusGetDefault()->post(MAIN_EVENT_EPD_FINISH, EPD_FINISH_ERROR);
+		}
+#else
+		// 与屏幕上内容相同的帧不再刷新，直接通知刷新完成以继续电源状态流程
+		frameHash = GuiGetFrameHash();
+		system_rtc_mem_read(FRAME_HASH_POS, (void *)&lastHash, sizeof(uint32_t));
+		if(frameHash != 0 && frameHash == lastHash) {
+			EventBusGetDefault()->post(MAIN_EVENT_EPD_FINISH, EPD_FINISH_OK);
+			return;
+		}
+		// 刷新完成前屏幕内容不确定，先清除已显示帧的哈希
+		refreshingHash = frameHash;
+		lastHash = 0;
+		system_rtc_mem_write(FRAME_HASH_POS, (const void *)&lastHash, sizeof(uint32_t));
+
+		system_rtc_mem_read(POWERMODE_INFO_POS, (void *)&powermode, sizeof(PowerMode));
+		request.canPartial = GuiGetDirtyRegion(&dirty);
+
+		EPDGpioSetup();
+		EPDReset();
+#ifdef EPD_RETAIN_IN_LIGHT_SLEEP
+		// 保持运行(正常/modem sleep)和light sleep期间EPD不断电，控制器RAM可作为局部刷新的基准
+		EPDSetRetainRAM(powermode.type == POWER_NONE_SLEEP || powermode.type == POWER_MODEM_SLEEP || powermode.type == POWER_LIGHT_SLEEP);
+#else
+		// 默认每次刷新后EPD断电，下一次总是全局刷新
+		EPDSetRetainRAM(FALSE);
+#endif
+		// 由残影预算决定全局/局部刷新
+		system_rtc_mem_read(REFRESH_BUDGET_POS, (void *)&budget, sizeof(RefreshBudget));
+		request.canPartial = (request.canPartial && EPDCanPartialUpdate());
+		request.page = renderPage;
+		request.weight = (renderPage < sizeof(PageGhostWeight)) ? PageGhostWeight[renderPage] : IMAGE_GHOST_WEIGHT;
+		request.temperature = readPanelTemperature();
+		EPDSetTemperature(request.temperature);
+		request.dirtyArea = request.canPartial ? ((dirty.right - dirty.left + 1) * (dirty.bottom - dirty.top + 1)) : 0;
+		if(RefreshPolicyDecide(&budget, &request) == REFRESH_PARTIAL) {
+			// 仅发送变化的字节窗口
+			status = EPDInit(LUT_PARTIAL_UPDATE);
+			if(status == OK) {
+				status = EPDFlushWindow(dirty.left, dirty.top, dirty.right, dirty.bottom);
+			}
+		}else {
+			status = EPDInit(LUT_FULL_UPDATE);
+			if(status == OK) {
+				status = EPDFlush();
+			}
+		}
+		system_rtc_mem_write(REFRESH_BUDGET_POS, (const void *)&budget, sizeof(RefreshBudget));
+		if(status != OK) {
+			EPDCancelUpdate();
+			EventBusGetDefault()->post(MAIN_EVENT_EPD_FINISH, EPD_FINISH_ERROR);
+		}
+		// 显存在系统任务中分块写入，完成后由epdFlushedHandler开始刷新
+#endif
 
 	}else if(delayEventId == EVENT_DOUBLE_CLICK) {
 		opmode = wifi_get_opmode();
@@ -1043,7 +1253,8 @@ static void ICACHE_FLASH_ATTR enterLightSleep(void) {
 	system_rtc_mem_read(WAKEUP_INTERVAL_POS, &seconds, sizeof(uint32_t));
 	if(seconds == 0) {
 		wifi_fpm_close();
-		ETS_GPIO_INTR_DISABLE();
+		// 只关闭按键中断，EPD BUSY中断仍需要
+		UserButtonIRQDisable();
 		system_rtc_mem_read(UPDATEINFO_POS, (void *)&info, sizeof(UpdateInfo));
 		compare = (info.timeCompare / 60);
 		index = (compare >> 3);
@@ -1064,7 +1275,7 @@ static void ICACHE_FLASH_ATTR enterLightSleep(void) {
  * */
 static void ICACHE_FLASH_ATTR batteryLowShutdown(void) {
 	PowerMode powermode;
-	GuiDrawImagePacked(batlow_image, 0, 0);
+	GuiRender(renderPackedImage, (uint32_t)batlow_image);
 	powermode.type = POWER_BATLOW;
 	system_rtc_mem_write(POWERMODE_INFO_POS, (const void *)&powermode, sizeof(PowerMode));
 	// 稍微延时长点，以便执行写入启动成功标记
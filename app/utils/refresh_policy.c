@@ -0,0 +1,70 @@
+/*
+ * refresh_policy.c
+ * @brief 全局/局部刷新决策
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#include "utils/refresh_policy.h"
+
+// 屏幕像素总数 250*122
+#define REFRESH_SCREEN_AREA    30500
+
+/**
+ * @brief 计算本次局部刷新的残影代价
+ * @note 基础代价为页面权重，变化面积越大代价越高(整屏变化时为3倍)，低温时加倍
+ * */
+static uint32_t ICACHE_FLASH_ATTR RefreshPolicyCost(const RefreshRequest *request) {
+	uint32_t area = (request->dirtyArea > REFRESH_SCREEN_AREA) ? REFRESH_SCREEN_AREA : request->dirtyArea;
+	uint32_t cost = request->weight + (request->weight * 2 * area / REFRESH_SCREEN_AREA);
+
+	if(request->temperature != REFRESH_TEMP_UNKNOWN && request->temperature < REFRESH_TEMP_COLD) {
+		cost <<= 1;
+	}
+	return cost;
+}
+
+/**
+ * @brief 决定本次刷新类型并更新刷新状态
+ * @note 页面切换、超出温度范围、达到局部刷新次数上限或超出残影预算时使用全局刷新
+ * @param *budget 刷新状态(读取后写回RTC内存)
+ * @param *request 本次刷新的参数
+ * @return REFRESH_FULL / REFRESH_PARTIAL
+ * */
+RefreshType ICACHE_FLASH_ATTR RefreshPolicyDecide(RefreshBudget *budget, const RefreshRequest *request) {
+	uint32_t cost;
+	BOOL full = FALSE;
+
+	if(!request->canPartial || request->page != budget->page) {
+		full = TRUE;
+	}else if(request->temperature != REFRESH_TEMP_UNKNOWN
+			&& (request->temperature < REFRESH_TEMP_MIN || request->temperature > REFRESH_TEMP_MAX)) {
+		full = TRUE;
+	}else if(budget->partials >= REFRESH_PARTIAL_MAX) {
+		full = TRUE;
+	}
+
+	budget->page = request->page;
+	if(!full) {
+		cost = RefreshPolicyCost(request);
+		if((budget->ghosting + cost) <= REFRESH_GHOSTING_BUDGET) {
+			budget->ghosting += cost;
+			budget->partials++;
+			return REFRESH_PARTIAL;
+		}
+	}
+	// 全局刷新清除累计残影
+	budget->ghosting = 0;
+	budget->partials = 0;
+	return REFRESH_FULL;
+}
+
+/**
+ * @brief 清空刷新状态，下一次刷新总是全局刷新
+ * */
+void ICACHE_FLASH_ATTR RefreshPolicyReset(RefreshBudget *budget) {
+	budget->ghosting = 0;
+	budget->partials = REFRESH_PARTIAL_MAX;
+	budget->page = REFRESH_PAGE_IMAGE;
+	budget->dummy = 0;
+}
@@ -11,6 +11,27 @@ static void ICACHE_FLASH_ATTR getNext(uint8_t *match, uint32_t matchLength, int3
 
 static uint8_t ICACHE_FLASH_ATTR byteStrTohex(uint8_t *str);
 
+static BOOL ICACHE_FLASH_ATTR buildLutIndex(void);
+
+static BOOL ICACHE_FLASH_ATTR lookupLut(uint16_t unicode, uint32_t *pack);
+
+typedef enum _lut_state {
+	LUT_STATE_INIT = 0,
+	LUT_STATE_READY,
+	// utf16.lut不存在或超出索引容量
+	LUT_STATE_MISSING
+} LutState;
+
+static LutState lutState = LUT_STATE_INIT;
+static File lutFile;
+// 组数量(每组4字节)和采样分段数量
+static uint32_t lutGroups = 0;
+static uint32_t lutBuckets = 0;
+// lutIndex[n]为第n段首组的unicode
+static uint16_t lutIndex[UTF16_INDEX_SIZE];
+// 最近转换结果，与文件中的组格式相同，0为空
+static uint32_t lutMemo[UTF16_MEMO_SIZE];
+
 /**
  * @brief unicode格式字符串转gb2312编码, 末尾会补'\0'
  * @brief 可以接受纯unicode字符"\u591a\u4e91", 转换后变成小端模式0x1a 0x59 0x91 0x4e
@@ -76,48 +97,117 @@ static uint8_t ICACHE_FLASH_ATTR byteStrTohex(uint8_t *str) {
 /**
  * @brief 使用utf16.lut查找表查询unicode对应的gb2312编码
  * @brief unicode小端方式输入，gb2312大端方式输出
+ * @note 首次调用时建立采样索引，之后每次查询最多读取一段(128字节)数据，最近转换的字符不读取文件
  * @param unicode 双字节unicode码, 小端模式
- * @return gb2312 gb2312字符集，大端模式
+ * @return gb2312 gb2312字符集，大端模式，查找表中不存在时为0
  * */
 Short ICACHE_FLASH_ATTR QueryGB2312ByUnicode(uint16_t unicode) {
-	File file;
 	Short gb2312;
-	BOOL success;
-	uint16_t readin = 0;
-	uint32_t pack, group;
-	int32_t start, middle, end;
+	uint32_t pack, slot = (unicode & (UTF16_MEMO_SIZE - 1));
 	gb2312.value = 0;
 
-	if(open_file(&file, "utf16", "lut")) {
-		// 四字节一组，低两字节为unicode，高两字节为gb2312
-		group = (file.length / sizeof(uint32_t));
-		middle = group / 2;
-		end = group;
-		start = -1;
-		do {
-			// 二分法，从中间查起
-			success = read_file(&file, (middle * sizeof(uint32_t)), (uint8_t *)&pack, sizeof(uint32_t));
-			if(!success || middle <= 0 || middle >= (group - 1)) {
-				break;
-			}
-			readin = (uint16_t)(pack & 0xFFFF);
-			if(unicode < readin) {
-				// 向左查询
-				end = middle;
-				middle -= ((end - start) / 2);
-			}else if(unicode > readin) {
-				// 向右查询
-				start = middle;
-				middle += ((end - start) / 2);
-			}
-		}while(unicode != readin);
-
-		gb2312.bytes[0] = (uint8_t)((pack >> 24) & 0xFF);
-		gb2312.bytes[1] = (uint8_t)((pack >> 16) & 0xFF);
+	pack = lutMemo[slot];
+	if(pack == 0 || (uint16_t)(pack & 0xFFFF) != unicode) {
+		if(!buildLutIndex() || !lookupLut(unicode, &pack)) {
+			return gb2312;
+		}
+		lutMemo[slot] = pack;
 	}
+	gb2312.bytes[0] = (uint8_t)((pack >> 24) & 0xFF);
+	gb2312.bytes[1] = (uint8_t)((pack >> 16) & 0xFF);
 	return gb2312;
 }
 
+/**
+ * @brief 文件被重命名/删除/覆盖写后调用，utf16.lut变更时重建索引
+ * @param *filename 原始格式文件名(空缺填充0xFF)，NULL时总是重建
+ * */
+void ICACHE_FLASH_ATTR InvalidateGB2312Query(uint8_t *filename) {
+	File temp;
+	if(filename != NULL) {
+		make_file(&temp, "utf16", "lut");
+		if(os_memcmp(temp.filename, filename, FILENAME_SIZE) != 0) {
+			return;
+		}
+	}
+	lutState = LUT_STATE_INIT;
+	os_memset(lutMemo, 0x00, sizeof(lutMemo));
+}
+
+/**
+ * @brief 打开utf16.lut并记录每段首组的unicode
+ * @return TRUE:索引可用, FALSE:文件不存在或超出索引容量
+ * */
+static BOOL ICACHE_FLASH_ATTR buildLutIndex(void) {
+	uint32_t i, pack;
+	if(lutState != LUT_STATE_INIT) {
+		return (lutState == LUT_STATE_READY);
+	}
+	lutState = LUT_STATE_MISSING;
+	if(!open_file(&lutFile, "utf16", "lut")) {
+		return FALSE;
+	}
+	// 四字节一组，低两字节为unicode，高两字节为gb2312，按unicode升序排列
+	lutGroups = (lutFile.length / sizeof(uint32_t));
+	lutBuckets = ((lutGroups + UTF16_INDEX_STRIDE - 1) / UTF16_INDEX_STRIDE);
+	if(lutBuckets == 0 || lutBuckets > UTF16_INDEX_SIZE) {
+		return FALSE;
+	}
+	for(i = 0; i < lutBuckets; i++) {
+		if(read_file(&lutFile, (i * UTF16_INDEX_STRIDE * sizeof(uint32_t)), (uint8_t *)&pack, sizeof(uint32_t)) != sizeof(uint32_t)) {
+			return FALSE;
+		}
+		lutIndex[i] = (uint16_t)(pack & 0xFFFF);
+	}
+	lutState = LUT_STATE_READY;
+	return TRUE;
+}
+
+/**
+ * @brief 先在内存索引中定位分段，再读取该段并二分查找
+ * @param unicode 待查询unicode
+ * @param *pack 查询到的组数据
+ * @return TRUE:查询成功, FALSE:查找表中不存在
+ * */
+static BOOL ICACHE_FLASH_ATTR lookupLut(uint16_t unicode, uint32_t *pack) {
+	uint32_t groups[UTF16_INDEX_STRIDE];
+	uint32_t count;
+	uint16_t readin;
+	int32_t start = 0, middle, end = ((int32_t)lutBuckets - 1);
+	// 最后一个首unicode不大于待查询值的分段
+	while(start <= end) {
+		middle = ((start + end) >> 1);
+		if(lutIndex[middle] <= unicode) {
+			start = (middle + 1);
+		}else {
+			end = (middle - 1);
+		}
+	}
+	if(end < 0) {
+		return FALSE;
+	}
+	count = (lutGroups - (end * UTF16_INDEX_STRIDE));
+	count = (count > UTF16_INDEX_STRIDE) ? UTF16_INDEX_STRIDE : count;
+	if(read_file(&lutFile, (end * UTF16_INDEX_STRIDE * sizeof(uint32_t)), (uint8_t *)groups, (count * sizeof(uint32_t))) != (count * sizeof(uint32_t))) {
+		return FALSE;
+	}
+	start = 0;
+	end = ((int32_t)count - 1);
+	while(start <= end) {
+		middle = ((start + end) >> 1);
+		readin = (uint16_t)(groups[middle] & 0xFFFF);
+		if(readin == unicode) {
+			*pack = groups[middle];
+			return TRUE;
+		}else if(readin < unicode) {
+			start = (middle + 1);
+		}else {
+			end = (middle - 1);
+		}
+	}
+	return FALSE;
+}
+
 /*
 Unicode符号范围     |        UTF-8编码方式
 (十六进制)        |              （二进制）
@@ -253,7 +343,7 @@ int32_t ICACHE_FLASH_ATTR charAtSkip(char *str, char ch) {
  * @brief 从字符串尾部向前查找ch，返回ch所在的位置
  * */
 int32_t ICACHE_FLASH_ATTR lastIndexOf(uint8_t *src, uint8_t ch) {
-    int32_t position = os_strlen(src) - 1;
+    int32_t position = os_strlen((const char *)src) - 1;
     for(; ((position > -1) && (*(src + position) != ch)); position--);
     return position;
 }
@@ -453,10 +543,10 @@ int32_t ICACHE_FLASH_ATTR contains(uint8_t *src, uint8_t *sub) {
     if(src == NULL || sub == NULL) {
         return -1;
     }
-    if((sublen = os_strlen(sub)) > KMP_SUB_MAX_LENGTH) {
+    if((sublen = os_strlen((const char *)sub)) > KMP_SUB_MAX_LENGTH) {
     	return -1;
     }
-    srclen = os_strlen(src);
+    srclen = os_strlen((const char *)src);
     // 获得next数组
     getNext(sub, sublen, pNext);
 
@@ -6,11 +6,80 @@
  */
 
 #include "view/basic_layout.h"
+#include "graphics/widget.h"
+#include "view/appicon.h"
 #include "utils/misc.h"
 
 static const char *tempText = "温度";
 static const char * numIconPrefix = "digit";
 
+static void ICACHE_FLASH_ATTR formatWeatherIcon(const Widget *widget, const void **sources, char *content);
+static void ICACHE_FLASH_ATTR formatTimeDigit(const Widget *widget, const void **sources, char *content);
+static void ICACHE_FLASH_ATTR formatSignal(const Widget *widget, const void **sources, char *content);
+static void ICACHE_FLASH_ATTR drawCityName(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawHumidity(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawUltraviolet(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawTemperature(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawColon(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawIndoor(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawBattery(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawSignal(const Widget *widget, const void **sources, const char *content);
+
+// 页面控件，区域与原绘制位置一致，时间变化时只重绘数字图片
+static const Widget basicWidgets[] = {
+	// 天气图标48*48
+	{{0, 0, 47, 47}, (WIDGET_ICON | WIDGET_STATIC), 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, weatherIcon)}, formatWeatherIcon, NULL},
+	// 城市名称
+	{{48, 0, 97, 11}, (WIDGET_BITMAP | WIDGET_STATIC), 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, cityName)}, NULL, drawCityName},
+	// 湿度
+	{{50, 16, 97, 33}, (WIDGET_BITMAP | WIDGET_STATIC), 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, humidity)}, NULL, drawHumidity},
+	// 紫外线强度
+	{{50, 34, 97, 49}, (WIDGET_BITMAP | WIDGET_STATIC), 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, ultravioletDesc)}, NULL, drawUltraviolet},
+	// 气象描述
+	{{0, 50, 97, 65}, (WIDGET_TEXT | WIDGET_STATIC), FONT12x12_CN, FONT08x16_EN, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, weatherDesc)}, NULL, NULL},
+	// 最高/最低温度
+	{{0, 66, 97, 81}, (WIDGET_BITMAP | WIDGET_STATIC), 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, tempLowest),
+		 WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, tempHighest)}, NULL, drawTemperature},
+	// 风向
+	{{0, 82, 97, 96}, (WIDGET_TEXT | WIDGET_STATIC), FONT12x12_CN, FONT08x16_EN, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, windDesc)}, NULL, NULL},
+	// 明天/后天天气情况
+	{{0, 97, 172, 109}, (WIDGET_TEXT | WIDGET_STATIC), FONT12x12_CN, FONT08x16_EN, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, tomorrowWeatherDesc)}, NULL, NULL},
+	{{0, 110, 172, 121}, (WIDGET_TEXT | WIDGET_STATIC), FONT12x12_CN, FONT08x16_EN, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, dayAfterTomorrowWeatherDesc)}, NULL, NULL},
+	// 公历信息
+	{{98, 0, 249, 12}, (WIDGET_TEXT | WIDGET_STATIC), FONT12x12_CN, FONT08x16_EN, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_CALENDAR, Calendar, calendarDesc)}, NULL, NULL},
+	// 农历信息
+	{{98, 13, 249, 25}, (WIDGET_TEXT | WIDGET_STATIC), FONT12x12_CN, FONT08x16_EN, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_CALENDAR, Calendar, lunarDesc)}, NULL, NULL},
+	// 时间数字图片，param为数字位置，签名只包含格式化后的文件名
+	{{98, 26, 134, 96}, WIDGET_ICON, 0, 0, 0, {{0}}, formatTimeDigit, NULL},
+	{{135, 26, 171, 96}, WIDGET_ICON, 0, 0, 1, {{0}}, formatTimeDigit, NULL},
+	// 小时:分钟中间的':'分隔符
+	{{172, 45, 175, 77}, (WIDGET_BITMAP | WIDGET_STATIC), 0, 0, 0, {{0}}, NULL, drawColon},
+	{{176, 26, 212, 96}, WIDGET_ICON, 0, 0, 2, {{0}}, formatTimeDigit, NULL},
+	{{213, 26, 249, 96}, WIDGET_ICON, 0, 0, 3, {{0}}, formatTimeDigit, NULL},
+	// 底部状态栏，室内温湿度
+	{{173, 97, 249, 109}, WIDGET_BITMAP, 0, 0, 0,
+		{{WIDGET_SOURCE_STATUS, 2, WIDGET_OFFSET(StatusBar, humidity)}}, NULL, drawIndoor},
+	// 电量
+	{{173, 110, 249, 121}, WIDGET_BITMAP, 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_STATUS, StatusBar, batLevel)}, NULL, drawBattery},
+	// 信号，只比较信号等级，rssi抖动不触发重绘
+	{{215, 108, 249, 121}, WIDGET_BITMAP, 0, 0, 0,
+		{{WIDGET_SOURCE_STATUS, 2, WIDGET_OFFSET(StatusBar, sysopmode)}}, formatSignal, drawSignal},
+};
+
+static WidgetTree basicTree = {basicWidgets, (sizeof(basicWidgets) / sizeof(Widget)), FALSE, 0, 0, {0}};
+
 /**
  * @brief 刷新天气预报页面布局
  * @param calendar 日期信息
@@ -18,46 +87,72 @@ static const char * numIconPrefix = "digit";
  * @param status 状态栏信息，电量、信号强度、温湿度传感器
  * */
 void ICACHE_FLASH_ATTR invalidateBasic(Calendar *calendar, BasicWeather *weather, StatusBar *status) {
-	Font *chs12px, *eng16px, *eng12px, *ext16px;
-	char *iconFileName;
+	const void *sources[WIDGET_SOURCE_COUNT] = {calendar, weather, status, NULL};
+	WidgetTreeRender(&basicTree, sources);
+}
 
-	char buffer[16];
+static void ICACHE_FLASH_ATTR formatWeatherIcon(const Widget *widget, const void **sources, char *content) {
+	const BasicWeather *weather = sources[WIDGET_SOURCE_WEATHER];
+	os_strcpy(content, getWeatherIcon(weather->weatherIcon));
+}
+
+/**
+ * @brief 时间数字图片文件名，param依次为小时十位、个位，分钟十位、个位
+ * */
+static void ICACHE_FLASH_ATTR formatTimeDigit(const Widget *widget, const void **sources, char *content) {
+	const Calendar *calendar = sources[WIDGET_SOURCE_CALENDAR];
 	uint8_t parts[4];
-	int32_t i, xpos;
-	// 时间图片绘制的左上X轴坐标(Y轴相同)
-	const uint16_t numIconPosX[] = {98, 135, 176, 213};
-	const uint16_t numIconPosY = 26;
-	const uint8_t limits[] = {90, 70, 40, 10, 0};
 
-	chs12px = getFont(FONT12x12_CN);
-	eng16px = getFont(FONT08x16_EN);
-	eng12px = getFont(FONT06x12_EN);
-	ext16px = getFont(FONT08x16_EXT);
+	parts[0] = (uint8_t)(calendar->hour / 10);
+	parts[1] = (uint8_t)(calendar->hour % 10);
+	parts[2] = (uint8_t)(calendar->minute / 10);
+	parts[3] = (uint8_t)(calendar->minute % 10);
 
-	EPDDisplayClear();
+	os_strcpy(content, numIconPrefix);
+	content[5] = '0' + parts[widget->param & 0x03];
+	content[6] = '\0';
+}
 
-	// 天气图标48*48
-	iconFileName = (char *)getWeatherIcon(weather->weatherIcon);
-	GuiDrawBmpImage(iconFileName, "bmp", 0, 0);
+static void ICACHE_FLASH_ATTR formatSignal(const Widget *widget, const void **sources, char *content) {
+	const StatusBar *status = sources[WIDGET_SOURCE_STATUS];
+	if(status->sysopmode == STATION_MODE && status->syspowermode == POWER_NONE_SLEEP) {
+		content[0] = '0' + calculateSignalLevel(status->rssi, MAX_LEVEL);
+		content[1] = '\0';
+	}
+}
 
+static void ICACHE_FLASH_ATTR drawCityName(const Widget *widget, const void **sources, const char *content) {
+	const BasicWeather *weather = sources[WIDGET_SOURCE_WEATHER];
 	// 城市名称 "常州"，两个字的居中，三个字以上的居左
-	xpos = (os_strlen(weather->cityName) < 7) ? 60 : 48;
-	GuiDrawStringUTF8(weather->cityName, xpos, 0, chs12px, eng16px);
+	int32_t xpos = (os_strlen(weather->cityName) < 7) ? 60 : 48;
+	GuiDrawStringUTF8((uint8_t *)weather->cityName, xpos, 0, getFont(FONT12x12_CN), getFont(FONT08x16_EN));
+}
+
+static void ICACHE_FLASH_ATTR drawHumidity(const Widget *widget, const void **sources, const char *content) {
+	const BasicWeather *weather = sources[WIDGET_SOURCE_WEATHER];
+	char buffer[8];
+	int32_t i, humidity;
 
-	// 湿度  湿度99%
 	GuiDrawBmpImage("ic_sd", "bmp", 50, 16);
-	// xpos 复用做湿度临时变量, 限制只显示2个字符（湿度总是正数）
-	xpos = (weather->humidity > 99) ? 99 : weather->humidity;
-	i = integer2String(xpos, buffer, sizeof(buffer));
+	// 限制只显示2个字符（湿度总是正数）
+	humidity = (weather->humidity > 99) ? 99 : weather->humidity;
+	i = integer2String(humidity, buffer, sizeof(buffer));
 	os_strcpy((buffer + i), "%");
-	GuiDrawString(buffer, 67, 18, chs12px, eng16px);
-	// 紫外线强度
+	GuiDrawString(buffer, 67, 18, getFont(FONT12x12_CN), getFont(FONT08x16_EN));
+}
+
+static void ICACHE_FLASH_ATTR drawUltraviolet(const Widget *widget, const void **sources, const char *content) {
+	const BasicWeather *weather = sources[WIDGET_SOURCE_WEATHER];
 	GuiDrawBmpImage("ic_uv", "bmp", 50, 34);
-	GuiDrawStringUTF8(weather->ultravioletDesc, 67, 36, chs12px, eng16px);
+	GuiDrawStringUTF8((uint8_t *)weather->ultravioletDesc, 67, 36, getFont(FONT12x12_CN), getFont(FONT08x16_EN));
+}
+
+static void ICACHE_FLASH_ATTR drawTemperature(const Widget *widget, const void **sources, const char *content) {
+	const BasicWeather *weather = sources[WIDGET_SOURCE_WEATHER];
+	Font *chs12px = getFont(FONT12x12_CN), *eng16px = getFont(FONT08x16_EN);
+	char buffer[16];
+	int32_t i, xpos;
 
-	// 气象描述 "小雨到中雨"
-	GuiDrawStringUTF8(weather->weatherDesc, 0, 50, chs12px, eng16px);
-	// 最高/最低温度
 	xpos = GuiDrawStringUTF8((uint8_t *)tempText, 0, 66, chs12px, eng16px);
 	i = integer2String(weather->tempLowest, buffer, sizeof(buffer));
 	os_strcpy((buffer + i), "～");
@@ -65,36 +160,18 @@ void ICACHE_FLASH_ATTR invalidateBasic(Calendar *calendar, BasicWeather *weather
 	i = integer2String(weather->tempHighest, buffer, sizeof(buffer));
 	os_strcpy((buffer + i), "℃");
 	GuiDrawStringUTF8(buffer, xpos, 66, chs12px, eng16px);
-	// 风向
-	GuiDrawStringUTF8(weather->windDesc, 0, 82, chs12px, eng16px);
-	// 明天/后天天气情况
-	GuiDrawStringUTF8(weather->tomorrowWeatherDesc, 0, 97, chs12px, eng16px);
-	GuiDrawStringUTF8(weather->dayAfterTomorrowWeatherDesc, 0, 110, chs12px, eng16px);
-
-	// 公历信息
-	GuiDrawStringUTF8(calendar->calendarDesc, 98, 0, chs12px, eng16px);
-	// 农历信息
-	GuiDrawStringUTF8(calendar->lunarDesc, 98, 13, chs12px, eng16px);
-
-	// 时间显示
-	parts[0] = (uint8_t)(calendar->hour / 10);
-	parts[1] = (uint8_t)(calendar->hour % 10);
-	parts[2] = (uint8_t)(calendar->minute / 10);
-	parts[3] = (uint8_t)(calendar->minute % 10);
-
-	os_strcpy(buffer, numIconPrefix);
-	buffer[6] = '\0';
-	// 绘制时间数字图片
-	for(i = 0; i < 4; i++) {
-		buffer[5] = '0' + parts[i];
-		GuiDrawBmpImage(buffer, "bmp", numIconPosX[i], numIconPosY);
-	}
+}
 
-	// 绘制小时:分钟中间的':'分隔符
+static void ICACHE_FLASH_ATTR drawColon(const Widget *widget, const void **sources, const char *content) {
 	GuiFillColor(172, 45, 175, 51, BLACK);
 	GuiFillColor(172, 71, 175, 77, BLACK);
+}
+
+static void ICACHE_FLASH_ATTR drawIndoor(const Widget *widget, const void **sources, const char *content) {
+	const StatusBar *status = sources[WIDGET_SOURCE_STATUS];
+	char buffer[16];
+	int32_t i;
 
-	// 底部状态栏, 室内图标
 	GuiDrawBmpImage("home", "bmp", 173, 97);
 	// 温度支持范围-9 ~ 99，小于0度只能显示低位, 大于0度显示2位
 	buffer[0] = (status->temperature < 0) ? '-' : ('0' + (status->temperature / 10));
@@ -105,37 +182,48 @@ void ICACHE_FLASH_ATTR invalidateBasic(Calendar *calendar, BasicWeather *weather
 	buffer[5] = '0' + (i / 10);
 	buffer[6] = '0' + (i % 10);
 	os_strcpy((buffer + 7), "%RH");
-	GuiDrawString(buffer, 185, 98, chs12px, eng12px);
+	GuiDrawString(buffer, 185, 98, getFont(FONT12x12_CN), getFont(FONT06x12_EN));
+}
+
+static void ICACHE_FLASH_ATTR drawBattery(const Widget *widget, const void **sources, const char *content) {
+	const StatusBar *status = sources[WIDGET_SOURCE_STATUS];
+	const uint8_t limits[] = {90, 70, 40, 10, 0};
+	char buffer[8];
+	int32_t i;
 
 	// 电量等级图标
 	for(i = 0; i < 5; i++) {
 		if(status->batLevel >= limits[i]) break;
 	}
-    os_strcpy(buffer, "bat");
-    buffer[3] = '0' + i;
-    buffer[4] = '\0';
-    GuiDrawBmpImage(buffer, "bmp", 173, 110);
-    // 清除[电量/信号]显示区域
+	os_strcpy(buffer, "bat");
+	buffer[3] = '0' + i;
+	buffer[4] = '\0';
+	GuiDrawBmpImage(buffer, "bmp", 173, 110);
+	// 清除[电量/信号]显示区域
 	GuiFillColor(185, 110, 249, 121, WHITE);
 
 	if(status->batLevel > 90) {
-        os_strcpy(buffer, "100%");
+		os_strcpy(buffer, "100%");
 	}else if(status->batLevel > 0) {
 		buffer[0] = '0' + (status->batLevel / 10);
-    	os_strcpy((buffer + 1), "0%");
-    }else {
-    	os_strcpy(buffer, "0%");
-    }
-	GuiDrawString(buffer, 185, 110, chs12px, eng12px);
+		os_strcpy((buffer + 1), "0%");
+	}else {
+		os_strcpy(buffer, "0%");
+	}
+	GuiDrawString(buffer, 185, 110, getFont(FONT12x12_CN), getFont(FONT06x12_EN));
+}
+
+static void ICACHE_FLASH_ATTR drawSignal(const Widget *widget, const void **sources, const char *content) {
+	const StatusBar *status = sources[WIDGET_SOURCE_STATUS];
+	Font *ext16px = getFont(FONT08x16_EXT);
 
 	// 国标特殊字符的信号图标
 	GuiDrawChar(0x1F, 215, 108, BLACK, WHITE, ext16px, 14);
-	if(status->sysopmode == STATION_MODE && status->syspowermode == POWER_NONE_SLEEP) {
-		i = calculateSignalLevel(status->rssi, MAX_LEVEL);
+	if(content[0] != '\0') {
 		// 信号等级icon
-		GuiDrawChar(0x20 + i, 223, 108, BLACK, WHITE, ext16px, 14);
+		GuiDrawChar(0x20 + (content[0] - '0'), 223, 108, BLACK, WHITE, ext16px, 14);
 	}else {
-		GuiDrawChar('X', 223, 110, BLACK, WHITE, eng12px, 12);
+		GuiDrawChar('X', 223, 110, BLACK, WHITE, getFont(FONT06x12_EN), 12);
 		if(POWER_MODEM_SLEEP == status->syspowermode) {
 			GuiDrawBmpImage("mslp", "bmp", 232, 110);
 		}else if(POWER_LIGHT_SLEEP == status->syspowermode) {
@@ -143,4 +231,3 @@ void ICACHE_FLASH_ATTR invalidateBasic(Calendar *calendar, BasicWeather *weather
 		}
 	}
 }
-
@@ -6,8 +6,45 @@
  */
 
 #include "view/forecast_layout.h"
+#include "graphics/widget.h"
 #include "utils/misc.h"
 
+static void ICACHE_FLASH_ATTR formatSignal(const Widget *widget, const void **sources, char *content);
+static void ICACHE_FLASH_ATTR drawHeader(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawForecast(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawFooter(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawStatus(const Widget *widget, const void **sources, const char *content);
+
+// 页面控件，四格天气param为预报数据序号
+static const Widget forecastWidgets[] = {
+	// 城市名称，公历信息，室内温湿度
+	{{0, 0, 249, 12}, WIDGET_BITMAP, 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, cityName),
+		 WIDGET_BIND(WIDGET_SOURCE_CALENDAR, Calendar, calendarDesc),
+		 WIDGET_BIND(WIDGET_SOURCE_STATUS, StatusBar, temperature),
+		 WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, humidity)}, NULL, drawHeader},
+	// 后四天天气
+	{{0, 13, 124, 60}, (WIDGET_BITMAP | WIDGET_STATIC), 0, 0, 1,
+		{{WIDGET_SOURCE_FORECAST, sizeof(ForecastWeather), (sizeof(ForecastWeather) * 1)}}, NULL, drawForecast},
+	{{125, 13, 249, 60}, (WIDGET_BITMAP | WIDGET_STATIC), 0, 0, 2,
+		{{WIDGET_SOURCE_FORECAST, sizeof(ForecastWeather), (sizeof(ForecastWeather) * 2)}}, NULL, drawForecast},
+	{{0, 62, 124, 109}, (WIDGET_BITMAP | WIDGET_STATIC), 0, 0, 3,
+		{{WIDGET_SOURCE_FORECAST, sizeof(ForecastWeather), (sizeof(ForecastWeather) * 3)}}, NULL, drawForecast},
+	// 底部两行与信号图标重叠，不放入静态图层
+	{{125, 62, 249, 109}, WIDGET_BITMAP, 0, 0, 4,
+		{{WIDGET_SOURCE_FORECAST, sizeof(ForecastWeather), (sizeof(ForecastWeather) * 4)}}, NULL, drawForecast},
+	// footer 农历信息和时间
+	{{0, 110, 175, 121}, WIDGET_BITMAP, 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_CALENDAR, Calendar, lunarDesc),
+		 {WIDGET_SOURCE_CALENDAR, 2, WIDGET_OFFSET(Calendar, hour)}}, NULL, drawFooter},
+	// 电量和信号，只比较信号等级
+	{{176, 108, 249, 121}, WIDGET_BITMAP, 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_STATUS, StatusBar, batLevel),
+		 {WIDGET_SOURCE_STATUS, 2, WIDGET_OFFSET(StatusBar, sysopmode)}}, formatSignal, drawStatus},
+};
+
+static WidgetTree forecastTree = {forecastWidgets, (sizeof(forecastWidgets) / sizeof(Widget)), FALSE, 1, 0, {0}};
+
 /**
  * @brief 刷新天气预报页面布局
  * @param calendar 日期信息
@@ -16,26 +53,31 @@
  * @param status 状态栏信息，电量、信号强度、温湿度传感器
  * */
 void ICACHE_FLASH_ATTR invalidateForecast(Calendar *calendar, BasicWeather *weather, ForecastWeather *forecastWeathers, StatusBar *status) {
-	const uint8_t limits[] = {90, 70, 40, 10, 0};
-	const uint8_t drawIconX[] = {0, 125, 0, 125};
-	const uint8_t drawIconY[] = {13, 13, 62, 62};
-	ForecastWeather *weatherPtr;
-	uint8_t buffer[32];
-	Font *chs12px, *eng16px, *eng12px, *ext16px;
-	int32_t cursor, xpos = 0, i, n, j;
-	char *iconFileName;
+	const void *sources[WIDGET_SOURCE_COUNT] = {calendar, weather, status, forecastWeathers};
+	WidgetTreeRender(&forecastTree, sources);
+}
 
-	chs12px = getFont(FONT12x12_CN);
-	eng16px = getFont(FONT08x16_EN);
-	eng12px = getFont(FONT06x12_EN);
-	ext16px = getFont(FONT08x16_EXT);
+static void ICACHE_FLASH_ATTR formatSignal(const Widget *widget, const void **sources, char *content) {
+	const StatusBar *status = sources[WIDGET_SOURCE_STATUS];
+	if(status->sysopmode == STATION_MODE && status->syspowermode == POWER_NONE_SLEEP) {
+		content[0] = '0' + calculateSignalLevel(status->rssi, MAX_LEVEL);
+		content[1] = '\0';
+	}
+}
+
+static void ICACHE_FLASH_ATTR drawHeader(const Widget *widget, const void **sources, const char *content) {
+	const Calendar *calendar = sources[WIDGET_SOURCE_CALENDAR];
+	const BasicWeather *weather = sources[WIDGET_SOURCE_WEATHER];
+	const StatusBar *status = sources[WIDGET_SOURCE_STATUS];
+	Font *chs12px = getFont(FONT12x12_CN), *eng16px = getFont(FONT08x16_EN);
+	uint8_t buffer[16];
+	int32_t xpos, j;
 
-	EPDDisplayClear();
 	// 城市名称限制2个字
 	os_memset(buffer, 0x00, sizeof(buffer));
 	os_strncpy(buffer, weather->cityName, 6);
-	xpos = GuiDrawStringUTF8(buffer, xpos, 0, chs12px, eng16px);
-	xpos = GuiDrawStringUTF8(calendar->calendarDesc, (xpos + 4), 0, chs12px, eng16px);
+	xpos = GuiDrawStringUTF8(buffer, 0, 0, chs12px, eng16px);
+	xpos = GuiDrawStringUTF8((uint8_t *)calendar->calendarDesc, (xpos + 4), 0, chs12px, eng16px);
 	// 室内图标
 	GuiDrawBmpImage("home", "bmp", (xpos), 0);
 	// 温度支持范围-9 ~ 99，小于0度只能显示低位, 大于0度显示2位
@@ -47,30 +89,37 @@ void ICACHE_FLASH_ATTR invalidateForecast(Calendar *calendar, BasicWeather *weat
 	buffer[5] = '0' + (j / 10);
 	buffer[6] = '0' + (j % 10);
 	os_strcpy((buffer + 7), "%RH");
-	GuiDrawString(buffer, (xpos + 12), 0, chs12px, eng12px);
+	GuiDrawString(buffer, (xpos + 12), 0, chs12px, getFont(FONT06x12_EN));
+}
 
-	// 后四天天气
-	for(j = 1, n = 0; j < 5; j++, n++) {
-		weatherPtr = (forecastWeathers + j);
-
-		iconFileName = (char *)getWeatherIcon(weatherPtr->weatherIcon);
-		GuiDrawBmpImage(iconFileName, "bmp", drawIconX[n], drawIconY[n]);
-
-		GuiDrawStringUTF8(weatherPtr->dayTag, (drawIconX[n] + 48), drawIconY[n], chs12px, eng16px);
-		GuiDrawStringUTF8(weatherPtr->weatherDesc, (drawIconX[n] + 48), (drawIconY[n] + 12), chs12px, eng16px);
-		GuiDrawStringUTF8(weatherPtr->windDesc, (drawIconX[n] + 48), (drawIconY[n] + 24), chs12px, eng16px);
-
-		cursor = integer2String(weatherPtr->tempLowest, buffer, sizeof(buffer));
-		os_strcpy((buffer + cursor), "～");
-		cursor += 3;
-		i = integer2String(weatherPtr->tempHighest, (buffer + cursor), (sizeof(buffer) - cursor));
-		cursor += i;
-		os_strcpy((buffer + cursor), "℃");
-		xpos = GuiDrawStringUTF8(buffer, (drawIconX[n] + 48), (drawIconY[n] + 36), chs12px, eng16px);
-	}
+static void ICACHE_FLASH_ATTR drawForecast(const Widget *widget, const void **sources, const char *content) {
+	const ForecastWeather *weatherPtr = (const ForecastWeather *)sources[WIDGET_SOURCE_FORECAST] + widget->param;
+	Font *chs12px = getFont(FONT12x12_CN), *eng16px = getFont(FONT08x16_EN);
+	const uint16_t x = widget->rect.left, y = widget->rect.top;
+	uint8_t buffer[32];
+	int32_t cursor;
+
+	GuiDrawBmpImage((char *)getWeatherIcon(weatherPtr->weatherIcon), "bmp", x, y);
+
+	GuiDrawStringUTF8((uint8_t *)weatherPtr->dayTag, (x + 48), y, chs12px, eng16px);
+	GuiDrawStringUTF8((uint8_t *)weatherPtr->weatherDesc, (x + 48), (y + 12), chs12px, eng16px);
+	GuiDrawStringUTF8((uint8_t *)weatherPtr->windDesc, (x + 48), (y + 24), chs12px, eng16px);
+
+	cursor = integer2String(weatherPtr->tempLowest, buffer, sizeof(buffer));
+	os_strcpy((buffer + cursor), "～");
+	cursor += 3;
+	cursor += integer2String(weatherPtr->tempHighest, (buffer + cursor), (sizeof(buffer) - cursor));
+	os_strcpy((buffer + cursor), "℃");
+	GuiDrawStringUTF8(buffer, (x + 48), (y + 36), chs12px, eng16px);
+}
+
+static void ICACHE_FLASH_ATTR drawFooter(const Widget *widget, const void **sources, const char *content) {
+	const Calendar *calendar = sources[WIDGET_SOURCE_CALENDAR];
+	Font *chs12px = getFont(FONT12x12_CN), *eng16px = getFont(FONT08x16_EN);
+	uint8_t buffer[8];
+	int32_t xpos;
 
-	// footer
-	xpos = GuiDrawStringUTF8(calendar->lunarDesc, 0, 110, chs12px, eng16px);
+	xpos = GuiDrawStringUTF8((uint8_t *)calendar->lunarDesc, 0, 110, chs12px, eng16px);
 
 	buffer[0] = '0' + (calendar->hour / 10);
 	buffer[1] = '0' + (calendar->hour % 10);
@@ -81,8 +130,15 @@ void ICACHE_FLASH_ATTR invalidateForecast(Calendar *calendar, BasicWeather *weat
 	buffer[1] = '0' + (calendar->minute % 10);
 	buffer[2] = '\0';
 	GuiDrawStringUTF8(buffer, (xpos - 4), 110, chs12px, eng16px);
+}
+
+static void ICACHE_FLASH_ATTR drawStatus(const Widget *widget, const void **sources, const char *content) {
+	const StatusBar *status = sources[WIDGET_SOURCE_STATUS];
+	const uint8_t limits[] = {90, 70, 40, 10, 0};
+	Font *eng12px = getFont(FONT06x12_EN), *ext16px = getFont(FONT08x16_EXT);
+	uint8_t buffer[8];
+	int32_t xpos = 176, i;
 
-	xpos = 176;
 	// 电量等级图标
 	for(i = 0; i < 5; i++) {
 		if(status->batLevel >= limits[i]) break;
@@ -100,14 +156,13 @@ void ICACHE_FLASH_ATTR invalidateForecast(Calendar *calendar, BasicWeather *weat
 	}else {
 		os_strcpy(buffer, "0%");
 	}
-	xpos = GuiDrawString(buffer, (xpos + 12), 110, chs12px, eng12px);
+	xpos = GuiDrawString(buffer, (xpos + 12), 110, getFont(FONT12x12_CN), eng12px);
 
 	// 国标特殊字符的信号图标
 	GuiDrawChar(0x1F, (xpos), 108, BLACK, WHITE, ext16px, 14);
-	if(status->sysopmode == STATION_MODE && status->syspowermode == POWER_NONE_SLEEP) {
-		i = calculateSignalLevel(status->rssi, MAX_LEVEL);
+	if(content[0] != '\0') {
 		// 信号等级icon
-		GuiDrawChar(0x20 + i, 223, 108, BLACK, WHITE, ext16px, 14);
+		GuiDrawChar(0x20 + (content[0] - '0'), 223, 108, BLACK, WHITE, ext16px, 14);
 	}else {
 		GuiDrawChar('X', (xpos + 8), 110, BLACK, WHITE, eng12px, 12);
 		if(POWER_MODEM_SLEEP == status->syspowermode) {
@@ -117,5 +172,3 @@ void ICACHE_FLASH_ATTR invalidateForecast(Calendar *calendar, BasicWeather *weat
 		}
 	}
 }
-
-
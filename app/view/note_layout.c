@@ -16,41 +16,110 @@
 #include "utils/misc.h"
 #include "graphics/font.h"
 #include "graphics/displayio.h"
+#include "graphics/widget.h"
+#include "graphics/text_layout.h"
 
 #include "driver/ssd1675b.h"
 #include "controller/context.h"
 
+// 备忘录内容在文件节中的偏移
+#define NOTE_CONTENT_OFFSET    10
+
+static void ICACHE_FLASH_ATTR formatSignal(const Widget *widget, const void **sources, char *content);
+static void ICACHE_FLASH_ATTR formatNote(const Widget *widget, const void **sources, char *content);
+static void ICACHE_FLASH_ATTR drawHeader(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawNote(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawFooter(const Widget *widget, const void **sources, const char *content);
+static void ICACHE_FLASH_ATTR drawStatus(const Widget *widget, const void **sources, const char *content);
+
+static const Widget noteWidgets[] = {
+	// 城市名称，公历信息，室内温湿度
+	{{0, 0, 249, 12}, WIDGET_BITMAP, 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, cityName),
+		 WIDGET_BIND(WIDGET_SOURCE_CALENDAR, Calendar, calendarDesc),
+		 WIDGET_BIND(WIDGET_SOURCE_STATUS, StatusBar, temperature),
+		 WIDGET_BIND(WIDGET_SOURCE_WEATHER, BasicWeather, humidity)}, NULL, drawHeader},
+	// 备忘录内容，签名包含文件内容，便签修改后重绘，正文最多5行到106行为止
+	{{0, 13, 249, 107}, (WIDGET_BITMAP | WIDGET_STATIC), 0, 0, 0, {{0}}, formatNote, drawNote},
+	// footer 农历信息和时间
+	{{0, 110, 175, 121}, WIDGET_BITMAP, 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_CALENDAR, Calendar, lunarDesc),
+		 {WIDGET_SOURCE_CALENDAR, 2, WIDGET_OFFSET(Calendar, hour)}}, NULL, drawFooter},
+	// 电量和信号，只比较信号等级
+	{{176, 108, 249, 121}, WIDGET_BITMAP, 0, 0, 0,
+		{WIDGET_BIND(WIDGET_SOURCE_STATUS, StatusBar, batLevel),
+		 {WIDGET_SOURCE_STATUS, 2, WIDGET_OFFSET(StatusBar, sysopmode)}}, formatSignal, drawStatus},
+};
+
+static WidgetTree noteTree = {noteWidgets, (sizeof(noteWidgets) / sizeof(Widget)), FALSE, 2, 0, {0}};
+// 便签正文排版结果，便签内容不变时直接重放
+static TextLayout noteLayout;
+
 /**
- * @brief 刷新天气预报页面布局
+ * @brief 刷新备忘录页面布局
  * @param calendar 日期信息
  * @param weather 今日天气信息
- * @param weathers 预报天气数据集 数量为FORECAST_DAYS
  * @param status 状态栏信息，电量、信号强度、温湿度传感器
  * */
 void ICACHE_FLASH_ATTR invalidateNoteView(Calendar *calendar, BasicWeather *weather, StatusBar *status) {
-	const uint8_t limits[] = {90, 70, 40, 10, 0};
-	const uint8_t drawIconX[] = {0, 125, 0, 125};
-	const uint8_t drawIconY[] = {13, 13, 62, 62};
-	ForecastWeather *weatherPtr;
-	uint8_t buffer[256];
-	Font *chs12px, *chs16px, *eng16px, *eng12px, *ext16px;
-	int32_t cursor, xpos = 0, i;
-	char *iconFileName;
+	const void *sources[WIDGET_SOURCE_COUNT] = {calendar, weather, status, NULL};
+	WidgetTreeRender(&noteTree, sources);
+}
+
+/**
+ * @brief 读取备忘录内容，首字节'>'表示读取成功，之后为便签正文
+ * */
+static void ICACHE_FLASH_ATTR formatNote(const Widget *widget, const void **sources, char *content) {
 	fixed_file_t fixedFile;
 
-	chs12px = getFont(FONT12x12_CN);
-	chs16px = getFont(FONT16x16_CN);
-	eng16px = getFont(FONT08x16_EN);
-	eng12px = getFont(FONT06x12_EN);
-	ext16px = getFont(FONT08x16_EXT);
+	fixed_file_init(&fixedFile, FILE_NOTE_SECTION_SIZE, FILE_NOTE_MAX_SIZE);
+	if(fixed_file_open(&fixedFile, "note", "ini")
+			&& fixed_file_read(&fixedFile, (uint8_t *)content, FILE_NOTE_SECTION_SIZE) == FILE_NOTE_SECTION_SIZE) {
+		content[0] = '>';
+		os_memmove((content + 1), (content + NOTE_CONTENT_OFFSET), (FILE_NOTE_SECTION_SIZE - NOTE_CONTENT_OFFSET));
+		content[FILE_NOTE_SECTION_SIZE - NOTE_CONTENT_OFFSET] = '\0';
+	}else {
+		content[0] = '\0';
+	}
+}
+
+static void ICACHE_FLASH_ATTR drawNote(const Widget *widget, const void **sources, const char *content) {
+	// 每行有3个像素的间距 // 15 34 53 72 91
+	const Rect box = {0, 15, 249, 107};
+	Font *chs16px = getFont(FONT16x16_CN), *eng16px = getFont(FONT08x16_EN);
 
-	EPDDisplayClear();
+	if(content[0] == '>') {
+		TextLayoutUpdate(&noteLayout, (uint8_t *)(content + 1), &box, chs16px, eng16px, 3);
+		TextLayoutDraw(&noteLayout, chs16px, eng16px);
+		return;
+	}
+	chs16px->vspacing = 3;
+	GuiDrawStringUTF8("》备忘录中没有内容《", 40, 23, chs16px, eng16px);
+	GuiDrawStringUTF8("请打开“天气站”APP，在“页面管理”->“备忘录”中添加笔记。", 0, 48, chs16px, eng16px);
+	chs16px->vspacing = 0;
+}
+
+static void ICACHE_FLASH_ATTR formatSignal(const Widget *widget, const void **sources, char *content) {
+	const StatusBar *status = sources[WIDGET_SOURCE_STATUS];
+	if(status->sysopmode == STATION_MODE && status->syspowermode == POWER_NONE_SLEEP) {
+		content[0] = '0' + calculateSignalLevel(status->rssi, MAX_LEVEL);
+		content[1] = '\0';
+	}
+}
+
+static void ICACHE_FLASH_ATTR drawHeader(const Widget *widget, const void **sources, const char *content) {
+	const Calendar *calendar = sources[WIDGET_SOURCE_CALENDAR];
+	const BasicWeather *weather = sources[WIDGET_SOURCE_WEATHER];
+	const StatusBar *status = sources[WIDGET_SOURCE_STATUS];
+	Font *chs12px = getFont(FONT12x12_CN), *eng16px = getFont(FONT08x16_EN);
+	uint8_t buffer[16];
+	int32_t xpos, j;
 
 	// 城市名称限制2个字
 	os_memset(buffer, 0x00, sizeof(buffer));
 	os_strncpy(buffer, weather->cityName, 6);
 	xpos = GuiDrawStringUTF8(buffer, 0, 0, chs12px, eng16px);
-	xpos = GuiDrawStringUTF8(calendar->calendarDesc, (xpos + 4), 0, chs12px, eng16px);
+	xpos = GuiDrawStringUTF8((uint8_t *)calendar->calendarDesc, (xpos + 4), 0, chs12px, eng16px);
 	// 室内图标
 	GuiDrawBmpImage("home", "bmp", (xpos), 0);
 	// 温度支持范围-9 ~ 99，小于0度只能显示低位, 大于0度显示2位
@@ -58,32 +127,20 @@ void ICACHE_FLASH_ATTR invalidateNoteView(Calendar *calendar, BasicWeather *weat
 	buffer[1] = '0' + (status->temperature % 10);
 	os_strcpy((buffer + 2), "'C/");
 	// 湿度总是正数 限制显示范围00~99
-	i = (weather->humidity > 99) ? 99 : weather->humidity;
-	buffer[5] = '0' + (i / 10);
-	buffer[6] = '0' + (i % 10);
+	j = (weather->humidity > 99) ? 99 : weather->humidity;
+	buffer[5] = '0' + (j / 10);
+	buffer[6] = '0' + (j % 10);
 	os_strcpy((buffer + 7), "%RH");
-	GuiDrawString(buffer, (xpos + 12), 0, chs12px, eng12px);
+	GuiDrawString(buffer, (xpos + 12), 0, chs12px, getFont(FONT06x12_EN));
+}
 
-	i = 0;
-	fixed_file_init(&fixedFile, FILE_NOTE_SECTION_SIZE, FILE_NOTE_MAX_SIZE);
-	if(fixed_file_open(&fixedFile, "note", "ini")) {
-		// note content
-		if(fixed_file_read(&fixedFile, buffer, FILE_NOTE_SECTION_SIZE) == FILE_NOTE_SECTION_SIZE) {
-			i = 1;
-		}
-	}
-	chs16px->vspacing = 3;
-	if(i) {
-		// 每行有3个像素的间距 // 15 34 53 72 91
-		GuiDrawStringUTF8((buffer + 10), 0, 15, chs16px, eng16px);
-	}else {
-		GuiDrawStringUTF8("》备忘录中没有内容《", 40, 23, chs16px, eng16px);
-		GuiDrawStringUTF8("请打开“天气站”APP，在“页面管理”->“备忘录”中添加笔记。", 0, 48, chs16px, eng16px);
-	}
-	chs16px->vspacing = 0;
+static void ICACHE_FLASH_ATTR drawFooter(const Widget *widget, const void **sources, const char *content) {
+	const Calendar *calendar = sources[WIDGET_SOURCE_CALENDAR];
+	Font *chs12px = getFont(FONT12x12_CN), *eng16px = getFont(FONT08x16_EN);
+	uint8_t buffer[8];
+	int32_t xpos;
 
-	// footer
-	xpos = GuiDrawStringUTF8(calendar->lunarDesc, 0, 110, chs12px, eng16px);
+	xpos = GuiDrawStringUTF8((uint8_t *)calendar->lunarDesc, 0, 110, chs12px, eng16px);
 
 	buffer[0] = '0' + (calendar->hour / 10);
 	buffer[1] = '0' + (calendar->hour % 10);
@@ -94,8 +151,15 @@ void ICACHE_FLASH_ATTR invalidateNoteView(Calendar *calendar, BasicWeather *weat
 	buffer[1] = '0' + (calendar->minute % 10);
 	buffer[2] = '\0';
 	GuiDrawStringUTF8(buffer, (xpos - 4), 110, chs12px, eng16px);
+}
+
+static void ICACHE_FLASH_ATTR drawStatus(const Widget *widget, const void **sources, const char *content) {
+	const StatusBar *status = sources[WIDGET_SOURCE_STATUS];
+	const uint8_t limits[] = {90, 70, 40, 10, 0};
+	Font *eng12px = getFont(FONT06x12_EN), *ext16px = getFont(FONT08x16_EXT);
+	uint8_t buffer[8];
+	int32_t xpos = 176, i;
 
-	xpos = 176;
 	// 电量等级图标
 	for(i = 0; i < 5; i++) {
 		if(status->batLevel >= limits[i]) break;
@@ -104,7 +168,6 @@ void ICACHE_FLASH_ATTR invalidateNoteView(Calendar *calendar, BasicWeather *weat
 	buffer[3] = '0' + i;
 	buffer[4] = '\0';
 	GuiDrawBmpImage(buffer, "bmp", (xpos), 110);
-
 	// 电量等级数字
 	if(status->batLevel > 90) {
 		os_strcpy(buffer, "100%");
@@ -114,15 +177,13 @@ void ICACHE_FLASH_ATTR invalidateNoteView(Calendar *calendar, BasicWeather *weat
 	}else {
 		os_strcpy(buffer, "0%");
 	}
+	xpos = GuiDrawString(buffer, (xpos + 12), 110, getFont(FONT12x12_CN), eng12px);
 
-	xpos = GuiDrawString(buffer, (xpos + 12), 110, chs12px, eng12px);
-
-	// 国标特殊字符的信号图标，按照14高度绘制，屏幕空间不足
+	// 国标特殊字符的信号图标
 	GuiDrawChar(0x1F, (xpos), 108, BLACK, WHITE, ext16px, 14);
-	if(status->sysopmode == STATION_MODE && status->syspowermode == POWER_NONE_SLEEP) {
-		i = calculateSignalLevel(status->rssi, MAX_LEVEL);
+	if(content[0] != '\0') {
 		// 信号等级icon
-		GuiDrawChar(0x20 + i, 223, 108, BLACK, WHITE, ext16px, 14);
+		GuiDrawChar(0x20 + (content[0] - '0'), 223, 108, BLACK, WHITE, ext16px, 14);
 	}else {
 		GuiDrawChar('X', (xpos + 8), 110, BLACK, WHITE, eng12px, 12);
 		if(POWER_MODEM_SLEEP == status->syspowermode) {
@@ -132,4 +193,3 @@ void ICACHE_FLASH_ATTR invalidateNoteView(Calendar *calendar, BasicWeather *weat
 		}
 	}
 }
-
@@ -0,0 +1,158 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# bench_utf16_lut.py
+# 主机端统计QueryGB2312ByUnicode绘制一段便签文本时的文件访问次数，对比逐字符二分查找和采样索引+缓存
+# 用法: python3 bench_utf16_lut.py [utf16.lut] [note.txt]
+# 不指定utf16.lut时按GB2312字符集生成同格式查找表，不指定note.txt时使用内置的200字便签
+#
+# Created on: Oct 17, 2026
+# Author: Yanye
+
+import struct
+import sys
+
+# 与 app/include/utils/strings.h 保持一致
+UTF16_INDEX_STRIDE = 32
+UTF16_INDEX_SIZE = 256
+UTF16_MEMO_SIZE = 16
+
+NOTE = ('周末计划：早上七点起床，先去公园跑步半小时，然后回家做早饭。九点出发去图书馆还书，'
+        '顺便借两本关于电子墨水屏驱动和低功耗设计的书。中午和朋友在学校门口的小店吃面，'
+        '下午整理房间，把阳台上的花浇一遍水，检查天气站的电池电量，如果低于百分之二十就充电。'
+        '晚上记得给爸妈打电话，问问家里最近的天气怎么样，提醒他们降温了注意添衣保暖。'
+        '睡前看半小时书，十一点前休息，明天继续调试屏幕局部刷新的残影问题，记录每次刷新的耗时。')
+
+
+class Counter(object):
+    def __init__(self):
+        self.open = 0
+        self.read = 0
+        self.bytes = 0
+
+
+def make_lut():
+    """按GB2312字符集生成utf16.lut: 四字节一组，低两字节unicode，高两字节gb2312(大端)，按unicode升序"""
+    groups = {}
+    for high in range(0xA1, 0xF8):
+        for low in range(0xA1, 0xFF):
+            try:
+                ch = bytes([high, low]).decode('gb2312')
+            except UnicodeDecodeError:
+                continue
+            groups[ord(ch)] = (high << 8) | low
+    return b''.join(struct.pack('<HH', code, ((gb & 0xFF) << 8) | (gb >> 8)) for code, gb in sorted(groups.items()))
+
+
+class LutFile(object):
+    def __init__(self, data, counter):
+        self.data = data
+        self.length = len(data)
+        self.counter = counter
+
+    def read(self, offset, size):
+        self.counter.read += 1
+        self.counter.bytes += size
+        return self.data[offset:offset + size]
+
+
+def query_binary(lut, counter, unicode):
+    """原实现: 每次打开文件并在文件中二分查找，逐组读取"""
+    counter.open += 1
+    file = LutFile(lut, counter)
+    group = file.length // 4
+    middle = group // 2
+    end = group
+    start = -1
+    readin = 0
+    pack = 0
+    while True:
+        data = file.read(middle * 4, 4)
+        success = len(data) == 4
+        if success:
+            pack = struct.unpack('<I', data)[0]
+        if not success or middle <= 0 or middle >= (group - 1):
+            break
+        readin = pack & 0xFFFF
+        if unicode < readin:
+            end = middle
+            middle -= (end - start) // 2
+        elif unicode > readin:
+            start = middle
+            middle += (end - start) // 2
+        if unicode == readin:
+            break
+    return (pack >> 16) & 0xFFFF
+
+
+class IndexedQuery(object):
+    """新实现: 首次使用建立采样索引，之后每次查询最多读取一段，最近转换字符直接命中"""
+
+    def __init__(self, lut, counter):
+        self.counter = counter
+        self.file = None
+        self.index = []
+        self.memo = [0] * UTF16_MEMO_SIZE
+        self.lut = lut
+
+    def build(self):
+        if self.file is not None:
+            return
+        self.counter.open += 1
+        self.file = LutFile(self.lut, self.counter)
+        self.groups = self.file.length // 4
+        buckets = (self.groups + UTF16_INDEX_STRIDE - 1) // UTF16_INDEX_STRIDE
+        assert 0 < buckets <= UTF16_INDEX_SIZE
+        for i in range(buckets):
+            self.index.append(struct.unpack('<I', self.file.read(i * UTF16_INDEX_STRIDE * 4, 4))[0] & 0xFFFF)
+
+    def query(self, unicode):
+        slot = unicode & (UTF16_MEMO_SIZE - 1)
+        pack = self.memo[slot]
+        if pack == 0 or (pack & 0xFFFF) != unicode:
+            self.build()
+            bucket = -1
+            for i, first in enumerate(self.index):
+                if first <= unicode:
+                    bucket = i
+            if bucket < 0:
+                return 0
+            count = min(UTF16_INDEX_STRIDE, self.groups - bucket * UTF16_INDEX_STRIDE)
+            data = self.file.read(bucket * UTF16_INDEX_STRIDE * 4, count * 4)
+            groups = struct.unpack('<%dI' % count, data)
+            found = [g for g in groups if (g & 0xFFFF) == unicode]
+            if not found:
+                return 0
+            pack = found[0]
+            self.memo[slot] = pack
+        return (pack >> 16) & 0xFFFF
+
+
+def main():
+    lut = open(sys.argv[1], 'rb').read() if len(sys.argv) > 1 else make_lut()
+    note = open(sys.argv[2], 'r', encoding='utf-8').read() if len(sys.argv) > 2 else NOTE
+    chars = [ord(c) for c in note if 0x7F < ord(c) <= 0xFFFF]
+
+    before, after = Counter(), Counter()
+    indexed = IndexedQuery(lut, after)
+    for code in chars:
+        old = query_binary(lut, before, code)
+        new = indexed.query(code)
+        if new != old and new != 0:
+            raise SystemExit('U+%04X mismatch: %04X != %04X' % (code, new, old))
+
+    print('lut: %d groups, note: %d non-ASCII characters (%d distinct)' % (len(lut) // 4, len(chars), len(set(chars))))
+    print('%-24s %8s %10s %12s' % ('', 'open_file', 'read_file', 'bytes read'))
+    print('%-24s %8d %10d %12d' % ('binary search (before)', before.open, before.read, before.bytes))
+    print('%-24s %8d %10d %12d' % ('index + memo (after)', after.open, after.read, after.bytes))
+    # 第二次绘制同一便签，索引已建立
+    redraw = Counter()
+    indexed.counter = redraw
+    indexed.file.counter = redraw
+    for code in chars:
+        indexed.query(code)
+    print('%-24s %8d %10d %12d' % ('index + memo (redraw)', redraw.open, redraw.read, redraw.bytes))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,37 @@
+/*
+ * host.h
+ * @brief 主机端测试公用定义
+ * @note 固件源码按ESP8266头文件编译(32位size_t)，不包含主机libc头文件，所需函数在此声明
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#ifndef _HOST_H_
+#define _HOST_H_
+
+#include "c_types.h"
+
+int printf(const char *format, ...);
+int rand(void);
+void srand(unsigned int seed);
+
+// 检查失败时输出位置和说明，不中断测试
+#define HOST_CHECK(cond, ...) \
+do{ \
+	if(!(cond)) { \
+		hostFailures++; \
+		printf("FAIL %s:%d: ", __FILE__, __LINE__); \
+		printf(__VA_ARGS__); \
+		printf("\n"); \
+	} \
+}while(0)
+
+extern int hostFailures;
+
+// 单调时钟(ns)，用于主机端基准测试
+uint64_t HostTimeNs(void);
+
+// 输出测试结果，返回main的退出码
+int HostReport(const char *name);
+
+#endif /* _HOST_H_ */
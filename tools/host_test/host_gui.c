@@ -0,0 +1,181 @@
+/*
+ * host_gui.c
+ * @brief 绘制相关主机端测试的公用桩函数: EPD硬件接口为空操作，spifs由内存文件表实现
+ * @note 在测试的SOURCES中列出tools/host_test/host_gui.c，需要检查spi传输的测试(test_epd_window)自行实现硬件接口
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#include "host.h"
+#include "host_gui.h"
+#include "osapi.h"
+#include "user_interface.h"
+#include "driver/ssd1675b.h"
+#include "spifsmini/spifs.h"
+
+#define HOST_FILES_MAX    16
+
+typedef struct _host_file {
+	File file;
+	const uint8_t *data;
+} HostFile;
+
+static HostFile hostFiles[HOST_FILES_MAX];
+static uint32_t hostFileCount = 0;
+static uint32_t hostFileReads = 0;
+static uint32_t hostFileCreates = 0;
+
+uint32_t hostFreeHeap = 40 * 1024;
+
+void gpio_output_set(uint32 set_mask, uint32 clear_mask, uint32 enable_mask, uint32 disable_mask) {
+}
+
+uint32 gpio_input_get(void) {
+	return 0;
+}
+
+void gpio_pin_intr_state_set(uint32 i, GPIO_INT_TYPE intr_state) {
+}
+
+void gpio16_output_conf(void) {
+}
+
+void gpio16_output_set(uint8 value) {
+}
+
+void UserButtonAddPinIRQListener(uint8_t pin, PinIRQListener listener) {
+}
+
+void SPIInit(SpiNum spiNum, SpiAttr *pAttr) {
+}
+
+int32_t SPIMasterSendData(SpiNum spiNum, SpiData *pInData) {
+	return 0;
+}
+
+int32_t SPIMasterSendBurst(SpiNum spiNum, const uint8_t *data, uint32_t length) {
+	return 0;
+}
+
+bool system_os_task(os_task_t task, uint8 prio, os_event_t *queue, uint8 qlen) {
+	return TRUE;
+}
+
+bool system_os_post(uint8 prio, os_signal_t sig, os_param_t par) {
+	return TRUE;
+}
+
+uint32 system_get_free_heap_size(void) {
+	return hostFreeHeap;
+}
+
+static void HostEventPost(uint32_t eventId, uint32_t arg) {
+}
+
+static EventBus hostBus = {NULL, NULL, NULL, HostEventPost};
+
+EventBus *EventBusGetDefault(void) {
+	return &hostBus;
+}
+
+/**
+ * @brief 添加只读内存文件，data在测试期间保持有效
+ * */
+void HostAddFile(const char *filename, const char *extname, const uint8_t *data, uint32_t length) {
+	HostFile *entry;
+	if(hostFileCount >= HOST_FILES_MAX) {
+		return;
+	}
+	entry = (hostFiles + hostFileCount);
+	make_file(&entry->file, (char *)filename, (char *)extname);
+	entry->file.block = hostFileCount;
+	entry->file.length = length;
+	entry->data = data;
+	hostFileCount++;
+}
+
+uint32_t HostFileReads(void) {
+	return hostFileReads;
+}
+
+uint32_t HostFileCreates(void) {
+	return hostFileCreates;
+}
+
+BOOL make_file(File *file, char *filename, char *extname) {
+	uint32_t i;
+	os_memset(file, 0xFF, sizeof(File));
+	for(i = 0; i < sizeof(file->filename) && filename[i] != '\0'; i++) {
+		file->filename[i] = filename[i];
+	}
+	for(i = 0; i < sizeof(file->extname) && extname[i] != '\0'; i++) {
+		file->extname[i] = extname[i];
+	}
+	return TRUE;
+}
+
+BOOL open_file(File *file, char *filename, char *extname) {
+	uint32_t i;
+	File temp;
+	make_file(&temp, filename, extname);
+	for(i = 0; i < hostFileCount; i++) {
+		if(os_memcmp(hostFiles[i].file.filename, temp.filename, sizeof(temp.filename) + sizeof(temp.extname)) == 0) {
+			os_memcpy(file, &hostFiles[i].file, sizeof(File));
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+uint32_t read_file(File *file, uint32_t offset, uint8_t *buffer, uint32_t size) {
+	HostFile *entry;
+	if(file->block >= hostFileCount || offset >= file->length) {
+		return 0;
+	}
+	entry = (hostFiles + file->block);
+	if(size > (file->length - offset)) {
+		size = (file->length - offset);
+	}
+	os_memcpy(buffer, (entry->data + offset), size);
+	hostFileReads++;
+	return size;
+}
+
+BOOL open_reader(FileReader *reader, File *file, uint8_t *buffer, uint32_t capacity) {
+	os_memset(reader, 0x00, sizeof(FileReader));
+	reader->file = file;
+	reader->buffer = buffer;
+	reader->capacity = capacity;
+	return (file->block < hostFileCount);
+}
+
+void seek_reader(FileReader *reader, uint32_t position) {
+	reader->position = position;
+}
+
+uint32_t read_reader(FileReader *reader, uint8_t *buffer, uint32_t length) {
+	uint32_t size = read_file(reader->file, reader->position, buffer, length);
+	reader->position += size;
+	return size;
+}
+
+// 测试中不写入文件
+BOOL make_finfo(FileInfo *finfo, uint32_t year, uint8_t month, uint8_t day, uint8_t fstate) {
+	return FALSE;
+}
+
+Result create_file(File *file, FileInfo *finfo) {
+	hostFileCreates++;
+	return NO_FILEBLOCK_SPACE;
+}
+
+Result write_file(File *file, uint8_t *buffer, uint32_t size, WriteMethod method) {
+	return NO_FILEBLOCK_SPACE;
+}
+
+Result write_finish(File *file) {
+	return NO_FILEBLOCK_SPACE;
+}
+
+void delete_file(File *file) {
+}
@@ -0,0 +1,23 @@
+/*
+ * host_gui.h
+ * @brief host_gui.c提供的内存文件表和模拟堆大小
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#ifndef _HOST_GUI_H_
+#define _HOST_GUI_H_
+
+#include "c_types.h"
+
+// system_get_free_heap_size返回值
+extern uint32_t hostFreeHeap;
+
+void HostAddFile(const char *filename, const char *extname, const uint8_t *data, uint32_t length);
+
+// read_file调用次数
+uint32_t HostFileReads(void);
+// create_file调用次数
+uint32_t HostFileCreates(void);
+
+#endif /* _HOST_GUI_H_ */
@@ -0,0 +1,134 @@
+/*
+ * host_sdk.c
+ * @brief 主机端测试使用的SDK函数实现，只提供与硬件无关的部分
+ * @note 硬件相关的函数(gpio/spi/flash)由各测试按需实现
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#include "host.h"
+#include "osapi.h"
+#include "mem.h"
+
+int vprintf(const char *format, __builtin_va_list args);
+int vsprintf(char *str, const char *format, __builtin_va_list args);
+int vsnprintf(char *str, unsigned long size, const char *format, __builtin_va_list args);
+
+struct host_timespec {
+	long tv_sec;
+	long tv_nsec;
+};
+int clock_gettime(int clock, struct host_timespec *ts);
+#define HOST_CLOCK_MONOTONIC    1
+
+int hostFailures = 0;
+
+uint64_t HostTimeNs(void) {
+	struct host_timespec ts;
+	clock_gettime(HOST_CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+int HostReport(const char *name) {
+	printf("%s: %s\n", name, (hostFailures == 0) ? "PASS" : "FAIL");
+	return (hostFailures == 0) ? 0 : 1;
+}
+
+void *ets_memcpy(void *dest, const void *src, unsigned int nbyte) {
+	return __builtin_memcpy(dest, src, nbyte);
+}
+
+void *ets_memmove(void *dest, const void *src, unsigned int nbyte) {
+	return __builtin_memmove(dest, src, nbyte);
+}
+
+void *ets_memset(void *dest, int val, unsigned int nbyte) {
+	return __builtin_memset(dest, val, nbyte);
+}
+
+int ets_memcmp(const void *str1, const void *str2, unsigned int nbyte) {
+	return __builtin_memcmp(str1, str2, nbyte);
+}
+
+void ets_bzero(void *s, size_t n) {
+	__builtin_memset(s, 0, n);
+}
+
+int ets_strcmp(const char *s1, const char *s2) {
+	return __builtin_strcmp(s1, s2);
+}
+
+char *ets_strcpy(char *s1, const char *s2) {
+	return __builtin_strcpy(s1, s2);
+}
+
+int ets_strlen(const char *s) {
+	return (int)__builtin_strlen(s);
+}
+
+int ets_strncmp(const char *s1, const char *s2, unsigned int n) {
+	return __builtin_strncmp(s1, s2, n);
+}
+
+char *ets_strncpy(char *s1, const char *s2, unsigned int n) {
+	return __builtin_strncpy(s1, s2, n);
+}
+
+char *ets_strstr(const char *s1, const char *s2) {
+	return __builtin_strstr(s1, s2);
+}
+
+int os_printf_plus(const char *format, ...) {
+	__builtin_va_list args;
+	int ret;
+	__builtin_va_start(args, format);
+	ret = vprintf(format, args);
+	__builtin_va_end(args);
+	return ret;
+}
+
+int ets_sprintf(char *str, const char *format, ...) {
+	__builtin_va_list args;
+	int ret;
+	__builtin_va_start(args, format);
+	ret = vsprintf(str, format, args);
+	__builtin_va_end(args);
+	return ret;
+}
+
+int ets_snprintf(char *str, unsigned int size, const char *format, ...) {
+	__builtin_va_list args;
+	int ret;
+	__builtin_va_start(args, format);
+	ret = vsnprintf(str, size, format, args);
+	__builtin_va_end(args);
+	return ret;
+}
+
+void *pvPortMalloc(size_t sz, const char *file, unsigned line, bool iram) {
+	return __builtin_malloc(sz);
+}
+
+void *pvPortZalloc(size_t sz, const char *file, unsigned line) {
+	return __builtin_calloc(1, sz);
+}
+
+void vPortFree(void *p, const char *file, unsigned line) {
+	__builtin_free(p);
+}
+
+void ets_delay_us(uint32_t us) {
+}
+
+uint32 system_get_time(void) {
+	return (uint32)(HostTimeNs() / 1000);
+}
+
+void ets_timer_arm_new(os_timer_t *ptimer, uint32_t time, bool repeat_flag, bool ms_flag) {
+}
+
+void ets_timer_disarm(os_timer_t *ptimer) {
+}
+
+void ets_timer_setfn(os_timer_t *ptimer, os_timer_func_t *pfunction, void *parg) {
+}
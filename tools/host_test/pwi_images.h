@@ -0,0 +1,121 @@
+/*
+ * pwi_images.h
+ * @brief test_pwi_image使用的bmp图片和由tools/make_pwi.py转换的pwi图片
+ * @note icon: 100x48，左侧48列空白，pwi为RLE压缩，含2字节长度的连续段，连续段跨列；
+ *       noise: 21x13，无连续段，pwi为未压缩数据。bmp由以下脚本生成:
+ *       python3 - <<'EOF'
+ *       import struct
+ *       def bmp(name, w, h, black):
+ *           stride = (w + 31) // 32 * 4
+ *           data = b''.join(bytes(sum((0 if black(x, y) else 1) << (7 - (x & 7)) for x in range(c * 8, min(c * 8 + 8, w))) for c in range(stride)) for y in reversed(range(h)))
+ *           head = b'BM' + struct.pack('<IHHI', 62 + len(data), 0, 0, 62) + struct.pack('<IiiHHIIiiII', 40, w, h, 1, 1, 0, len(data), 2835, 2835, 2, 0)
+ *           open(name + '.bmp', 'wb').write(head + b'\x00\x00\x00\x00\xff\xff\xff\x00' + data)
+ *       bmp('icon', 100, 48, lambda x, y: x >= 48 and (x in (48, 99) or y in (0, 47) or (x - 74) ** 2 + (y - 24) ** 2 < 200 or x - 50 == y))
+ *       bmp('noise', 21, 13, lambda x, y: (x * 37 + y * 91 + x * y * 13) >> 2 & 1)
+ *       EOF
+ *       python3 tools/make_pwi.py icon.bmp noise.bmp
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#ifndef _PWI_IMAGES_H_
+#define _PWI_IMAGES_H_
+
+#include "c_types.h"
+
+static const uint8_t iconBmp[] = {
+	0x42, 0x4D, 0x3E, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3E, 0x00, 0x00, 0x00, 0x28, 0x00,
+	0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x13, 0x0B, 0x00, 0x00, 0x13, 0x0B, 0x00, 0x00, 0x02, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x60, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFD, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFB, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xF7, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xDF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xBF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xFF, 0x8F, 0xFF, 0x7F, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xF8, 0x00, 0xFE, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xE0, 0x00, 0x3D, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0xC0, 0x00, 0x1B, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0x80, 0x00, 0x07, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0x00, 0x00, 0x07, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFE, 0x00, 0x00, 0x03, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFC, 0x00, 0x00, 0x01, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFC, 0x00, 0x00, 0x01, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF8, 0x00, 0x00, 0x00, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF8, 0x00, 0x00, 0x00, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF8, 0x00, 0x00, 0x00, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF8, 0x00, 0x00, 0x00, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF0, 0x00, 0x00, 0x00, 0x7F, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF0, 0x00, 0x00, 0x00, 0x7F, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF0, 0x00, 0x00, 0x00, 0x7F, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF8, 0x00, 0x00, 0x00, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF8, 0x00, 0x00, 0x00, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF8, 0x00, 0x00, 0x00, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF8, 0x00, 0x00, 0x00, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFC, 0x00, 0x00, 0x01, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFC, 0x00, 0x00, 0x01, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFE, 0x00, 0x00, 0x03, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0x00, 0x00, 0x07, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFF, 0x00, 0x00, 0x0F, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFE, 0xC0, 0x00, 0x1F, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFD, 0xE0, 0x00, 0x3F, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xFB, 0xF8, 0x00, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xF7, 0xFF, 0x8F, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xEF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xDF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0xBF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7F, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7E, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7D, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x7B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x77, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x6F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xE0, 0x00, 0x00, 0x00, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const uint8_t iconPwi[] = {
+	0x50, 0x57, 0x49, 0x00, 0x01, 0x01, 0x64, 0x00, 0x30, 0x00, 0x00, 0x00, 0xFF, 0x00, 0x20, 0x01,
+	0x00, 0x06, 0x7F, 0xFF, 0x04, 0xFE, 0x7F, 0xFF, 0x04, 0xFE, 0x3F, 0xFF, 0x04, 0xFE, 0x5F, 0xFF,
+	0x04, 0xFE, 0x6F, 0xFF, 0x04, 0xFE, 0x77, 0xFF, 0x04, 0xFE, 0x7B, 0xFF, 0x04, 0xFE, 0x7D, 0xFF,
+	0x04, 0xFE, 0x7E, 0xFF, 0x04, 0xFE, 0x7F, 0x7F, 0xFF, 0x03, 0xFE, 0x7F, 0xBF, 0xFF, 0x03, 0xFE,
+	0x7F, 0xDF, 0xFE, 0x3F, 0xFF, 0x01, 0xFE, 0x7F, 0xEF, 0xE0, 0x03, 0xFF, 0x01, 0xFE, 0x7F, 0xF7,
+	0x80, 0x00, 0x01, 0xFF, 0x01, 0xFE, 0x7F, 0xFB, 0x00, 0x02, 0x7F, 0xFE, 0x7F, 0xFC, 0x00, 0x02,
+	0x3F, 0xFE, 0x7F, 0xFC, 0x00, 0x02, 0x1F, 0xFE, 0x7F, 0xF8, 0x00, 0x02, 0x0F, 0xFE, 0x7F, 0xF0,
+	0x00, 0x02, 0x07, 0xFE, 0x7F, 0xF0, 0x00, 0x02, 0x07, 0xFE, 0x7F, 0xE0, 0x00, 0x02, 0x03, 0xFE,
+	0x7F, 0xE0, 0x00, 0x02, 0x03, 0xFE, 0x7F, 0xE0, 0x00, 0x02, 0x03, 0xFE, 0x7F, 0xE0, 0x00, 0x02,
+	0x03, 0xFE, 0x7F, 0xC0, 0x00, 0x02, 0x01, 0xFE, 0x7F, 0xC0, 0x00, 0x02, 0x01, 0xFE, 0x7F, 0xC0,
+	0x00, 0x02, 0x01, 0xFE, 0x7F, 0xE0, 0x00, 0x02, 0x03, 0xFE, 0x7F, 0xE0, 0x00, 0x02, 0x03, 0xFE,
+	0x7F, 0xE0, 0x00, 0x02, 0x03, 0xFE, 0x7F, 0xE0, 0x00, 0x02, 0x03, 0xFE, 0x7F, 0xF0, 0x00, 0x02,
+	0x07, 0xFE, 0x7F, 0xF0, 0x00, 0x02, 0x07, 0xFE, 0x7F, 0xF8, 0x00, 0x02, 0x0F, 0xFE, 0x7F, 0xFC,
+	0x00, 0x02, 0x1F, 0xFE, 0x7F, 0xFE, 0x00, 0x02, 0x1F, 0xFE, 0x7F, 0xFF, 0x01, 0x00, 0x02, 0x6F,
+	0xFE, 0x7F, 0xFF, 0x01, 0x80, 0x00, 0x01, 0xF7, 0xFE, 0x7F, 0xFF, 0x01, 0xE0, 0x03, 0xFB, 0xFE,
+	0x7F, 0xFF, 0x01, 0xFE, 0x3F, 0xFD, 0xFE, 0x7F, 0xFF, 0x03, 0xFE, 0xFE, 0x7F, 0xFF, 0x04, 0x7E,
+	0x7F, 0xFF, 0x04, 0xBE, 0x7F, 0xFF, 0x04, 0xDE, 0x7F, 0xFF, 0x04, 0xEE, 0x7F, 0xFF, 0x04, 0xF6,
+	0x7F, 0xFF, 0x04, 0xFA, 0x7F, 0xFF, 0x04, 0xFC, 0x7F, 0xFF, 0x04, 0xFE, 0x7F, 0xFF, 0x04, 0xFE,
+	0x00, 0x06,
+};
+
+static const uint8_t noiseBmp[] = {
+	0x42, 0x4D, 0x72, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x3E, 0x00, 0x00, 0x00, 0x28, 0x00,
+	0x00, 0x00, 0x15, 0x00, 0x00, 0x00, 0x0D, 0x00, 0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x34, 0x00, 0x00, 0x00, 0x13, 0x0B, 0x00, 0x00, 0x13, 0x0B, 0x00, 0x00, 0x02, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0x00, 0x0F, 0x0F,
+	0x08, 0x00, 0xAA, 0xAA, 0xA8, 0x00, 0x1E, 0x1E, 0x18, 0x00, 0x99, 0x99, 0x98, 0x00, 0xA5, 0xA5,
+	0xA0, 0x00, 0x00, 0x00, 0x00, 0x00, 0xB4, 0xB4, 0xB0, 0x00, 0x33, 0x33, 0x30, 0x00, 0x0F, 0x0F,
+	0x08, 0x00, 0xAA, 0xAA, 0xA8, 0x00, 0x1E, 0x1E, 0x18, 0x00, 0x99, 0x99, 0x98, 0x00, 0xA5, 0xA5,
+	0xA0, 0x00,
+};
+
+static const uint8_t noisePwi[] = {
+	0x50, 0x57, 0x49, 0x00, 0x01, 0x00, 0x15, 0x00, 0x0D, 0x00, 0x00, 0x00, 0xD2, 0xD0, 0x00, 0x00,
+	0x96, 0x90, 0x66, 0x60, 0x78, 0x78, 0xAA, 0xA8, 0x3C, 0x38, 0xCC, 0xC8, 0xD2, 0xD0, 0x00, 0x00,
+	0x96, 0x90, 0x66, 0x60, 0x78, 0x78, 0xAA, 0xA8, 0x3C, 0x38, 0xCC, 0xC8, 0xD2, 0xD0, 0x00, 0x00,
+	0x96, 0x90, 0x66, 0x60, 0x78, 0x78,
+};
+
+#endif /* _PWI_IMAGES_H_ */
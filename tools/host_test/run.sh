@@ -0,0 +1,41 @@
+#!/bin/sh
+#
+# run.sh
+# 主机端测试，固件源码由主机gcc按ESP8266头文件编译，SDK函数由host_sdk.c和测试内的桩函数提供
+# 用法: ./run.sh [test_xxx ...]，不指定时运行全部test_*.c
+# 每个测试文件用 "// SOURCES:" 注释行列出需要一起编译的固件源文件(相对仓库根目录)
+#
+# Created on: Oct 17, 2026
+# Author: Yanye
+
+cd "$(dirname "$0")" || exit 1
+ROOT=../..
+OUT=${OUT:-build}
+CC=${CC:-gcc}
+# 与xtensa目标一致按32位编译，主机没有32位运行库时退回本机位宽(shim中size_t仍为32位)
+M32=-m32
+mkdir -p "$OUT"
+if ! echo 'int main(void){return 0;}' | $CC -m32 -x c -o "$OUT/.m32" - 2>/dev/null; then
+	echo "note: $CC cannot link -m32 programs, building 64-bit host tests"
+	M32=
+fi
+# 固件源码同样按-Wall编译，新增的警告在测试输出中可见
+CFLAGS="-O2 $M32 -Wall -Wno-unknown-pragmas -nostdinc -isystem shim -isystem $($CC -print-file-name=include) -DICACHE_FLASH \
+	-I. -I$ROOT/include -I$ROOT/app/include -I$ROOT/app/include/driver -I$ROOT/app/include/graphics"
+
+if [ $# -eq 0 ]; then
+	set -- $(ls test_*.c | sed 's/\.c$//')
+fi
+
+failed=0
+for name in "$@"; do
+	name=${name%.c}
+	sources=$(sed -n 's#^// SOURCES:##p' "$name.c" | sed "s#[^ ][^ ]*#$ROOT/&#g")
+	if ! $CC $CFLAGS -o "$OUT/$name" "$name.c" host_sdk.c $sources; then
+		echo "$name: BUILD FAILED"
+		failed=1
+		continue
+	fi
+	"$OUT/$name" || failed=1
+done
+exit $failed
@@ -0,0 +1,17 @@
+/*
+ * stddef.h
+ * @brief 主机端测试替代头文件，size_t与ESP8266工具链(newlib)一致为32位，避免与c_types.h冲突
+ */
+#ifndef _HOST_SHIM_STDDEF_H_
+#define _HOST_SHIM_STDDEF_H_
+
+typedef unsigned int size_t;
+typedef int ptrdiff_t;
+
+#ifndef NULL
+#define NULL ((void *)0)
+#endif
+
+#define offsetof(type, member) __builtin_offsetof(type, member)
+
+#endif /* _HOST_SHIM_STDDEF_H_ */
@@ -0,0 +1,17 @@
+/*
+ * string.h
+ * @brief 主机端测试替代头文件，固件中os_*字符串函数映射到ets_*，由host_sdk.c实现
+ */
+#ifndef _HOST_SHIM_STRING_H_
+#define _HOST_SHIM_STRING_H_
+
+#include <stddef.h>
+
+void *memcpy(void *dest, const void *src, size_t n);
+void *memset(void *dest, int val, size_t n);
+int memcmp(const void *s1, const void *s2, size_t n);
+size_t strlen(const char *s);
+char *strcat(char *dest, const char *src);
+char *strchr(const char *s, int c);
+
+#endif /* _HOST_SHIM_STRING_H_ */
@@ -0,0 +1,234 @@
+/*
+ * test_draw_char.c
+ * @brief GuiDrawChar按列写入与逐像素绘制的结果比较、主机端耗时和字模缓存命中率
+ * @note 参照实现为原GuiDrawChar: 每个字符从字体文件读取字模，逐像素调用EPDDrawHorizontal
+ *       字体文件为内存中的随机字模，只用于比较两种实现
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/driver/ssd1675b.c app/graphics/displayio.c app/graphics/font.c app/utils/strings.c tools/host_test/host_gui.c
+
+#include "host.h"
+#include "host_gui.h"
+#include "graphics/displayio.h"
+
+// GB2312字库字模数: 非汉字符号区846个 + 汉字区(0xB0~0xF7)72区 * 94
+#define GB2312_GLYPHS        (846 + 72 * 94)
+#define ASCII_GLYPHS         95
+#define CHAR_BENCH_ROUNDS    500
+// 同一页面逐帧重绘时字模缓存的最低命中率(%)
+#define CHAR_CACHE_HIT_MIN   90
+
+typedef void (*DrawCharFunc)(wchar ch, uint16_t x, uint16_t y, Color foreground, Color background, Font *font, uint16_t height);
+
+static uint8_t gb12[GB2312_GLYPHS * 24];
+static uint8_t gb16[GB2312_GLYPHS * 32];
+static uint8_t as12[ASCII_GLYPHS * 12];
+static uint8_t as16[ASCII_GLYPHS * 16];
+
+static uint8_t reference[EPD_HEIGHT * EPD_RAM_WIDTH];
+
+// 天气页面常见的文字，GB2312编码
+static const char *const pageText[] = {
+	"\xB1\xB1\xBE\xA9\xCA\xD0\xB3\xAF\xD1\xF4\xC7\xF8", // 北京市朝阳区
+	"2026-10-17 SAT",
+	"\xC7\xE7\xD7\xAA\xB6\xE0\xD4\xC6 26C/14C", // 晴转多云
+	"\xB6\xAB\xC4\xCF\xB7\xE7\xC8\xFD\xBC\xB6", // 东南风三级
+	"\xCF\xE0\xB6\xD4\xCA\xAA\xB6\xC8 65%", // 相对湿度
+	"\xBF\xD5\xC6\xF8\xD6\xCA\xC1\xBF\xC1\xBC AQI 42", // 空气质量良
+	"\xBD\xF1\xCC\xEC\xC3\xF7\xCC\xEC\xBA\xF3\xCC\xEC", // 今天明天后天
+	"\xD6\xDC\xD2\xBB\xD6\xDC\xB6\xFE\xD6\xDC\xC8\xFD\xD6\xDC\xCB\xC4\xD6\xDC\xCE\xE5\xD6\xDC\xC1\xF9\xD6\xDC\xC8\xD5", // 周一~周日
+	"\xD7\xCF\xCD\xE2\xCF\xDF\xC7\xBF\xB6\xC8\xD6\xD0\xB5\xC8", // 紫外线强度中等
+	"\xC8\xD5\xB3\xF6 06:21 \xC8\xD5\xC2\xE4 17:32", // 日出 日落
+	"\xD0\xA1\xD3\xEA\xD7\xAA\xD6\xD0\xD3\xEA", // 小雨转中雨
+};
+
+/**
+ * @brief 原EPDDrawHorizontal(不内联，与原实现跨文件调用一致)
+ * */
+static __attribute__((noinline)) void RefDrawHorizontal(uint16_t x, uint16_t y, uint8_t color) {
+	uint32_t byteIndex = ((EPD_HEIGHT - 1) << 4) + (y >> 3) - (x << 4);
+	uint8_t bitVal = (color & 0x1);
+	uint8_t shift = (7 - (y & 0x7));
+
+	*(reference + byteIndex) &= ~((uint8_t)1 << shift);
+	*(reference + byteIndex) |= (bitVal << shift);
+}
+
+/**
+ * @brief 原GuiDrawChar，每次从字体文件读取字模
+ * */
+static void RefDrawChar(wchar ch, uint16_t x, uint16_t y, Color foreground, Color background, Font *font, uint16_t height) {
+	uint32_t j, i;
+	uint32_t bitmapline;
+	uint8_t buffer[FONTBITMAP_BUFFER_SIZE];
+
+	if((ch < font->startChar) || (ch > font->endChar)) {
+		return;
+	}
+	if(!read_file(FontGetFile(font), (font->baseAddr + font->calcOffset(font, ch)), buffer, (font->lineBytes * font->height))) {
+		os_memset(buffer, 0x55, (sizeof(uint8_t) * FONTBITMAP_BUFFER_SIZE));
+	}
+	for(j = 0; j < height; j++) {
+		bitmapline = 0;
+		os_memcpy(&bitmapline, (buffer + j * font->lineBytes), font->lineBytes);
+		bitmapline = font->endianSwap(bitmapline);
+		for(i = 1; i <= font->width; i++) {
+			if((bitmapline >> (font->lineBytes * 8 - i)) & 0x1) {
+				RefDrawHorizontal(x + i, y + j, foreground);
+			}else {
+				RefDrawHorizontal(x + i, y + j, background);
+			}
+		}
+	}
+}
+
+/**
+ * @brief 作为新页面绘制FONT_CACHE_SLOTS个不同的12点阵汉字
+ * */
+static void DrawSymbols(void) {
+	uint32_t i;
+	for(i = 0; i < FONT_CACHE_SLOTS; i++) {
+		GuiDrawChar((0xA1B0 + (i << 8)), 0, 0, BLACK, WHITE, getFont(FONT12x12_CN), 12);
+	}
+}
+
+/**
+ * @brief 逐行绘制pageText，偶数行使用12点阵字体，奇数行使用16点阵字体，超出屏幕底部后回到顶部
+ * @return 绘制的字符数
+ * */
+static uint32_t DrawPage(DrawCharFunc draw) {
+	uint32_t line, glyphs = 0;
+	uint16_t x, y = 0;
+	const uint8_t *str;
+	Font *cn, *en, *font;
+	wchar ch;
+
+	for(line = 0; line < (sizeof(pageText) / sizeof(pageText[0])); line++) {
+		cn = getFont((line & 0x1) ? FONT16x16_CN : FONT12x12_CN);
+		en = getFont((line & 0x1) ? FONT08x16_EN : FONT06x12_EN);
+		if((y + cn->height) > SCREEN_HEIGHT) {
+			y = 0;
+		}
+		x = 0;
+		for(str = (const uint8_t *)pageText[line]; *str != '\0'; ) {
+			if(*str >= 0xA1) {
+				ch = (*str | (*(str + 1) << 8));
+				font = cn;
+				str += 2;
+			}else {
+				ch = *str;
+				font = en;
+				str++;
+			}
+			if((x + font->width) >= SCREEN_WIDTH) {
+				break;
+			}
+			draw(ch, x, y, BLACK, WHITE, font, font->height);
+			x += font->width;
+			glyphs++;
+		}
+		y += cn->height;
+	}
+	return glyphs;
+}
+
+static void FillRandom(uint8_t *data, uint32_t length) {
+	uint32_t i;
+	for(i = 0; i < length; i++) {
+		data[i] = (uint8_t)rand();
+	}
+}
+
+int main(void) {
+	uint8_t *buffer;
+	uint32_t i, glyphs = 0, refReads, newReads;
+	uint64_t start, refNs, coldNs, warmNs;
+	FontCacheStats before, after;
+
+	srand(1675);
+	FillRandom(gb12, sizeof(gb12));
+	FillRandom(gb16, sizeof(gb16));
+	FillRandom(as12, sizeof(as12));
+	FillRandom(as16, sizeof(as16));
+	HostAddFile("GB231212", "bin", gb12, sizeof(gb12));
+	HostAddFile("GB231216", "bin", gb16, sizeof(gb16));
+	HostAddFile("AS06_12", "bin", as12, sizeof(as12));
+	HostAddFile("AS08_16", "bin", as16, sizeof(as16));
+
+	HOST_CHECK(EPDDisplayRAMInit() == OK, "framebuffer allocation failed");
+	buffer = EPDGetDisplayRAM();
+	loadFont();
+
+	// 同一页面文字两种实现的显存逐字节一致
+	memset(reference, 0xFF, sizeof(reference));
+	glyphs = DrawPage(RefDrawChar);
+	HOST_CHECK(DrawPage(GuiDrawChar) == glyphs, "glyph count differs");
+	HOST_CHECK(memcmp(reference, buffer, sizeof(reference)) == 0, "page text differs from the per-pixel glyph blit");
+	// 裁掉底部的字符(GB64SP的14像素高度)和反色
+	RefDrawChar('A', 100, 100, BLACK, WHITE, getFont(FONT08x16_EN), 14);
+	GuiDrawChar('A', 100, 100, BLACK, WHITE, getFont(FONT08x16_EN), 14);
+	RefDrawChar(0xA1B0, 120, 3, WHITE, BLACK, getFont(FONT12x12_CN), 12);
+	GuiDrawChar(0xA1B0, 120, 3, WHITE, BLACK, getFont(FONT12x12_CN), 12);
+	HOST_CHECK(memcmp(reference, buffer, sizeof(reference)) == 0, "clipped/inverted glyph differs from the per-pixel glyph blit");
+
+	// 主机端耗时，仅用于比较两种实现，不代表ESP8266上的绝对速度
+	refReads = HostFileReads();
+	start = HostTimeNs();
+	for(i = 0; i < CHAR_BENCH_ROUNDS; i++) {
+		DrawPage(RefDrawChar);
+	}
+	refNs = HostTimeNs() - start;
+	refReads = HostFileReads() - refReads;
+
+	// 冷缓存: 每轮清空字模缓存
+	start = HostTimeNs();
+	for(i = 0; i < CHAR_BENCH_ROUNDS; i++) {
+		FontCacheClear();
+		DrawPage(GuiDrawChar);
+	}
+	coldNs = HostTimeNs() - start;
+
+	// 热缓存: 每轮为GuiRender的一帧
+	FontCacheGetStats(&before);
+	newReads = HostFileReads();
+	start = HostTimeNs();
+	for(i = 0; i < CHAR_BENCH_ROUNDS; i++) {
+		FontCacheNewFrame();
+		DrawPage(GuiDrawChar);
+	}
+	warmNs = HostTimeNs() - start;
+	newReads = HostFileReads() - newReads;
+	FontCacheGetStats(&after);
+
+	glyphs *= CHAR_BENCH_ROUNDS;
+	printf("%d glyphs: per-pixel %.1f ns/glyph (%d file reads), column cold cache %.1f ns/glyph, warm cache %.1f ns/glyph (%d file reads)\n",
+			glyphs, (double)refNs / glyphs, refReads, (double)coldNs / glyphs, (double)warmNs / glyphs, newReads);
+	printf("glyph cache: %d hits, %d misses, %d/%d slots\n", (after.hits - before.hits), (after.misses - before.misses),
+			after.entries, FONT_CACHE_SLOTS);
+	// 未命中的字模才读取字体文件
+	HOST_CHECK(newReads == (after.misses - before.misses), "%d file reads for %d cache misses", newReads, (after.misses - before.misses));
+	// 页面字符多于缓存槽数时，已缓存的字模保留，只有超出的字模每帧读取文件
+	HOST_CHECK((after.hits - before.hits) * 100 >= CHAR_CACHE_HIT_MIN * ((after.hits - before.hits) + (after.misses - before.misses)),
+			"glyph cache hit rate %d%% on a redrawn page", (after.hits - before.hits) * 100 / ((after.hits - before.hits) + (after.misses - before.misses)));
+	HOST_CHECK(memcmp(reference, buffer, sizeof(reference)) == 0, "framebuffers differ after the benchmark");
+
+	// 切换页面: 上一页面的字模在FONT_CACHE_PIN_FRAMES帧后可被替换，新页面之后不再读取文件
+	for(i = 0; i < FONT_CACHE_PIN_FRAMES; i++) {
+		FontCacheNewFrame();
+		DrawSymbols();
+	}
+	FontCacheNewFrame();
+	newReads = HostFileReads();
+	DrawSymbols();
+	HOST_CHECK(HostFileReads() == newReads, "new page: %d glyphs read the font file again", (HostFileReads() - newReads));
+
+	// 不超过缓存槽数的字符再次绘制时不再读取文件
+	FontCacheClear();
+	DrawSymbols();
+	newReads = HostFileReads();
+	DrawSymbols();
+	HOST_CHECK(HostFileReads() == newReads, "%d cached glyphs read the font file again", (HostFileReads() - newReads));
+
+	return HostReport("test_draw_char");
+}
@@ -0,0 +1,111 @@
+/*
+ * test_draw_fill.c
+ * @brief GuiFillColor按字节填充竖直段与逐像素填充的结果比较和主机端耗时
+ * @note 参照实现为逐像素调用EPDDrawHorizontal的原GuiFillColor，写入独立的参照显存
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/driver/ssd1675b.c app/graphics/displayio.c app/graphics/font.c app/utils/strings.c tools/host_test/host_gui.c
+
+#include "host.h"
+#include "host_gui.h"
+#include "graphics/displayio.h"
+
+#define FILL_RANDOM_RECTS    2000
+#define FILL_BENCH_ROUNDS    2000
+
+static uint8_t reference[EPD_HEIGHT * EPD_RAM_WIDTH];
+
+/**
+ * @brief 原EPDDrawHorizontal(不内联，与原实现跨文件调用一致)，x映射到RAM行(249-x)，y映射到列字节(y>>3)的第(7-(y&7))位
+ * */
+static __attribute__((noinline)) void RefDrawHorizontal(uint16_t x, uint16_t y, uint8_t color) {
+	uint32_t byteIndex = ((EPD_HEIGHT - 1) << 4) + (y >> 3) - (x << 4);
+	uint8_t bitVal = (color & 0x1);
+	uint8_t shift = (7 - (y & 0x7));
+
+	*(reference + byteIndex) &= ~((uint8_t)1 << shift);
+	*(reference + byteIndex) |= (bitVal << shift);
+}
+
+/**
+ * @brief 原GuiFillColor
+ * */
+static void RefFillColor(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, uint8_t color) {
+	uint16_t i, j;
+	for(i = yStart; i <= yEnd; i++) {
+		for(j = xStart; j <= xEnd; j++) {
+			RefDrawHorizontal(j, i, color);
+		}
+	}
+}
+
+/**
+ * @brief 两种实现各填充rounds次同一区域，输出每微秒填充像素数
+ * */
+static void BenchFill(const char *name, uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) {
+	uint32_t i, pixels = (xEnd - xStart + 1) * (yEnd - yStart + 1) * FILL_BENCH_ROUNDS;
+	uint64_t start, refNs, newNs;
+
+	start = HostTimeNs();
+	for(i = 0; i < FILL_BENCH_ROUNDS; i++) {
+		RefFillColor(xStart, yStart, xEnd, yEnd, (i & 0x1));
+	}
+	refNs = HostTimeNs() - start;
+	start = HostTimeNs();
+	for(i = 0; i < FILL_BENCH_ROUNDS; i++) {
+		GuiFillColor(xStart, yStart, xEnd, yEnd, (i & 0x1));
+	}
+	newNs = HostTimeNs() - start;
+	printf("%-12s per-pixel %7.1f px/us, span %7.1f px/us (x%.1f)\n", name,
+			(double)pixels * 1000.0 / (double)refNs, (double)pixels * 1000.0 / (double)newNs,
+			(double)refNs / (double)newNs);
+	HOST_CHECK(memcmp(reference, EPDGetDisplayRAM(), sizeof(reference)) == 0, "%s: framebuffers differ", name);
+}
+
+int main(void) {
+	uint8_t *buffer;
+	uint16_t x1, x2, y1, y2, t;
+	uint8_t color;
+	uint32_t i;
+
+	HOST_CHECK(EPDDisplayRAMInit() == OK, "framebuffer allocation failed");
+	buffer = EPDGetDisplayRAM();
+	memset(reference, 0xFF, sizeof(reference));
+
+	// 随机区域和颜色，包括单像素、单字节内和跨越字节边界的竖直段
+	srand(1675);
+	for(i = 0; i < FILL_RANDOM_RECTS; i++) {
+		x1 = rand() % SCREEN_WIDTH;
+		x2 = rand() % SCREEN_WIDTH;
+		y1 = rand() % SCREEN_HEIGHT;
+		y2 = (i & 0x3) ? (y1 + rand() % 12) : (rand() % SCREEN_HEIGHT);
+		if(y2 >= SCREEN_HEIGHT) y2 = (SCREEN_HEIGHT - 1);
+		if(x1 > x2) { t = x1; x1 = x2; x2 = t; }
+		if(y1 > y2) { t = y1; y1 = y2; y2 = t; }
+		color = (rand() & 0x1);
+		RefFillColor(x1, y1, x2, y2, color);
+		GuiFillColor(x1, y1, x2, y2, color);
+	}
+	HOST_CHECK(memcmp(reference, buffer, sizeof(reference)) == 0, "random fills differ from the per-pixel fill");
+
+	// 边界: 屏幕四边和字节对齐的竖直段
+	RefFillColor(0, 0, 249, 0, BLACK);
+	GuiFillColor(0, 0, 249, 0, BLACK);
+	RefFillColor(0, 121, 249, 121, BLACK);
+	GuiFillColor(0, 121, 249, 121, BLACK);
+	RefFillColor(249, 0, 249, 121, WHITE);
+	GuiFillColor(249, 0, 249, 121, WHITE);
+	RefFillColor(10, 8, 20, 15, BLACK);
+	GuiFillColor(10, 8, 20, 15, BLACK);
+	HOST_CHECK(memcmp(reference, buffer, sizeof(reference)) == 0, "edge fills differ from the per-pixel fill");
+
+	// 主机端耗时，仅用于比较两种实现，不代表ESP8266上的绝对速度
+	BenchFill("full screen", 0, 0, 249, 121);
+	BenchFill("bar 250x16", 0, 40, 249, 55);
+	BenchFill("block 40x40", 100, 41, 139, 80);
+	BenchFill("column 1x122", 60, 0, 60, 121);
+	BenchFill("row 250x1", 0, 77, 249, 77);
+
+	return HostReport("test_draw_fill");
+}
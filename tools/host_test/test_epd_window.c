@@ -0,0 +1,350 @@
+/*
+ * test_epd_window.c
+ * @brief EPDFlushWindow/EPDFlush发送的RAM窗口与地址换算测试
+ * @note spi传输按D/C电平解析为命令和数据，驱动一个简化的SSD1675B RAM模型
+ *       (0x44/0x45窗口, 0x4E/0x4F光标, 0x24写入, 数据输入模式0x03: X递增后Y递增, 0x32 LUT)
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/driver/ssd1675b.c
+
+#include "host.h"
+#include "driver/ssd1675b.h"
+
+// 控制器RAM模型，未写入的字节保持RAM_UNTOUCHED
+#define RAM_UNTOUCHED    0xA5
+// 整屏写入的spi传输次数上限: 窗口和光标设置14次，4000字节数据按64字节一次且每个写入任务块单独发送
+#define EPD_FLUSH_TRANSACTIONS_MAX    80
+
+static uint8_t ram24[EPD_HEIGHT][EPD_RAM_WIDTH];
+static uint8_t windowXStart, windowXEnd, cursorX;
+static uint16_t windowYStart, windowYEnd, cursorY;
+static uint8_t command, params[4], paramCount;
+// 0x32写入的LUT
+static uint8_t lut32[EPD_LUT_SIZE], lutCount;
+static uint32_t dcLevel, ramWrites, outOfWindow;
+// spi传输次数(每次最多64字节)和传输字节数
+static uint32_t spiTransactions, spiBytes;
+
+static os_task_t flushTask;
+static int flushPosted, flushedEvents;
+
+static void ControllerByte(uint8_t byte) {
+	if(!dcLevel) {
+		command = byte;
+		paramCount = 0;
+		if(command == 0x32) {
+			lutCount = 0;
+		}
+		return;
+	}
+	if(command == 0x32) {
+		if(lutCount < EPD_LUT_SIZE) {
+			lut32[lutCount++] = byte;
+		}
+		return;
+	}
+	if(command == 0x24) {
+		if(cursorX > windowXEnd || cursorY > windowYEnd || cursorY >= EPD_HEIGHT) {
+			outOfWindow++;
+		}else {
+			ram24[cursorY][cursorX] = byte;
+		}
+		ramWrites++;
+		// 数据输入模式0x03，X方向到达窗口末尾后回到窗口起始并递增Y
+		if(cursorX >= windowXEnd) {
+			cursorX = windowXStart;
+			cursorY++;
+		}else {
+			cursorX++;
+		}
+		return;
+	}
+	if(paramCount < sizeof(params)) {
+		params[paramCount++] = byte;
+	}
+	if(command == 0x44 && paramCount == 2) {
+		windowXStart = params[0];
+		windowXEnd = params[1];
+	}else if(command == 0x45 && paramCount == 4) {
+		windowYStart = params[0] | (params[1] << 8);
+		windowYEnd = params[2] | (params[3] << 8);
+	}else if(command == 0x4E && paramCount == 1) {
+		cursorX = params[0];
+	}else if(command == 0x4F && paramCount == 2) {
+		cursorY = params[0] | (params[1] << 8);
+	}
+}
+
+void gpio_output_set(uint32 set_mask, uint32 clear_mask, uint32 enable_mask, uint32 disable_mask) {
+	if(set_mask & BIT(EPD_DC_PIN)) dcLevel = 1;
+	if(clear_mask & BIT(EPD_DC_PIN)) dcLevel = 0;
+}
+
+uint32 gpio_input_get(void) {
+	// BUSY保持低电平
+	return 0;
+}
+
+void gpio_pin_intr_state_set(uint32 i, GPIO_INT_TYPE intr_state) {
+}
+
+void gpio16_output_conf(void) {
+}
+
+void gpio16_output_set(uint8 value) {
+}
+
+void UserButtonAddPinIRQListener(uint8_t pin, PinIRQListener listener) {
+}
+
+void SPIInit(SpiNum spiNum, SpiAttr *pAttr) {
+}
+
+int32_t SPIMasterSendData(SpiNum spiNum, SpiData *pInData) {
+	uint32_t i;
+	spiTransactions++;
+	spiBytes += pInData->dataLen;
+	for(i = 0; i < pInData->dataLen; i++) {
+		ControllerByte((uint8_t)(pInData->data[i >> 2] >> ((i & 0x3) << 3)));
+	}
+	return 0;
+}
+
+int32_t SPIMasterSendBurst(SpiNum spiNum, const uint8_t *data, uint32_t length) {
+	uint32_t i;
+	spiTransactions += (length + 63) / 64;
+	spiBytes += length;
+	for(i = 0; i < length; i++) {
+		ControllerByte(data[i]);
+	}
+	return 0;
+}
+
+bool system_os_task(os_task_t task, uint8 prio, os_event_t *queue, uint8 qlen) {
+	flushTask = task;
+	return TRUE;
+}
+
+bool system_os_post(uint8 prio, os_signal_t sig, os_param_t par) {
+	flushPosted++;
+	return TRUE;
+}
+
+static void EventPost(uint32_t eventId, uint32_t arg) {
+	if(eventId == MAIN_EVENT_EPD_FLUSHED) {
+		flushedEvents++;
+	}
+}
+
+static EventBus bus = {NULL, NULL, NULL, EventPost};
+
+EventBus *EventBusGetDefault(void) {
+	return &bus;
+}
+
+/**
+ * @brief 执行异步写入任务直到完成
+ * */
+static void RunFlushTask(void) {
+	os_event_t event = {0, 0};
+	int guard = 0;
+	while(flushPosted > 0 && guard++ < 1000) {
+		flushPosted--;
+		flushTask(&event);
+	}
+}
+
+static void ResetController(void) {
+	memset(ram24, RAM_UNTOUCHED, sizeof(ram24));
+	ramWrites = 0;
+	outOfWindow = 0;
+	flushedEvents = 0;
+	spiTransactions = 0;
+	spiBytes = 0;
+}
+
+/**
+ * @brief 刷新窗口并检查: 窗口为RAM行(249-xEnd)~(249-xStart), 列字节(yStart>>3)~(yEnd>>3)，
+ *        窗口内与显存一致，窗口外未写入
+ * */
+static void CheckWindow(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd) {
+	uint8_t *buffer = EPDGetDisplayRAM();
+	uint16_t rowStart = (EPD_HEIGHT - 1) - xEnd, rowEnd = (EPD_HEIGHT - 1) - xStart;
+	uint16_t colStart = (yStart >> 3), colEnd = (yEnd >> 3);
+	uint32_t row, col, mismatches = 0, touched = 0;
+
+	ResetController();
+	HOST_CHECK(EPDFlushWindow(xStart, yStart, xEnd, yEnd) == OK, "window (%d,%d)-(%d,%d) rejected", xStart, yStart, xEnd, yEnd);
+	RunFlushTask();
+
+	HOST_CHECK(flushedEvents == 1, "window (%d,%d)-(%d,%d): %d flushed events", xStart, yStart, xEnd, yEnd, flushedEvents);
+	HOST_CHECK(windowXStart == colStart && windowXEnd == colEnd, "window (%d,%d)-(%d,%d): x window %d~%d, expected %d~%d",
+			xStart, yStart, xEnd, yEnd, windowXStart, windowXEnd, colStart, colEnd);
+	HOST_CHECK(windowYStart == rowStart && windowYEnd == rowEnd, "window (%d,%d)-(%d,%d): y window %d~%d, expected %d~%d",
+			xStart, yStart, xEnd, yEnd, windowYStart, windowYEnd, rowStart, rowEnd);
+	HOST_CHECK(outOfWindow == 0, "window (%d,%d)-(%d,%d): %d bytes outside the window", xStart, yStart, xEnd, yEnd, outOfWindow);
+	HOST_CHECK(ramWrites == (rowEnd - rowStart + 1) * (colEnd - colStart + 1), "window (%d,%d)-(%d,%d): %d bytes written, expected %d",
+			xStart, yStart, xEnd, yEnd, ramWrites, (rowEnd - rowStart + 1) * (colEnd - colStart + 1));
+
+	for(row = 0; row < EPD_HEIGHT; row++) {
+		for(col = 0; col < EPD_RAM_WIDTH; col++) {
+			if(row >= rowStart && row <= rowEnd && col >= colStart && col <= colEnd) {
+				if(ram24[row][col] != buffer[row * EPD_RAM_WIDTH + col]) mismatches++;
+			}else if(ram24[row][col] != RAM_UNTOUCHED) {
+				touched++;
+			}
+		}
+	}
+	HOST_CHECK(mismatches == 0, "window (%d,%d)-(%d,%d): %d bytes differ from the framebuffer", xStart, yStart, xEnd, yEnd, mismatches);
+	HOST_CHECK(touched == 0, "window (%d,%d)-(%d,%d): %d bytes outside the window changed", xStart, yStart, xEnd, yEnd, touched);
+}
+
+/**
+ * @brief 按修改前的驱动逐字节发送一个字节，每字节一次spi传输，D/C电平变化时才切换
+ * */
+static void PerByteSend(uint8_t byte, uint32_t dc) {
+	SpiData data;
+	uint32_t word = byte;
+
+	if(dcLevel != dc) {
+		gpio_output_set(dc ? BIT(EPD_DC_PIN) : 0, dc ? 0 : BIT(EPD_DC_PIN), 0, 0);
+	}
+	os_memset(&data, 0x00, sizeof(SpiData));
+	data.data = &word;
+	data.dataLen = 1;
+	SPIMasterSendData(SpiNum_HSPI, &data);
+}
+
+/**
+ * @brief 修改前的整屏写入(EPDFillData): 设置一次窗口，每行设置光标、发送0x24和16字节数据，全部逐字节发送
+ * */
+static void PerByteFlush(const uint8_t *data) {
+	uint32_t row, col;
+
+	PerByteSend(0x44, 0);
+	PerByteSend(0x00, 1);
+	PerByteSend(EPD_RAM_WIDTH - 1, 1);
+	PerByteSend(0x45, 0);
+	PerByteSend(0x00, 1);
+	PerByteSend(0x00, 1);
+	PerByteSend((EPD_HEIGHT - 1) & 0xFF, 1);
+	PerByteSend(((EPD_HEIGHT - 1) >> 8) & 0x1, 1);
+	for(row = 0; row < EPD_HEIGHT; row++) {
+		PerByteSend(0x4E, 0);
+		PerByteSend(0x00, 1);
+		PerByteSend(0x4F, 0);
+		PerByteSend(row & 0xFF, 1);
+		PerByteSend((row >> 8) & 0x1, 1);
+		PerByteSend(0x24, 0);
+		for(col = 0; col < EPD_RAM_WIDTH; col++) {
+			PerByteSend(*(data + row * EPD_RAM_WIDTH + col), 1);
+		}
+	}
+}
+
+/**
+ * @brief 设置面板温度后初始化，检查写入0x32的LUT
+ * */
+static void CheckWaveform(sint8_t temperature, const uint8_t *lut, const uint8_t *expected) {
+	lutCount = 0;
+	EPDSetTemperature(temperature);
+	HOST_CHECK(EPDInit(lut) == OK, "EPDInit rejected at %d'C", temperature);
+	HOST_CHECK(lutCount == EPD_LUT_SIZE && memcmp(lut32, expected, EPD_LUT_SIZE) == 0,
+			"%d'C: wrong LUT loaded (%d bytes)", temperature, lutCount);
+}
+
+/**
+ * @brief 单个黑色像素刷新后应位于RAM行(249-x)、列字节(y>>3)的第(7-(y&7))位
+ * */
+static void CheckPixel(uint16_t x, uint16_t y) {
+	uint32_t row = (EPD_HEIGHT - 1) - x, col = (y >> 3);
+	uint8_t expected = (uint8_t)~(0x80 >> (y & 0x7));
+
+	EPDDisplayClear();
+	EPDDrawHorizontal(x, y, BLACK);
+	CheckWindow(x, y, x, y);
+	HOST_CHECK(ram24[row][col] == expected, "pixel (%d,%d): ram[%d][%d] = %02X, expected %02X", x, y, row, col, ram24[row][col], expected);
+}
+
+int main(void) {
+	uint8_t *buffer;
+	uint32_t i, perByteTransactions, perByteBytes;
+
+	HOST_CHECK(EPDDisplayRAMInit() == OK, "framebuffer allocation failed");
+	buffer = EPDGetDisplayRAM();
+
+	// 各温度段、温度范围外和温度未知时的全局刷新波形，局部刷新LUT不随温度变化
+	CheckWaveform(25, LUT_FULL_UPDATE, LUT_FULL_UPDATE);
+	CheckWaveform(50, LUT_FULL_UPDATE, LUT_FULL_UPDATE);
+	CheckWaveform(24, LUT_FULL_UPDATE, LUT_FULL_UPDATE);
+	CheckWaveform(9, LUT_FULL_UPDATE, LUT_FULL_UPDATE);
+	CheckWaveform(0, LUT_FULL_UPDATE, LUT_FULL_UPDATE);
+	CheckWaveform(-1, LUT_FULL_UPDATE, LUT_FULL_UPDATE);
+	CheckWaveform(51, LUT_FULL_UPDATE, LUT_FULL_UPDATE);
+	CheckWaveform(EPD_TEMPERATURE_INVALID, LUT_FULL_UPDATE, LUT_FULL_UPDATE);
+	CheckWaveform(25, LUT_PARTIAL_UPDATE, LUT_PARTIAL_UPDATE);
+
+	// 四角和字节边界上的像素
+	CheckPixel(0, 0);
+	CheckPixel(249, 0);
+	CheckPixel(0, 121);
+	CheckPixel(249, 121);
+	CheckPixel(125, 7);
+	CheckPixel(125, 8);
+	CheckPixel(1, 120);
+
+	// 随机内容下的窗口
+	srand(1675);
+	for(i = 0; i < (EPD_RAM_WIDTH * EPD_HEIGHT); i++) {
+		buffer[i] = (uint8_t)rand();
+	}
+	// 整屏
+	CheckWindow(0, 0, 249, 121);
+	// 边缘窗口
+	CheckWindow(0, 0, 0, 121);
+	CheckWindow(249, 0, 249, 121);
+	CheckWindow(0, 121, 249, 121);
+	CheckWindow(0, 120, 249, 121);
+	CheckWindow(248, 116, 249, 121);
+	// y未按字节对齐的窗口
+	CheckWindow(10, 3, 20, 9);
+	CheckWindow(100, 7, 100, 8);
+	CheckWindow(200, 15, 230, 16);
+	CheckWindow(33, 57, 180, 70);
+	// 超过64字节缓冲的非整行窗口
+	CheckWindow(0, 5, 249, 100);
+
+	// 越界及反向窗口
+	HOST_CHECK(EPDFlushWindow(0, 0, 250, 121) == FAIL, "x = 250 accepted");
+	HOST_CHECK(EPDFlushWindow(0, 0, 249, 122) == FAIL, "y = 122 accepted");
+	HOST_CHECK(EPDFlushWindow(20, 0, 10, 121) == FAIL, "xStart > xEnd accepted");
+	HOST_CHECK(EPDFlushWindow(0, 50, 249, 49) == FAIL, "yStart > yEnd accepted");
+
+	// 整屏写入与显存完全一致
+	ResetController();
+	HOST_CHECK(EPDFlush() == OK, "full flush rejected");
+	HOST_CHECK(EPDIsUpdating(), "framebuffer released while the flush is pending");
+	RunFlushTask();
+	// 写入完成到刷新完成断电之前显存仍被占用
+	HOST_CHECK(EPDGetStatus() == IDLE && EPDIsUpdating(), "framebuffer released before the refresh");
+	HOST_CHECK(memcmp(ram24, buffer, sizeof(ram24)) == 0, "full flush differs from the framebuffer");
+	HOST_CHECK(ramWrites == EPD_HEIGHT * EPD_RAM_WIDTH, "full flush wrote %d bytes", ramWrites);
+	HOST_CHECK(spiTransactions <= EPD_FLUSH_TRANSACTIONS_MAX, "full flush took %d spi transactions", spiTransactions);
+
+	// 同一帧按修改前的逐字节方式写入，内容一致，比较spi传输次数
+	ResetController();
+	PerByteFlush(buffer);
+	HOST_CHECK(memcmp(ram24, buffer, sizeof(ram24)) == 0 && outOfWindow == 0, "per-byte flush differs from the framebuffer");
+	perByteTransactions = spiTransactions;
+	perByteBytes = spiBytes;
+	ResetController();
+	HOST_CHECK(EPDFlush() == OK, "second full flush rejected");
+	RunFlushTask();
+	printf("full flush: per-byte %d spi transactions, %d bytes; burst %d spi transactions, %d bytes (x%.1f fewer)\n",
+			perByteTransactions, perByteBytes, spiTransactions, spiBytes, (double)perByteTransactions / spiTransactions);
+	HOST_CHECK(spiTransactions * 50 < perByteTransactions, "burst flush %d spi transactions, per-byte %d",
+			spiTransactions, perByteTransactions);
+
+	return HostReport("test_epd_window");
+}
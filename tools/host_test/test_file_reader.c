@@ -0,0 +1,179 @@
+/*
+ * test_file_reader.c
+ * @brief spifs顺序读取器(open_reader/seek_reader/read_reader)与read_file的结果比较
+ * @note 编译真实的spifs.c，spi_flash_*由内存中的flash模型实现(写入只能1->0)，
+ *       测试文件由create_file/write_file与另一个文件交替追加写入，簇链不连续
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/spifsmini/spifs.c app/spifsmini/diskio.c
+
+#include "host.h"
+#include "spifsmini/spifs.h"
+
+#define FLASH_SECTORS     (DATA_SECTOR_END + 1)
+// 测试文件: 2个整簇 + 3000字节，长度不是DATA_AREA_SIZE的整数倍
+#define FILE_LENGTH       (DATA_AREA_SIZE * 2 + 3000)
+#define RANDOM_READS      2000
+
+static uint32_t flash[FLASH_SECTORS * SECTOR_SIZE / sizeof(uint32_t)];
+static uint32_t flashReads;
+static uint32_t content[(FILE_LENGTH + 3) / sizeof(uint32_t)];
+static uint32_t other[(DATA_AREA_SIZE + 3) / sizeof(uint32_t)];
+static uint32_t chunk[(DATA_AREA_SIZE + 3) / sizeof(uint32_t)];
+static uint8_t expected[FILE_LENGTH + 64], actual[FILE_LENGTH + 64];
+
+SpiFlashOpResult spi_flash_read(uint32 src_addr, uint32 *des_addr, uint32 size) {
+	flashReads++;
+	os_memcpy(des_addr, (uint8_t *)flash + src_addr, size);
+	return SPI_FLASH_RESULT_OK;
+}
+
+SpiFlashOpResult spi_flash_write(uint32 des_addr, uint32 *src_addr, uint32 size) {
+	uint8_t *dest = (uint8_t *)flash + des_addr, *src = (uint8_t *)src_addr;
+	uint32_t i;
+	for(i = 0; i < size; i++) {
+		dest[i] &= src[i];
+	}
+	return SPI_FLASH_RESULT_OK;
+}
+
+SpiFlashOpResult spi_flash_erase_sector(uint16 sec) {
+	os_memset((uint8_t *)flash + sec * SECTOR_SIZE, 0xFF, SECTOR_SIZE);
+	return SPI_FLASH_RESULT_OK;
+}
+
+/**
+ * @brief 追加写入并结束，第一次写入前创建文件
+ * */
+static void Append(File *file, const char *name, uint8_t *data, uint32_t length) {
+	FileInfo finfo;
+	if(file->block == EMPTY_INT_VALUE) {
+		make_file(file, (char *)name, "bin");
+		make_finfo(&finfo, 2026, 10, 17, FSTATE_DEFAULT);
+		HOST_CHECK(create_file(file, &finfo) == CREATE_FILE_SUCCESS, "%s not created", name);
+	}
+	HOST_CHECK(write_file(file, data, length, APPEND) == APPEND_FILE_SUCCESS, "%s: append of %d bytes failed", name, length);
+}
+
+/**
+ * @brief 从position读取length字节，检查与read_file结果一致
+ * */
+static void CheckRead(const char *name, FileReader *reader, File *file, uint32_t position, uint32_t length) {
+	uint32_t size, want;
+
+	want = (position >= file->length) ? 0 : (file->length - position);
+	want = (want > length) ? length : want;
+	os_memset(expected, 0x00, sizeof(expected));
+	os_memset(actual, 0x00, sizeof(actual));
+	if(want > 0) {
+		HOST_CHECK(read_file(file, position, expected, want) == want, "%s: read_file at %d failed", name, position);
+	}
+	seek_reader(reader, position);
+	size = read_reader(reader, actual, length);
+	HOST_CHECK(size == want, "%s: capacity %d, %d bytes at %d returned %d, expected %d",
+			name, reader->capacity, length, position, size, want);
+	HOST_CHECK(memcmp(actual, expected, want) == 0, "%s: capacity %d, %d bytes at %d differ from read_file",
+			name, reader->capacity, length, position);
+	HOST_CHECK(reader->position == (position + size), "%s: position %d after reading %d bytes at %d",
+			name, reader->position, size, position);
+}
+
+/**
+ * @brief 顺序读完整个文件，每次length字节
+ * @return spi_flash_read次数
+ * */
+static uint32_t ReadAll(FileReader *reader, File *file, uint32_t length, BOOL useReader) {
+	uint32_t position = 0, size, reads = flashReads;
+	seek_reader(reader, 0);
+	while(position < file->length) {
+		size = useReader ? read_reader(reader, actual + position, length)
+				: read_file(file, position, actual + position, length);
+		if(size == 0) {
+			break;
+		}
+		position += size;
+	}
+	HOST_CHECK(position == file->length && memcmp(actual, content, file->length) == 0,
+			"sequential read of %d-byte pieces (%s) differs", length, useReader ? "reader" : "read_file");
+	return (flashReads - reads);
+}
+
+int main(void) {
+	// 整簇、不整除簇数据区的容量以及最小容量
+	static const uint32_t capacities[] = {DATA_AREA_SIZE, 1024, 100, 36, 4};
+	File file, otherFile;
+	FileReader reader;
+	uint8_t *data = (uint8_t *)content;
+	uint32_t i, k, cluster, clusters[3], position, length, fileReads, readerReads;
+
+	os_memset(flash, 0xFF, sizeof(flash));
+	spifs_ftl_init();
+	for(i = 0; i < FILE_LENGTH; i++) {
+		data[i] = (uint8_t)(i * 7 + (i >> 8));
+	}
+	os_memset(other, 0x5A, sizeof(other));
+
+	// 与另一个文件交替追加，簇链为 291 -> 293 -> 295
+	file.block = EMPTY_INT_VALUE;
+	otherFile.block = EMPTY_INT_VALUE;
+	Append(&file, "reader", data, DATA_AREA_SIZE);
+	Append(&otherFile, "other", (uint8_t *)other, DATA_AREA_SIZE);
+	Append(&file, "reader", data + DATA_AREA_SIZE, DATA_AREA_SIZE);
+	Append(&otherFile, "other", (uint8_t *)other, 8);
+	Append(&file, "reader", data + DATA_AREA_SIZE * 2, FILE_LENGTH - DATA_AREA_SIZE * 2);
+	HOST_CHECK(write_finish(&file) == APPEND_FILE_FINISH && write_finish(&otherFile) == APPEND_FILE_FINISH, "write_finish failed");
+	HOST_CHECK(open_file(&file, "reader", "bin") && file.length == FILE_LENGTH, "test file not found");
+
+	cluster = file.cluster;
+	for(i = 0; i < 3; i++) {
+		clusters[i] = cluster;
+		spi_flash_read(cluster + SECTOR_MARK_SIZE + DATA_AREA_SIZE, &cluster, sizeof(uint32_t));
+	}
+	HOST_CHECK(cluster == EMPTY_INT_VALUE && (clusters[1] - clusters[0]) > SECTOR_SIZE && (clusters[2] - clusters[1]) > SECTOR_SIZE,
+			"cluster chain %X -> %X -> %X -> %X is contiguous or too long", clusters[0], clusters[1], clusters[2], cluster);
+	HOST_CHECK(read_file(&file, 0, expected, FILE_LENGTH) == FILE_LENGTH && memcmp(expected, content, FILE_LENGTH) == 0,
+			"read_file differs from the written content");
+
+	for(k = 0; k < (sizeof(capacities) / sizeof(uint32_t)); k++) {
+		HOST_CHECK(open_reader(&reader, &file, (uint8_t *)chunk, capacities[k]), "open_reader failed, capacity %d", capacities[k]);
+
+		// 跨簇边界
+		CheckRead("cross cluster 1", &reader, &file, DATA_AREA_SIZE - 10, 20);
+		CheckRead("cross cluster 2", &reader, &file, DATA_AREA_SIZE * 2 - 1, 2);
+		CheckRead("span all clusters", &reader, &file, 1, FILE_LENGTH - 2);
+		// 向后移动到第一簇，从首簇重新遍历
+		CheckRead("third cluster", &reader, &file, DATA_AREA_SIZE * 2 + 100, 50);
+		CheckRead("back to first", &reader, &file, 100, 50);
+		CheckRead("back in cluster", &reader, &file, 10, 5);
+		// 文件末尾的短读
+		CheckRead("short at end", &reader, &file, FILE_LENGTH - 5, 20);
+		CheckRead("at end", &reader, &file, FILE_LENGTH, 20);
+		CheckRead("past end", &reader, &file, FILE_LENGTH + 100, 20);
+		CheckRead("whole file", &reader, &file, 0, FILE_LENGTH + 64);
+
+		// 随机位置和长度
+		srand(4088 + k);
+		for(i = 0; i < RANDOM_READS; i++) {
+			position = (uint32_t)rand() % (FILE_LENGTH + 16);
+			length = (uint32_t)rand() % ((i & 0x1) ? 64 : (DATA_AREA_SIZE + 64));
+			CheckRead("random", &reader, &file, position, length);
+		}
+	}
+
+	// 顺序读取64字节片段的flash读取次数
+	open_reader(&reader, &file, (uint8_t *)chunk, DATA_AREA_SIZE);
+	fileReads = ReadAll(&reader, &file, 64, FALSE);
+	readerReads = ReadAll(&reader, &file, 64, TRUE);
+	printf("sequential 64-byte reads of %d bytes: read_file %d flash reads, reader (%d-byte chunks) %d flash reads\n",
+			FILE_LENGTH, fileReads, DATA_AREA_SIZE, readerReads);
+	HOST_CHECK(readerReads * 10 < fileReads, "reader %d flash reads, read_file %d", readerReads, fileReads);
+
+	// 已删除的文件不能创建读取器
+	delete_file(&otherFile);
+	open_file(&otherFile, "other", "bin");
+	HOST_CHECK(!open_reader(&reader, &otherFile, (uint8_t *)chunk, sizeof(chunk)), "reader opened on a deleted file");
+	HOST_CHECK(!open_reader(&reader, &file, (uint8_t *)chunk, 3), "reader opened with a 3-byte buffer");
+
+	return HostReport("test_file_reader");
+}
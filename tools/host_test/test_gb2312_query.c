@@ -0,0 +1,125 @@
+/*
+ * test_gb2312_query.c
+ * @brief QueryGB2312ByUnicode的采样索引、分段查找、最近转换缓存和InvalidateGB2312Query
+ * @note utf16.lut为内存文件，read_file次数由HostFileReads统计
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/utils/strings.c tools/host_test/host_gui.c
+
+#include "host.h"
+#include "host_gui.h"
+#include "utils/strings.h"
+#include "spifsmini/spifs.h"
+
+// 100组: 3个整段和一个4组的尾段
+#define LUT_GROUPS      (UTF16_INDEX_STRIDE * 3 + 4)
+#define LUT_BUCKETS     4
+// 第i组: unicode 0x4E00 + 3i，gb2312 0xB0A1 + i
+#define LUT_UNICODE(i)  (0x4E00 + (i) * 3)
+#define LUT_GB2312(i)   (0xB0A1 + (i))
+
+static uint32_t lut[LUT_GROUPS];
+
+/**
+ * @brief 查询一次，检查结果和本次read_file次数
+ * @param expected 大端gb2312，0为不存在
+ * */
+static void CheckQuery(const char *name, uint16_t unicode, uint16_t expected, uint32_t reads) {
+	uint32_t before = HostFileReads();
+	Short gb2312 = QueryGB2312ByUnicode(unicode);
+	uint16_t result = (uint16_t)((gb2312.bytes[0] << 8) | gb2312.bytes[1]);
+
+	HOST_CHECK(result == expected, "%s: U+%04X -> %04X, expected %04X", name, unicode, result, expected);
+	HOST_CHECK((HostFileReads() - before) == reads, "%s: U+%04X took %d reads, expected %d",
+			name, unicode, (HostFileReads() - before), reads);
+}
+
+/**
+ * @brief 线性查找作为参照
+ * */
+static uint16_t LinearQuery(uint16_t unicode) {
+	uint32_t i;
+	for(i = 0; i < LUT_GROUPS; i++) {
+		if((lut[i] & 0xFFFF) == unicode) {
+			return (uint16_t)(lut[i] >> 16);
+		}
+	}
+	return 0;
+}
+
+int main(void) {
+	File lutFile, otherFile;
+	uint32_t i, reads, queries = 0, mismatches = 0;
+	uint16_t unicode;
+	Short gb2312;
+
+	for(i = 0; i < LUT_GROUPS; i++) {
+		lut[i] = LUT_UNICODE(i) | ((uint32_t)LUT_GB2312(i) << 16);
+	}
+	make_file(&lutFile, "utf16", "lut");
+	make_file(&otherFile, "utf8", "lut");
+
+	// 文件不存在: 查询失败，之后不再尝试打开
+	CheckQuery("missing", LUT_UNICODE(0), 0, 0);
+	HostAddFile("utf16", "lut", (const uint8_t *)lut, sizeof(lut));
+	CheckQuery("missing cached", LUT_UNICODE(0), 0, 0);
+	InvalidateGB2312Query(otherFile.filename);
+	CheckQuery("other file invalidated", LUT_UNICODE(0), 0, 0);
+
+	// utf16.lut变更后重建索引: 每段读取首组，再读取一段
+	InvalidateGB2312Query(lutFile.filename);
+	CheckQuery("first", LUT_UNICODE(0), LUT_GB2312(0), LUT_BUCKETS + 1);
+	// 最近转换的字符不读取文件
+	CheckQuery("memo", LUT_UNICODE(0), LUT_GB2312(0), 0);
+
+	// 分段边界: 每次查询只读取一段
+	CheckQuery("bucket 0 end", LUT_UNICODE(UTF16_INDEX_STRIDE - 1), LUT_GB2312(UTF16_INDEX_STRIDE - 1), 1);
+	CheckQuery("bucket 1 start", LUT_UNICODE(UTF16_INDEX_STRIDE), LUT_GB2312(UTF16_INDEX_STRIDE), 1);
+	CheckQuery("bucket 2 end", LUT_UNICODE(UTF16_INDEX_STRIDE * 3 - 1), LUT_GB2312(UTF16_INDEX_STRIDE * 3 - 1), 1);
+	CheckQuery("tail start", LUT_UNICODE(UTF16_INDEX_STRIDE * 3), LUT_GB2312(UTF16_INDEX_STRIDE * 3), 1);
+	CheckQuery("last", LUT_UNICODE(LUT_GROUPS - 1), LUT_GB2312(LUT_GROUPS - 1), 1);
+
+	// 不存在: 小于第一组时不读取文件，其余读取所在分段
+	CheckQuery("below first", LUT_UNICODE(0) - 1, 0, 0);
+	CheckQuery("gap", LUT_UNICODE(UTF16_INDEX_STRIDE) + 1, 0, 1);
+	CheckQuery("above last", LUT_UNICODE(LUT_GROUPS - 1) + 1, 0, 1);
+	CheckQuery("max", 0xFFFF, 0, 1);
+
+	// 缓存槽冲突: unicode低4位相同的两个字符交替查询，每次都读取文件且结果正确
+	unicode = LUT_UNICODE(UTF16_MEMO_SIZE);
+	HOST_CHECK((unicode & (UTF16_MEMO_SIZE - 1)) == (LUT_UNICODE(0) & (UTF16_MEMO_SIZE - 1)), "U+%04X not in the slot of U+%04X",
+			unicode, LUT_UNICODE(0));
+	// 上面的"bucket 1 start"(U+4E60)已占用该槽
+	CheckQuery("collision a", LUT_UNICODE(0), LUT_GB2312(0), 1);
+	CheckQuery("collision a memo", LUT_UNICODE(0), LUT_GB2312(0), 0);
+	CheckQuery("collision b", unicode, LUT_GB2312(UTF16_MEMO_SIZE), 1);
+	CheckQuery("collision a again", LUT_UNICODE(0), LUT_GB2312(0), 1);
+	CheckQuery("collision b again", unicode, LUT_GB2312(UTF16_MEMO_SIZE), 1);
+
+	// 查找表覆盖写后失效: 不再返回缓存的旧结果
+	for(i = 0; i < LUT_GROUPS; i++) {
+		lut[i] = LUT_UNICODE(i) | ((uint32_t)(LUT_GB2312(i) + 0x100) << 16);
+	}
+	CheckQuery("stale memo", unicode, LUT_GB2312(UTF16_MEMO_SIZE), 0);
+	InvalidateGB2312Query(lutFile.filename);
+	CheckQuery("rewritten", LUT_UNICODE(0), LUT_GB2312(0) + 0x100, LUT_BUCKETS + 1);
+	InvalidateGB2312Query(NULL);
+	CheckQuery("invalidate all", LUT_UNICODE(0), LUT_GB2312(0) + 0x100, LUT_BUCKETS + 1);
+
+	// 整个范围与线性查找一致，不在缓存中的查询最多读取一次
+	reads = HostFileReads();
+	for(unicode = 0x4D00; unicode < 0x5000; unicode++) {
+		gb2312 = QueryGB2312ByUnicode(unicode);
+		if((uint16_t)((gb2312.bytes[0] << 8) | gb2312.bytes[1]) != LinearQuery(unicode)) {
+			mismatches++;
+		}
+		queries++;
+	}
+	reads = HostFileReads() - reads;
+	printf("gb2312 query: %d groups in %d buckets, %d queries, %d file reads\n", LUT_GROUPS, LUT_BUCKETS, queries, reads);
+	HOST_CHECK(mismatches == 0, "%d queries differ from a linear search", mismatches);
+	HOST_CHECK(reads <= queries, "%d reads for %d queries", reads, queries);
+
+	return HostReport("test_gb2312_query");
+}
@@ -0,0 +1,70 @@
+/*
+ * test_gui_layer.c
+ * @brief GuiSaveLayer/GuiRestoreLayer的RAM缓存，以及空闲堆不足时放弃缓存、不写入flash
+ * @note system_get_free_heap_size返回hostFreeHeap，由测试设置
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/driver/ssd1675b.c app/graphics/displayio.c app/graphics/font.c app/utils/strings.c tools/host_test/host_gui.c
+
+#include "host.h"
+#include "host_gui.h"
+#include "graphics/displayio.h"
+
+#define LAYER_FRAME_SIZE    (EPD_HEIGHT * EPD_RAM_WIDTH)
+
+static uint8_t saved[LAYER_FRAME_SIZE];
+
+/**
+ * @brief 白底上随机约1/8的字节有笔画，接近页面的墨量
+ * */
+static void FillPage(uint8_t *buffer) {
+	uint32_t i;
+	memset(buffer, 0xFF, LAYER_FRAME_SIZE);
+	for(i = 0; i < LAYER_FRAME_SIZE; i++) {
+		if((rand() & 0x7) == 0) {
+			buffer[i] = (uint8_t)rand();
+		}
+	}
+}
+
+int main(void) {
+	uint8_t *buffer;
+
+	HOST_CHECK(EPDDisplayRAMInit() == OK, "framebuffer allocation failed");
+	buffer = EPDGetDisplayRAM();
+	srand(1675);
+
+	// 空闲堆充足: 放入RAM，签名一致时恢复
+	hostFreeHeap = 20 * 1024;
+	FillPage(buffer);
+	memcpy(saved, buffer, LAYER_FRAME_SIZE);
+	HOST_CHECK(GuiSaveLayer(0, 0x1234), "layer not cached with 20 KB free heap");
+	HOST_CHECK(GuiSaveLayer(0, 0x1234), "unchanged layer not reported as saved");
+	FillPage(buffer);
+	HOST_CHECK(!GuiRestoreLayer(0, 0x4321), "restored a layer with another signature");
+	HOST_CHECK(GuiRestoreLayer(0, 0x1234) && memcmp(saved, buffer, LAYER_FRAME_SIZE) == 0, "restored layer differs");
+
+	// 空闲堆不足: 放弃缓存，旧内容同时失效，不创建文件
+	hostFreeHeap = GUI_LAYER_HEAP_RESERVE + 256;
+	FillPage(buffer);
+	HOST_CHECK(!GuiSaveLayer(0, 0x5678), "page layer cached with only 256 bytes above the reserve");
+	HOST_CHECK(!GuiRestoreLayer(0, 0x1234) && !GuiRestoreLayer(0, 0x5678), "stale layer restored after a failed save");
+	HOST_CHECK(!GuiSaveLayer(GUI_LAYER_FRAME_BASE, 0x5678), "frame layer cached with only 256 bytes above the reserve");
+	HOST_CHECK(HostFileCreates() == 0, "layer written to spifs (%d files created)", HostFileCreates());
+
+	// 空白帧压缩为4字节，保留空闲堆之外只需4字节
+	memset(buffer, 0xFF, LAYER_FRAME_SIZE);
+	hostFreeHeap = GUI_LAYER_HEAP_RESERVE + 4;
+	HOST_CHECK(GuiSaveLayer(1, 0x9ABC), "blank layer not cached at the reserve limit");
+	hostFreeHeap = GUI_LAYER_HEAP_RESERVE + 3;
+	HOST_CHECK(!GuiSaveLayer(1, 0x9ABD), "layer cached below the reserve");
+
+	// 显存被外部改变后丢弃全部图层
+	hostFreeHeap = 20 * 1024;
+	HOST_CHECK(GuiSaveLayer(2, 0x1111), "layer not cached with 20 KB free heap");
+	GuiInvalidateFrame();
+	HOST_CHECK(!GuiRestoreLayer(2, 0x1111), "layer restored after GuiInvalidateFrame");
+
+	return HostReport("test_gui_layer");
+}
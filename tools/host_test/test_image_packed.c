@@ -0,0 +1,207 @@
+/*
+ * test_image_packed.c
+ * @brief GuiDrawImagePacked按8行转置解码与原逐像素解码的显存比较
+ * @note 参照实现为原GuiDrawImagePacked: 逐行解压到行缓存，逐像素调用EPDDrawHorizontal，写入独立的参照显存
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/driver/ssd1675b.c app/graphics/displayio.c app/graphics/font.c app/utils/strings.c app/view/appimage.c tools/host_test/host_gui.c
+
+#include "host.h"
+#include "host_gui.h"
+#include "graphics/displayio.h"
+#include "view/appimage.h"
+
+#define PACKED_RANDOM_IMAGES    300
+#define PACKED_BENCH_ROUNDS     2000
+
+static uint8_t reference[EPD_HEIGHT * EPD_RAM_WIDTH];
+static uint8_t initial[EPD_HEIGHT * EPD_RAM_WIDTH];
+static uint8_t synthetic[PACKED_DATA_OFFSET + 32 * SCREEN_HEIGHT * 2];
+
+static const uint8_t *const bundled[] = {shutdown_image, factory_image, update_image, batlow_image, idle_image};
+static const char *const bundledName[] = {"shutdown", "factory", "update", "batlow", "idle"};
+
+/**
+ * @brief 原EPDDrawHorizontal(不内联，与原实现跨文件调用一致)
+ * */
+static __attribute__((noinline)) void RefDrawHorizontal(uint16_t x, uint16_t y, uint8_t color) {
+	uint32_t byteIndex = ((EPD_HEIGHT - 1) << 4) + (y >> 3) - (x << 4);
+	uint8_t bitVal = (color & 0x1);
+	uint8_t shift = (7 - (y & 0x7));
+
+	*(reference + byteIndex) &= ~((uint8_t)1 << shift);
+	*(reference + byteIndex) |= (bitVal << shift);
+}
+
+/**
+ * @brief 将行缓存中的一行逐像素写入参照显存
+ * */
+static void RefDrawLine(const uint8_t *lineBuffer, uint16_t xStart, uint16_t drawY, uint16_t width) {
+	uint32_t i;
+	for(i = 0; i < width; i++) {
+		RefDrawHorizontal(xStart + i, drawY, ((lineBuffer[i >> 3] >> (i & 0x7)) & 0x1));
+	}
+}
+
+/**
+ * @brief 原GuiDrawImagePacked，逐行解码和逐像素写入的逻辑不变，修正了新实现中同样修正的两处问题:
+ *        长度计数为uint8_t，读取2字节长度时越界写入；循环在(fileSize - PACKED_DATA_OFFSET)处提前结束，
+ *        内置图片的最后4行未绘制。现在解码到fileSize或图片底部，忽略文件末尾的填充字节
+ * */
+static void RefDrawImagePacked(const uint8_t *data, uint16_t xStart, uint16_t yStart) {
+	uint16_t header, width, fileWidth, height, count;
+	uint32_t fileSize, cursor, toWrite;
+	uint16_t drawY;
+	uint8_t byteValue;
+	uint8_t lineBuffer[32];
+	uint32_t lineCursor;
+
+	os_memcpy(&header, data, PACKED_HEADER_LENGTH);
+	if(header != BITMAP_PACKED) {
+		return;
+	}
+	os_memcpy(&fileSize, (data + PACKED_SIZE_OFFSET), PACKED_SIZE_LENGTH);
+	os_memcpy(&width, (data + PACKED_WIDTH_OFFSET), PACKED_WIDTH_LENGTH);
+	os_memcpy(&height, (data + PACKED_HEIGHT_OFFSET), PACKED_HEIGHT_LENGTH);
+	if((xStart + width > SCREEN_WIDTH) || (yStart + height) > SCREEN_HEIGHT) {
+		return;
+	}
+	fileWidth = ((width + 7) / BITS_OF_BYTE);
+
+	cursor = PACKED_DATA_OFFSET;
+	drawY = yStart;
+	lineCursor = 0;
+
+	while((cursor < fileSize) && (drawY < (yStart + height))) {
+		byteValue = *(data + cursor);
+		if((byteValue == 0x00) || (byteValue == 0xFF)) {
+			if((cursor + 1) >= fileSize) {
+				break;
+			}
+			count = *(data + cursor + 1);
+			if(count == 0x00) {
+				os_memcpy(&count, (data + cursor + 2), sizeof(uint16_t));
+				cursor += 4;
+			}else {
+				cursor += 2;
+			}
+			do{
+				toWrite = (count > (fileWidth - lineCursor)) ? (fileWidth - lineCursor) : (count);
+				os_memset((lineBuffer + lineCursor), byteValue, toWrite);
+				lineCursor += toWrite;
+				count -= toWrite;
+				if(lineCursor >= fileWidth) {
+					RefDrawLine(lineBuffer, xStart, drawY++, width);
+					lineCursor = 0;
+				}
+			}while(count > 0 && drawY < (yStart + height));
+		}else {
+			cursor++;
+			lineBuffer[lineCursor++] = byteValue;
+			if(lineCursor >= fileWidth) {
+				RefDrawLine(lineBuffer, xStart, drawY++, width);
+				lineCursor = 0;
+			}
+		}
+	}
+}
+
+/**
+ * @brief 生成width x height的随机压缩图片，0x00/0xFF连续字节按bmp-packed格式压缩
+ * @param solid 为TRUE时大部分为白色，产生超过255字节、使用2字节长度的连续段
+ * */
+static void MakePacked(uint8_t *out, uint16_t width, uint16_t height, BOOL solid) {
+	uint32_t i, run, length = ((width + 7) / 8) * height, cursor = PACKED_DATA_OFFSET;
+	uint8_t raw[32 * SCREEN_HEIGHT];
+	uint16_t header = BITMAP_PACKED;
+
+	for(i = 0; i < length; i++) {
+		switch(solid ? ((rand() % 200) ? 1 : 2) : (rand() & 0x3)) {
+			case 0: raw[i] = 0x00; break;
+			case 1: raw[i] = 0xFF; break;
+			default: raw[i] = (uint8_t)rand(); break;
+		}
+	}
+	for(i = 0; i < length; ) {
+		if(raw[i] != 0x00 && raw[i] != 0xFF) {
+			out[cursor++] = raw[i++];
+			continue;
+		}
+		for(run = 1; (i + run) < length && raw[i + run] == raw[i] && run < 0xFFFF; run++);
+		out[cursor++] = raw[i];
+		if(run <= 0xFF) {
+			out[cursor++] = (uint8_t)run;
+		}else {
+			out[cursor++] = 0x00;
+			out[cursor++] = (uint8_t)(run & 0xFF);
+			out[cursor++] = (uint8_t)(run >> 8);
+		}
+		i += run;
+	}
+	os_memcpy(out, &header, PACKED_HEADER_LENGTH);
+	os_memcpy((out + PACKED_SIZE_OFFSET), &cursor, PACKED_SIZE_LENGTH);
+	os_memcpy((out + PACKED_WIDTH_OFFSET), &width, PACKED_WIDTH_LENGTH);
+	os_memcpy((out + PACKED_HEIGHT_OFFSET), &height, PACKED_HEIGHT_LENGTH);
+}
+
+/**
+ * @brief 两个显存从同一初始内容开始分别解码，返回是否一致
+ * */
+static BOOL CompareDecode(const uint8_t *image, uint16_t x, uint16_t y) {
+	uint8_t *buffer = EPDGetDisplayRAM();
+	os_memcpy(reference, initial, sizeof(initial));
+	os_memcpy(buffer, initial, sizeof(initial));
+	RefDrawImagePacked(image, x, y);
+	GuiDrawImagePacked(image, x, y);
+	return (memcmp(reference, buffer, sizeof(reference)) == 0);
+}
+
+int main(void) {
+	uint32_t i, k;
+	uint16_t width, height, x, y;
+	uint64_t start, refNs, newNs;
+
+	HOST_CHECK(EPDDisplayRAMInit() == OK, "framebuffer allocation failed");
+
+	// 内置图片，白色和随机背景
+	for(k = 0; k < (sizeof(bundled) / sizeof(bundled[0])); k++) {
+		memset(initial, 0xFF, sizeof(initial));
+		HOST_CHECK(CompareDecode(bundled[k], 0, 0), "%s image differs from the per-pixel decoder", bundledName[k]);
+		srand(k);
+		for(i = 0; i < sizeof(initial); i++) {
+			initial[i] = (uint8_t)rand();
+		}
+		HOST_CHECK(CompareDecode(bundled[k], 0, 0), "%s image over random content differs from the per-pixel decoder", bundledName[k]);
+	}
+
+	// 随机尺寸和位置，包括宽度不是8的整数倍、起始y不按8对齐的图片
+	srand(1675);
+	for(k = 0; k < PACKED_RANDOM_IMAGES; k++) {
+		width = 1 + rand() % SCREEN_WIDTH;
+		height = 1 + rand() % SCREEN_HEIGHT;
+		x = rand() % (SCREEN_WIDTH - width + 1);
+		y = rand() % (SCREEN_HEIGHT - height + 1);
+		MakePacked(synthetic, width, height, ((k & 0x3) == 0));
+		for(i = 0; i < sizeof(initial); i++) {
+			initial[i] = (uint8_t)rand();
+		}
+		HOST_CHECK(CompareDecode(synthetic, x, y), "%dx%d image at (%d,%d) differs from the per-pixel decoder", width, height, x, y);
+	}
+
+	// 主机端耗时，仅用于比较两种实现，不代表ESP8266上的绝对速度
+	start = HostTimeNs();
+	for(i = 0; i < PACKED_BENCH_ROUNDS; i++) {
+		RefDrawImagePacked(shutdown_image, 0, 0);
+	}
+	refNs = HostTimeNs() - start;
+	start = HostTimeNs();
+	for(i = 0; i < PACKED_BENCH_ROUNDS; i++) {
+		GuiDrawImagePacked(shutdown_image, 0, 0);
+	}
+	newNs = HostTimeNs() - start;
+	printf("shutdown image: per-pixel %.1f us, 8-row blit %.1f us (x%.1f)\n", (double)refNs / PACKED_BENCH_ROUNDS / 1000.0,
+			(double)newNs / PACKED_BENCH_ROUNDS / 1000.0, (double)refNs / (double)newNs);
+
+	return HostReport("test_image_packed");
+}
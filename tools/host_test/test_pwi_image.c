@@ -0,0 +1,182 @@
+/*
+ * test_pwi_image.c
+ * @brief GuiDrawPwiImageImpl与GuiDrawBmpImageImpl绘制同一图片的显存比较，包括裁剪区域
+ * @note pwi图片由tools/make_pwi.py从bmp转换(pwi_images.h)，两种格式都从内存文件绘制到相同的随机显存上
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/driver/ssd1675b.c app/graphics/displayio.c app/graphics/font.c app/utils/strings.c tools/host_test/host_gui.c
+
+#include "host.h"
+#include "host_gui.h"
+#include "graphics/displayio.h"
+#include "pwi_images.h"
+
+#define FRAME_SIZE        (EPD_HEIGHT * EPD_RAM_WIDTH)
+
+typedef struct _test_image {
+	const char *name;
+	const uint8_t *bmp;
+	uint32_t bmpLength;
+	const uint8_t *pwi;
+	uint32_t pwiLength;
+	uint16_t width;
+	uint16_t height;
+	// make_pwi.py选择的存储方式
+	uint8_t flags;
+} TestImage;
+
+static const TestImage images[] = {
+	{"icon", iconBmp, sizeof(iconBmp), iconPwi, sizeof(iconPwi), 100, 48, PWI_FLAG_RLE},
+	{"noise", noiseBmp, sizeof(noiseBmp), noisePwi, sizeof(noisePwi), 21, 13, 0},
+};
+
+static uint8_t *buffer;
+static uint8_t initial[FRAME_SIZE], unclipped[FRAME_SIZE], pwiFrame[FRAME_SIZE];
+
+static uint8_t GetPixel(const uint8_t *frame, uint16_t x, uint16_t y) {
+	return (frame[((EPD_HEIGHT - 1 - x) << 4) + (y >> 3)] >> (7 - (y & 0x7))) & 0x1;
+}
+
+/**
+ * @brief 在初始显存上分别绘制pwi和bmp图片，检查结果一致
+ * @param *clip 裁剪区域，NULL为不裁剪
+ * @return pwi绘制后的显存(pwiFrame)与初始显存不同的像素数
+ * */
+static uint32_t DrawBoth(const TestImage *image, uint16_t x, uint16_t y, const Rect *clip) {
+	File pwiFile, bmpFile;
+	uint32_t changed = 0;
+	uint16_t i, j;
+	BOOL pushed = FALSE;
+
+	open_file(&pwiFile, (char *)image->name, PWI_EXTNAME);
+	open_file(&bmpFile, (char *)image->name, "bmp");
+	if(clip != NULL) {
+		pushed = GuiPushClipRect(clip);
+		HOST_CHECK(pushed, "%s: clip rect not pushed", image->name);
+	}
+	os_memcpy(buffer, initial, FRAME_SIZE);
+	HOST_CHECK(GuiDrawPwiImageImpl(&pwiFile, x, y), "%s at (%d,%d): pwi not accepted", image->name, x, y);
+	os_memcpy(pwiFrame, buffer, FRAME_SIZE);
+	os_memcpy(buffer, initial, FRAME_SIZE);
+	GuiDrawBmpImageImpl(&bmpFile, x, y);
+	if(pushed) {
+		GuiPopClipRect();
+	}
+	HOST_CHECK(memcmp(pwiFrame, buffer, FRAME_SIZE) == 0, "%s at (%d,%d)%s: pwi differs from bmp",
+			image->name, x, y, ((clip != NULL) ? " clipped" : ""));
+	for(i = 0; i < SCREEN_WIDTH; i++) {
+		for(j = 0; j < SCREEN_HEIGHT; j++) {
+			changed += (GetPixel(pwiFrame, i, j) != GetPixel(initial, i, j));
+		}
+	}
+	return changed;
+}
+
+/**
+ * @brief 裁剪后的结果: 裁剪区域内与不裁剪时一致，区域外为初始显存
+ * */
+static void CheckClipped(const TestImage *image, uint16_t x, uint16_t y, const Rect *clip) {
+	uint16_t i, j;
+	uint32_t wrong = 0;
+
+	DrawBoth(image, x, y, NULL);
+	os_memcpy(unclipped, pwiFrame, FRAME_SIZE);
+	DrawBoth(image, x, y, clip);
+	for(i = 0; i < SCREEN_WIDTH; i++) {
+		for(j = 0; j < SCREEN_HEIGHT; j++) {
+			if((i >= clip->left) && (i <= clip->right) && (j >= clip->top) && (j <= clip->bottom)) {
+				wrong += (GetPixel(pwiFrame, i, j) != GetPixel(unclipped, i, j));
+			}else {
+				wrong += (GetPixel(pwiFrame, i, j) != GetPixel(initial, i, j));
+			}
+		}
+	}
+	HOST_CHECK(wrong == 0, "%s at (%d,%d) clipped to (%d,%d)-(%d,%d): %d pixels wrong", image->name, x, y,
+			clip->left, clip->top, clip->right, clip->bottom, wrong);
+}
+
+int main(void) {
+	const TestImage *image;
+	PwiHeader header;
+	File file;
+	Rect clip;
+	uint32_t i, k, changed;
+	uint16_t x, y;
+
+	HOST_CHECK(EPDDisplayRAMInit() == OK, "framebuffer allocation failed");
+	buffer = EPDGetDisplayRAM();
+	srand(2026);
+	for(i = 0; i < FRAME_SIZE; i++) {
+		initial[i] = (uint8_t)rand();
+	}
+
+	for(k = 0; k < (sizeof(images) / sizeof(TestImage)); k++) {
+		image = &images[k];
+		HostAddFile(image->name, "bmp", image->bmp, image->bmpLength);
+		HostAddFile(image->name, PWI_EXTNAME, image->pwi, image->pwiLength);
+		os_memcpy(&header, image->pwi, sizeof(PwiHeader));
+		HOST_CHECK(header.magic == PWI_MAGIC && header.width == image->width && header.height == image->height
+				&& header.flags == image->flags, "%s: pwi header %dx%d flags %d", image->name, header.width, header.height, header.flags);
+
+		// 不裁剪: 左上角、非字节对齐的y、右下角
+		changed = DrawBoth(image, 0, 0, NULL);
+		HOST_CHECK(changed > 0, "%s: drew nothing", image->name);
+		DrawBoth(image, 37, 5, NULL);
+		DrawBoth(image, 101, 59, NULL);
+		DrawBoth(image, (SCREEN_WIDTH - image->width), (SCREEN_HEIGHT - image->height), NULL);
+
+		// 随机位置
+		for(i = 0; i < 50; i++) {
+			x = (uint16_t)(rand() % (SCREEN_WIDTH - image->width + 1));
+			y = (uint16_t)(rand() % (SCREEN_HEIGHT - image->height + 1));
+			DrawBoth(image, x, y, NULL);
+		}
+
+		// 裁剪区域从四边切掉图片，上下边界不在字节边界上
+		x = 60;
+		y = 30;
+		clip.left = x + 3;
+		clip.top = y + 3;
+		clip.right = x + image->width - 4;
+		clip.bottom = y + image->height - 3;
+		CheckClipped(image, x, y, &clip);
+		// 只裁掉一侧
+		clip.left = 0;
+		clip.top = y + 9;
+		clip.right = SCREEN_WIDTH - 1;
+		clip.bottom = SCREEN_HEIGHT - 1;
+		CheckClipped(image, x, y, &clip);
+		clip.top = 0;
+		clip.right = x + image->width / 2;
+		clip.bottom = y + image->height / 2;
+		CheckClipped(image, x, y, &clip);
+		// 随机裁剪区域
+		for(i = 0; i < 50; i++) {
+			clip.left = x + rand() % image->width;
+			clip.top = y + rand() % image->height;
+			clip.right = clip.left + rand() % (x + image->width - clip.left);
+			clip.bottom = clip.top + rand() % (y + image->height - clip.top);
+			CheckClipped(image, x, y, &clip);
+		}
+
+		// 裁剪区域与图片不相交: 已处理但不绘制
+		clip.left = 0;
+		clip.top = 0;
+		clip.right = x - 1;
+		clip.bottom = SCREEN_HEIGHT - 1;
+		changed = DrawBoth(image, x, y, &clip);
+		HOST_CHECK(changed == 0, "%s outside the clip rect changed %d pixels", image->name, changed);
+
+		// 超出屏幕: 已处理但不绘制
+		changed = DrawBoth(image, (SCREEN_WIDTH - image->width + 1), 0, NULL);
+		changed += DrawBoth(image, 0, (SCREEN_HEIGHT - image->height + 1), NULL);
+		HOST_CHECK(changed == 0, "%s past the screen edge changed %d pixels", image->name, changed);
+
+		// bmp文件不是pwi
+		open_file(&file, (char *)image->name, "bmp");
+		HOST_CHECK(!GuiDrawPwiImageImpl(&file, 0, 0), "%s: bmp accepted as pwi", image->name);
+	}
+
+	return HostReport("test_pwi_image");
+}
@@ -0,0 +1,106 @@
+/*
+ * test_refresh_policy.c
+ * @brief RefreshPolicyDecide的全局/局部刷新决策和残影预算
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/utils/refresh_policy.c
+
+#include "host.h"
+#include "utils/refresh_policy.h"
+
+// 与user_main.c中PageGhostWeight一致: 基本页面6，相册页面25
+#define BASIC_PAGE      1
+#define BASIC_WEIGHT    6
+#define IMAGE_WEIGHT    25
+// 每分钟时钟数字变化的区域约40x30
+#define CLOCK_AREA      (40 * 30)
+
+static void MinuteTick(RefreshRequest *request, uint8_t page, sint8_t temperature) {
+	request->canPartial = TRUE;
+	request->page = page;
+	request->weight = BASIC_WEIGHT;
+	request->temperature = temperature;
+	request->dirtyArea = CLOCK_AREA;
+}
+
+int main(void) {
+	RefreshBudget budget;
+	RefreshRequest request;
+	uint32_t i;
+	uint8_t warm, cold;
+
+	// 复位后第一次总是全局刷新
+	RefreshPolicyReset(&budget);
+	MinuteTick(&request, BASIC_PAGE, 20);
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_FULL, "first refresh after reset was partial");
+	HOST_CHECK(budget.ghosting == 0 && budget.partials == 0, "full refresh left ghosting %d, partials %d", budget.ghosting, budget.partials);
+
+	// 每分钟的时钟变化保持局部刷新，达到REFRESH_PARTIAL_MAX次后强制全局刷新
+	for(i = 0; i < REFRESH_PARTIAL_MAX; i++) {
+		HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_PARTIAL, "minute tick %d was a full refresh", i + 1);
+	}
+	HOST_CHECK(budget.partials == REFRESH_PARTIAL_MAX, "%d partials counted", budget.partials);
+	HOST_CHECK(budget.ghosting <= REFRESH_GHOSTING_BUDGET, "minute ticks used %d of the ghosting budget", budget.ghosting);
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_FULL, "no full refresh after %d partials", REFRESH_PARTIAL_MAX);
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_PARTIAL, "minute tick after the forced full refresh was full");
+
+	// 页面切换
+	MinuteTick(&request, BASIC_PAGE + 1, 20);
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_FULL, "page switch was a partial refresh");
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_PARTIAL, "second refresh of the new page was full");
+
+	// 控制器RAM没有上一帧
+	request.canPartial = FALSE;
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_FULL, "partial refresh without the previous frame");
+
+	// 温度超出0~50度时全局刷新，边界值和未知温度仍可局部刷新
+	MinuteTick(&request, BASIC_PAGE, 20);
+	RefreshPolicyDecide(&budget, &request);
+	request.temperature = -1;
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_FULL, "partial refresh at -1'C");
+	request.temperature = 51;
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_FULL, "partial refresh at 51'C");
+	request.temperature = REFRESH_TEMP_MIN;
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_PARTIAL, "full refresh at %d'C", REFRESH_TEMP_MIN);
+	request.temperature = REFRESH_TEMP_MAX;
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_PARTIAL, "full refresh at %d'C", REFRESH_TEMP_MAX);
+	request.temperature = REFRESH_TEMP_UNKNOWN;
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_PARTIAL, "full refresh with unknown temperature");
+
+	// 低于REFRESH_TEMP_COLD时同一变化的代价加倍
+	RefreshPolicyReset(&budget);
+	MinuteTick(&request, BASIC_PAGE, 20);
+	RefreshPolicyDecide(&budget, &request);
+	RefreshPolicyDecide(&budget, &request);
+	warm = budget.ghosting;
+	RefreshPolicyReset(&budget);
+	MinuteTick(&request, BASIC_PAGE, REFRESH_TEMP_COLD - 1);
+	RefreshPolicyDecide(&budget, &request);
+	RefreshPolicyDecide(&budget, &request);
+	cold = budget.ghosting;
+	HOST_CHECK(warm > 0 && cold == (warm * 2), "cold cost %d, warm cost %d", cold, warm);
+
+	// 整屏变化的相册页面: 代价为3倍权重，第二次超出预算
+	RefreshPolicyReset(&budget);
+	request.canPartial = TRUE;
+	request.page = REFRESH_PAGE_IMAGE;
+	request.weight = IMAGE_WEIGHT;
+	request.temperature = 20;
+	request.dirtyArea = 250 * 122;
+	budget.page = REFRESH_PAGE_IMAGE;
+	budget.partials = 0;
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_PARTIAL, "first full-screen image change was full");
+	HOST_CHECK(budget.ghosting == (IMAGE_WEIGHT * 3), "full-screen change cost %d", budget.ghosting);
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_FULL, "ghosting budget exceeded without a full refresh");
+
+	// 复位后下一次总是全局刷新，即使页面相同
+	MinuteTick(&request, BASIC_PAGE, 20);
+	RefreshPolicyDecide(&budget, &request);
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_PARTIAL, "minute tick was full");
+	RefreshPolicyReset(&budget);
+	budget.page = BASIC_PAGE;
+	HOST_CHECK(RefreshPolicyDecide(&budget, &request) == REFRESH_FULL, "refresh after RefreshPolicyReset was partial");
+
+	return HostReport("test_refresh_policy");
+}
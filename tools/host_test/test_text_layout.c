@@ -0,0 +1,193 @@
+/*
+ * test_text_layout.c
+ * @brief TextLayoutUpdate的断行规则、省略号和字形数上限，TextLayoutDraw的绘制坐标
+ * @note 字体接口由桩函数提供，CJK字符都在Unicode子集字库中，省略号是否存在由测试控制；
+ *       没有utf16.lut，GB2312查询总是失败
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/graphics/text_layout.c app/utils/strings.c tools/host_test/host_gui.c
+
+#include "host.h"
+#include "graphics/text_layout.h"
+
+// 与note_layout.c的便签正文一致: 16px字体，行间距3，共5行
+#define LINE_HEIGHT     19
+#define LINE_SPACING    3
+#define CJK_PER_LINE    15
+#define ENG_PER_LINE    31
+
+static const Rect box = {0, 15, 249, 107};
+static Font cnFont, engFont, uniFont;
+static File fontFile;
+static BOOL hasEllipsis;
+static TextLayout layout;
+// GuiDrawChar调用记录
+static uint32_t drawCalls;
+static BOOL drawSpace, drawHeight;
+static uint16_t lastDrawX, lastDrawY;
+
+File *FontGetFile(Font *font) {
+	return &fontFile;
+}
+
+Font *FontGetUnicode(Font *font) {
+	return (font == &cnFont) ? &uniFont : NULL;
+}
+
+BOOL FontHasGlyph(Font *font, wchar ch) {
+	return (ch != TEXT_ELLIPSIS || hasEllipsis);
+}
+
+void GuiDrawChar(wchar ch, uint16_t x, uint16_t y, Color foreground, Color background, Font *font, uint16_t height) {
+	drawCalls++;
+	drawSpace |= (font == &engFont && ch == ' ');
+	drawHeight |= (height != cnFont.height);
+	lastDrawX = x;
+	lastDrawY = y;
+}
+
+static void InitFont(Font *font, uint8_t width, uint8_t height) {
+	os_memset(font, 0x00, sizeof(Font));
+	font->width = width;
+	font->height = height;
+}
+
+/**
+ * @brief 重新排版，检查字形数和行数
+ * */
+static void Layout(const char *name, const char *text, uint16_t count, uint8_t lines, BOOL truncated) {
+	os_memset(&layout, 0x00, sizeof(TextLayout));
+	HOST_CHECK(TextLayoutUpdate(&layout, (uint8_t *)text, &box, &cnFont, &engFont, LINE_SPACING), "%s: not laid out", name);
+	HOST_CHECK(layout.count == count, "%s: %d glyphs, expected %d", name, layout.count, count);
+	HOST_CHECK(layout.lines == lines, "%s: %d lines, expected %d", name, layout.lines, lines);
+	HOST_CHECK(layout.truncated == truncated, "%s: truncated %d, expected %d", name, layout.truncated, truncated);
+}
+
+static void CheckGlyph(const char *name, uint16_t index, uint16_t code, uint8_t font, uint8_t x, uint8_t line) {
+	const TextGlyph *glyph = &layout.glyphs[index];
+	HOST_CHECK(index < layout.count, "%s: glyph %d missing", name, index);
+	HOST_CHECK(glyph->code == code && TEXT_GLYPH_FONT(glyph) == font, "%s: glyph %d is %04X font %d, expected %04X font %d",
+			name, index, glyph->code, TEXT_GLYPH_FONT(glyph), code, font);
+	HOST_CHECK(glyph->x == x && TEXT_GLYPH_LINE(glyph) == line, "%s: glyph %d at x %d line %d, expected x %d line %d",
+			name, index, glyph->x, TEXT_GLYPH_LINE(glyph), x, line);
+}
+
+/**
+ * @brief 重复count次UTF8字符
+ * */
+static char *Repeat(char *buffer, const char *utf8, uint16_t count) {
+	uint16_t i, length = os_strlen(utf8);
+	for(i = 0; i < count; i++) {
+		os_memcpy(buffer + i * length, utf8, length);
+	}
+	buffer[count * length] = '\0';
+	return (buffer + count * length);
+}
+
+int main(void) {
+	static char text[512];
+	char *end;
+	uint16_t i;
+
+	InitFont(&cnFont, 16, 16);
+	InitFont(&uniFont, 16, 16);
+	InitFont(&engFont, 8, 16);
+	hasEllipsis = TRUE;
+	HOST_CHECK(sizeof(TextGlyph) == 4, "TextGlyph is %d bytes", (int)sizeof(TextGlyph));
+
+	// 英文单词不拆开: 第三个单词放不下时整体换行，前一个空格保留在行尾
+	Layout("words", "aaaaaaaaaa bbbbbbbbbb cccccccccc", 32, 2, FALSE);
+	CheckGlyph("words", 20, 'b', TEXT_GLYPH_ENG, 160, 0);
+	CheckGlyph("words", 21, ' ', TEXT_GLYPH_ENG, 168, 0);
+	CheckGlyph("words", 22, 'c', TEXT_GLYPH_ENG, 0, 1);
+	CheckGlyph("words", 31, 'c', TEXT_GLYPH_ENG, 72, 1);
+
+	// 绘制: 空格不绘制，纵坐标为box.top + 行号 * 行高
+	drawCalls = 0;
+	TextLayoutDraw(&layout, &cnFont, &engFont);
+	HOST_CHECK(drawCalls == 30 && !drawSpace, "drew %d glyphs, spaces %d", drawCalls, drawSpace);
+	HOST_CHECK(lastDrawX == 72 && lastDrawY == (box.top + LINE_HEIGHT), "last glyph drawn at (%d,%d)", lastDrawX, lastDrawY);
+	HOST_CHECK(!drawHeight, "english glyph drawn taller than the chinese font");
+
+	// 排版参数不变时沿用结果，行间距变化时重新排版
+	HOST_CHECK(!TextLayoutUpdate(&layout, (uint8_t *)"aaaaaaaaaa bbbbbbbbbb cccccccccc", &box, &cnFont, &engFont, LINE_SPACING),
+			"unchanged text laid out again");
+	HOST_CHECK(TextLayoutUpdate(&layout, (uint8_t *)"aaaaaaaaaa bbbbbbbbbb cccccccccc", &box, &cnFont, &engFont, LINE_SPACING + 1),
+			"changed line spacing reused the layout");
+
+	// 中文字符之间可断行: 每行15个
+	Repeat(text, "天", 20);
+	Layout("cjk", text, 20, 2, FALSE);
+	CheckGlyph("cjk", 14, 0x5929, TEXT_GLYPH_UNICODE, 224, 0);
+	CheckGlyph("cjk", 15, 0x5929, TEXT_GLYPH_UNICODE, 0, 1);
+	CheckGlyph("cjk", 19, 0x5929, TEXT_GLYPH_UNICODE, 64, 1);
+
+	// 闭合标点不出现在行首: 行尾放不下的逗号带着前一个字符换行
+	end = Repeat(text, "天", CJK_PER_LINE);
+	os_strcpy(end, "，气");
+	Layout("closing", text, 17, 2, FALSE);
+	CheckGlyph("closing", 13, 0x5929, TEXT_GLYPH_UNICODE, 208, 0);
+	CheckGlyph("closing", 14, 0x5929, TEXT_GLYPH_UNICODE, 0, 1);
+	CheckGlyph("closing", 15, 0xFF0C, TEXT_GLYPH_UNICODE, 16, 1);
+	CheckGlyph("closing", 16, 0x6C14, TEXT_GLYPH_UNICODE, 32, 1);
+
+	// 英文标点跟在中文后同样不出现在行首
+	text[0] = 'a';
+	end = Repeat(text + 1, "天", CJK_PER_LINE);
+	os_strcpy(end, ".");
+	Layout("closing ascii", text, 17, 2, FALSE);
+	CheckGlyph("closing ascii", 14, 0x5929, TEXT_GLYPH_UNICODE, 216, 0);
+	CheckGlyph("closing ascii", 15, 0x5929, TEXT_GLYPH_UNICODE, 0, 1);
+	CheckGlyph("closing ascii", 16, '.', TEXT_GLYPH_ENG, 16, 1);
+
+	// 开始标点不出现在行尾: 《和后一个字符一起换行
+	end = Repeat(text, "天", CJK_PER_LINE - 1);
+	os_strcpy(end, "《气》");
+	Layout("opening", text, 17, 2, FALSE);
+	CheckGlyph("opening", 13, 0x5929, TEXT_GLYPH_UNICODE, 208, 0);
+	CheckGlyph("opening", 14, 0x300A, TEXT_GLYPH_UNICODE, 0, 1);
+	CheckGlyph("opening", 15, 0x6C14, TEXT_GLYPH_UNICODE, 16, 1);
+	CheckGlyph("opening", 16, 0x300B, TEXT_GLYPH_UNICODE, 32, 1);
+
+	// 换行符
+	Layout("newline", "ab\ncd", 4, 2, FALSE);
+	CheckGlyph("newline", 2, 'c', TEXT_GLYPH_ENG, 0, 1);
+
+	// 超出5行: 最后一行以省略号结尾，放不下时去掉行尾字符
+	Repeat(text, "天", CJK_PER_LINE * 5 + 1);
+	Layout("ellipsis", text, CJK_PER_LINE * 5, 5, TRUE);
+	CheckGlyph("ellipsis", 73, 0x5929, TEXT_GLYPH_UNICODE, 208, 4);
+	CheckGlyph("ellipsis", 74, TEXT_ELLIPSIS, TEXT_GLYPH_UNICODE, 224, 4);
+
+	// 正好5行时不截断
+	Repeat(text, "天", CJK_PER_LINE * 5);
+	Layout("exact", text, CJK_PER_LINE * 5, 5, FALSE);
+	CheckGlyph("exact", 74, 0x5929, TEXT_GLYPH_UNICODE, 224, 4);
+
+	// 末尾只有换行和空白时不截断
+	end = Repeat(text, "天", CJK_PER_LINE * 5);
+	os_strcpy(end, "\n \n");
+	Layout("trailing newline", text, CJK_PER_LINE * 5, 5, FALSE);
+
+	// 字库中没有省略号时使用"..."
+	hasEllipsis = FALSE;
+	Repeat(text, "天", CJK_PER_LINE * 5 + 1);
+	Layout("ellipsis fallback", text, CJK_PER_LINE * 5 - 1 + 3, 5, TRUE);
+	CheckGlyph("ellipsis fallback", 73, 0x5929, TEXT_GLYPH_UNICODE, 208, 4);
+	for(i = 0; i < 3; i++) {
+		CheckGlyph("ellipsis fallback", 74 + i, '.', TEXT_GLYPH_ENG, 224 + i * 8, 4);
+	}
+
+	// 5行英文正好用满TEXT_LAYOUT_GLYPHS_MAX，超长单词逐字符断开
+	Repeat(text, "x", ENG_PER_LINE * 5 + 1);
+	Layout("glyph limit", text, TEXT_LAYOUT_GLYPHS_MAX, 5, TRUE);
+	HOST_CHECK(ENG_PER_LINE * 5 == TEXT_LAYOUT_GLYPHS_MAX, "TEXT_LAYOUT_GLYPHS_MAX %d for %d glyphs",
+			TEXT_LAYOUT_GLYPHS_MAX, ENG_PER_LINE * 5);
+	CheckGlyph("glyph limit", ENG_PER_LINE * 4 - 1, 'x', TEXT_GLYPH_ENG, 240, 3);
+	CheckGlyph("glyph limit", ENG_PER_LINE * 4, 'x', TEXT_GLYPH_ENG, 0, 4);
+	CheckGlyph("glyph limit", TEXT_LAYOUT_GLYPHS_MAX - 4, 'x', TEXT_GLYPH_ENG, 216, 4);
+	CheckGlyph("glyph limit", TEXT_LAYOUT_GLYPHS_MAX - 1, '.', TEXT_GLYPH_ENG, 240, 4);
+
+	return HostReport("test_text_layout");
+}
@@ -0,0 +1,128 @@
+/*
+ * test_unicode_font.c
+ * @brief Unicode子集字库(UNI12.pwf)的加载、查找、绘制，以及页索引无效时拒绝加载
+ * @note UNI12.pwf由make_pwf.py从规律字模的GB231212.bin生成(uni12_pwf.h)，
+ *       同一字符用Unicode子集字库和GB2312字库绘制的结果应完全一致
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/driver/ssd1675b.c app/graphics/displayio.c app/graphics/font.c app/utils/strings.c tools/host_test/host_gui.c
+
+#include "host.h"
+#include "host_gui.h"
+#include "graphics/displayio.h"
+#include "uni12_pwf.h"
+
+#define GB2312_GLYPHS     (846 + 72 * 94)
+#define FRAME_SIZE        (EPD_HEIGHT * EPD_RAM_WIDTH)
+// pwf文件中页索引的偏移
+#define PAGES_OFFSET      sizeof(PwfHeader)
+
+typedef struct _test_char {
+	wchar unicode;
+	// GB2312编码，低字节为区码
+	wchar gb2312;
+} TestChar;
+
+// uni12_pwf.h中的全部字符
+static const TestChar chars[] = {
+	{0x2026, 0xADA1}, // …
+	{0x3002, 0xA3A1}, // 。
+	{0x5929, 0xECCC}, // 天
+	{0x6674, 0xE7C7}, // 晴
+	{0x6C14, 0xF8C6}, // 气
+	{0xFF0C, 0xACA3}, // ，
+};
+
+static uint8_t gb12[GB2312_GLYPHS * 24];
+static uint8_t uni12[sizeof(uni12Pwf)];
+static uint8_t unicodeFrame[FRAME_SIZE], blankFrame[FRAME_SIZE];
+
+static void SetPage(uint32_t page, uint16_t value) {
+	uni12[PAGES_OFFSET + page * 2] = (uint8_t)(value & 0xFF);
+	uni12[PAGES_OFFSET + page * 2 + 1] = (uint8_t)(value >> 8);
+}
+
+static uint16_t GetPage(uint32_t page) {
+	return (uint16_t)(uni12[PAGES_OFFSET + page * 2] | (uni12[PAGES_OFFSET + page * 2 + 1] << 8));
+}
+
+/**
+ * @brief 修改文件后重新打开字体，检查是否拒绝加载
+ * */
+static void CheckRejected(const char *name) {
+	FontInvalidateFile(NULL);
+	HOST_CHECK(FontGetUnicode(getFont(FONT12x12_CN)) == NULL, "%s: unicode font loaded", name);
+	HOST_CHECK(FontGetFile(getFont(FONT12x12_UNI)) == NULL, "%s: UNI12 has a file handle", name);
+	HOST_CHECK(FontGetFile(getFont(FONT12x12_CN)) != NULL, "%s: GB2312 font lost", name);
+	os_memcpy(uni12, uni12Pwf, sizeof(uni12));
+	FontInvalidateFile(NULL);
+	HOST_CHECK(FontGetUnicode(getFont(FONT12x12_CN)) == getFont(FONT12x12_UNI), "%s: unicode font not restored", name);
+}
+
+int main(void) {
+	Font *cn, *uni;
+	uint8_t *buffer;
+	uint32_t i, j, last;
+	uint16_t x;
+
+	for(i = 0; i < GB2312_GLYPHS; i++) {
+		for(j = 0; j < 24; j++) {
+			gb12[i * 24 + j] = (uint8_t)(i * 13 + j * 29 + 0x5A);
+		}
+	}
+	os_memcpy(uni12, uni12Pwf, sizeof(uni12));
+	HostAddFile("GB231212", "bin", gb12, sizeof(gb12));
+	HostAddFile("UNI12", PWF_EXTNAME, uni12, sizeof(uni12));
+	HOST_CHECK(EPDDisplayRAMInit() == OK, "framebuffer allocation failed");
+	buffer = EPDGetDisplayRAM();
+	loadFont();
+
+	cn = getFont(FONT12x12_CN);
+	uni = getFont(FONT12x12_UNI);
+	HOST_CHECK(FontGetUnicode(cn) == uni, "UNI12.pwf not loaded");
+	HOST_CHECK(FontGetUnicode(getFont(FONT16x16_CN)) == NULL, "16px unicode font without a file");
+	HOST_CHECK(uni->layout == FONT_LAYOUT_COLUMN && uni->fontBytes == 24, "UNI12 layout %d, %d bytes per glyph",
+			uni->layout, uni->fontBytes);
+
+	// 字库中的字符与GB2312字库绘制结果一致
+	EPDDisplayClear();
+	os_memcpy(blankFrame, buffer, FRAME_SIZE);
+	for(i = 0; i < (sizeof(chars) / sizeof(TestChar)); i++) {
+		x = 10 + i * 37;
+		HOST_CHECK(FontHasGlyph(uni, chars[i].unicode), "U+%04X missing", chars[i].unicode);
+		EPDDisplayClear();
+		GuiDrawChar(chars[i].unicode, x, 3 + i * 17, BLACK, WHITE, uni, uni->height);
+		os_memcpy(unicodeFrame, buffer, FRAME_SIZE);
+		EPDDisplayClear();
+		GuiDrawChar(chars[i].gb2312, x, 3 + i * 17, BLACK, WHITE, cn, cn->height);
+		HOST_CHECK(memcmp(unicodeFrame, blankFrame, FRAME_SIZE) != 0, "U+%04X drew nothing", chars[i].unicode);
+		HOST_CHECK(memcmp(unicodeFrame, buffer, FRAME_SIZE) == 0, "U+%04X differs from GB2312 %04X",
+				chars[i].unicode, chars[i].gb2312);
+	}
+
+	// 不在字库中的字符: 同页相邻编码、空页、ASCII、最后一页末尾
+	HOST_CHECK(!FontHasGlyph(uni, 0x5928) && !FontHasGlyph(uni, 0x592A), "neighbours of U+5929 found");
+	HOST_CHECK(!FontHasGlyph(uni, 0x4E00), "U+4E00 found on an empty page");
+	HOST_CHECK(!FontHasGlyph(uni, 'A'), "ascii found");
+	HOST_CHECK(!FontHasGlyph(uni, 0xFF0D) && !FontHasGlyph(uni, 0xFFFF), "code after the last glyph found");
+	HOST_CHECK(!FontHasGlyph(uni, 0x2025), "code before the first glyph found");
+
+	// pages[256]与字模数不一致
+	last = GetPage(PWF_UNICODE_PAGES);
+	HOST_CHECK(last == (sizeof(chars) / sizeof(TestChar)), "pages[256] = %d in the fixture", last);
+	SetPage(PWF_UNICODE_PAGES, last - 1);
+	CheckRejected("pages[256] < glyphCount");
+	SetPage(PWF_UNICODE_PAGES, last + 1);
+	CheckRejected("pages[256] > glyphCount");
+
+	// 页索引不单调: 0x30页的结束位置小于开始位置
+	HOST_CHECK(GetPage(0x30) == 1 && GetPage(0x31) == 2, "page 0x30 spans %d~%d in the fixture", GetPage(0x30), GetPage(0x31));
+	SetPage(0x31, 0);
+	CheckRejected("non-monotonic pages");
+
+	// 恢复后仍能正确查找
+	HOST_CHECK(FontHasGlyph(uni, 0x3002) && FontHasGlyph(uni, 0xFF0C), "glyphs lost after reloading");
+
+	return HostReport("test_unicode_font");
+}
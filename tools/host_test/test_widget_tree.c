@@ -0,0 +1,225 @@
+/*
+ * test_widget_tree.c
+ * @brief WidgetTreeRender的脏控件判断、重叠闭包和GuiInvalidateRect上报的区域
+ * @note 只编译widget.c，displayio接口由桩函数记录调用，GuiIsFrameRetained由测试控制
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+// SOURCES: app/graphics/widget.c
+
+#include "host.h"
+#include "graphics/widget.h"
+
+#define TEST_WIDGETS    6
+
+typedef struct _test_data {
+	uint32_t a, b, c, d, e, f;
+} TestData;
+
+static void FormatF(const Widget *widget, const void **sources, char *content);
+static void DrawRecord(const Widget *widget, const void **sources, const char *content);
+
+/**
+ * 0和1上下相邻不重叠，3与1、2重叠，4、5与其他控件不重叠
+ *  0: (0,0)-(99,19)    2: (100,0)-(249,39)
+ *  1: (0,20)-(99,39)   3: (90,30)-(120,60)
+ *  4: (0,80)-(40,100)  5: (200,100)-(249,121)，内容由format生成
+ */
+static const Widget widgets[TEST_WIDGETS] = {
+	{{0, 0, 99, 19}, WIDGET_BITMAP, 0, 0, 0, {WIDGET_BIND(WIDGET_SOURCE_WEATHER, TestData, a)}, NULL, DrawRecord},
+	{{0, 20, 99, 39}, WIDGET_BITMAP, 0, 0, 1, {WIDGET_BIND(WIDGET_SOURCE_WEATHER, TestData, b)}, NULL, DrawRecord},
+	{{100, 0, 249, 39}, WIDGET_BITMAP, 0, 0, 2, {WIDGET_BIND(WIDGET_SOURCE_WEATHER, TestData, c)}, NULL, DrawRecord},
+	{{90, 30, 120, 60}, WIDGET_BITMAP, 0, 0, 3, {WIDGET_BIND(WIDGET_SOURCE_WEATHER, TestData, d)}, NULL, DrawRecord},
+	{{0, 80, 40, 100}, WIDGET_BITMAP, 0, 0, 4, {WIDGET_BIND(WIDGET_SOURCE_WEATHER, TestData, e)}, NULL, DrawRecord},
+	{{200, 100, 249, 121}, WIDGET_BITMAP, 0, 0, 5, {{0, 0, 0}}, FormatF, DrawRecord},
+};
+
+static BOOL frameRetained = FALSE;
+// 各桩函数的调用记录
+static uint32_t clearCalls, invalidateCalls, fillCalls, saveCalls, restoreCalls;
+static BOOL invalidateNull;
+static Rect invalidated;
+static uint8_t drawOrder[WIDGET_TREE_MAX * 2], drawCount;
+static Rect clipRect;
+static BOOL clipMismatch;
+
+BOOL GuiIsFrameRetained() {
+	return frameRetained;
+}
+
+BOOL GuiRestoreLayer(uint8_t slot, uint32_t signature) {
+	restoreCalls++;
+	return FALSE;
+}
+
+BOOL GuiSaveLayer(uint8_t slot, uint32_t signature) {
+	saveCalls++;
+	return FALSE;
+}
+
+void EPDDisplayClear() {
+	clearCalls++;
+}
+
+void GuiFillColor(uint16_t xStart, uint16_t yStart, uint16_t xEnd, uint16_t yEnd, uint8_t color) {
+	fillCalls++;
+}
+
+BOOL GuiPushClipRect(const Rect *rect) {
+	os_memcpy(&clipRect, rect, sizeof(Rect));
+	return TRUE;
+}
+
+void GuiPopClipRect() {
+}
+
+void GuiInvalidateRect(const Rect *rect) {
+	invalidateCalls++;
+	invalidateNull = (rect == NULL);
+	if(rect != NULL) {
+		os_memcpy(&invalidated, rect, sizeof(Rect));
+	}
+}
+
+uint16_t GuiDrawStringUTF8(uint8_t *str, uint16_t xStart, uint16_t yStart, Font *font, Font *engFont) {
+	return xStart;
+}
+
+void GuiDrawBmpImage(char *fileName, char *extName, uint16_t xStart, uint16_t yStart) {
+}
+
+Font *getFont(FontType tp) {
+	return NULL;
+}
+
+static void FormatF(const Widget *widget, const void **sources, char *content) {
+	const TestData *data = (const TestData *)sources[WIDGET_SOURCE_WEATHER];
+	os_sprintf(content, "f=%d", (data->f / 10));
+}
+
+static void DrawRecord(const Widget *widget, const void **sources, const char *content) {
+	if(os_memcmp(&clipRect, &widget->rect, sizeof(Rect)) != 0) {
+		clipMismatch = TRUE;
+	}
+	if(drawCount < sizeof(drawOrder)) {
+		drawOrder[drawCount++] = widget->param;
+	}
+}
+
+static void ResetCalls(void) {
+	clearCalls = 0;
+	invalidateCalls = 0;
+	fillCalls = 0;
+	saveCalls = 0;
+	restoreCalls = 0;
+	invalidateNull = FALSE;
+	os_memset(&invalidated, 0x00, sizeof(Rect));
+	drawCount = 0;
+	clipMismatch = FALSE;
+}
+
+/**
+ * @brief 保留帧下绘制一次，检查绘制的控件(按叠放次序)和上报的变化区域
+ * @param *order 期望绘制的控件序号，以0xFF结束
+ * */
+static void CheckRetained(const char *name, WidgetTree *tree, const void **sources, const uint8_t *order,
+		int16_t left, int16_t top, int16_t right, int16_t bottom) {
+	uint8_t drawn, expected = 0;
+
+	while(order[expected] != 0xFF) {
+		expected++;
+	}
+	ResetCalls();
+	frameRetained = TRUE;
+	drawn = WidgetTreeRender(tree, sources);
+	HOST_CHECK(drawn == expected, "%s: drawn %d, expected %d", name, drawn, expected);
+	HOST_CHECK(drawCount == expected && memcmp(drawOrder, order, expected) == 0, "%s: wrong widgets or order drawn", name);
+	HOST_CHECK(fillCalls == expected, "%s: %d widgets cleared, expected %d", name, fillCalls, expected);
+	HOST_CHECK(clearCalls == 0, "%s: full clear on a retained frame", name);
+	HOST_CHECK(invalidateCalls == 1, "%s: GuiInvalidateRect called %d times", name, invalidateCalls);
+	HOST_CHECK(!clipMismatch, "%s: widget drawn without its clip rect", name);
+	if(expected == 0) {
+		HOST_CHECK(invalidateNull, "%s: unchanged frame reported a dirty rect", name);
+	}else {
+		HOST_CHECK(!invalidateNull && invalidated.left == left && invalidated.top == top
+				&& invalidated.right == right && invalidated.bottom == bottom,
+				"%s: dirty rect (%d,%d)-(%d,%d), expected (%d,%d)-(%d,%d)", name,
+				invalidated.left, invalidated.top, invalidated.right, invalidated.bottom, left, top, right, bottom);
+	}
+}
+
+int main(void) {
+	TestData data = {1, 2, 3, 4, 5, 60};
+	const void *sources[WIDGET_SOURCE_COUNT] = {NULL, &data, NULL, NULL};
+	WidgetTree tree;
+	uint8_t drawn;
+	static const uint8_t none[] = {0xFF};
+	static const uint8_t only0[] = {0, 0xFF};
+	static const uint8_t only4[] = {4, 0xFF};
+	static const uint8_t only5[] = {5, 0xFF};
+	static const uint8_t closure[] = {1, 2, 3, 0xFF};
+	static const uint8_t apart[] = {0, 4, 0xFF};
+
+	os_memset(&tree, 0x00, sizeof(WidgetTree));
+	tree.widgets = widgets;
+	tree.count = TEST_WIDGETS;
+	tree.layer = GUI_LAYER_NONE;
+
+	// 首次绘制: 整帧清除并绘制全部控件，不上报变化区域
+	ResetCalls();
+	drawn = WidgetTreeRender(&tree, sources);
+	HOST_CHECK(drawn == TEST_WIDGETS && drawCount == TEST_WIDGETS, "first render drew %d widgets", drawn);
+	HOST_CHECK(clearCalls == 1 && invalidateCalls == 0, "first render: %d clears, %d invalidates", clearCalls, invalidateCalls);
+	HOST_CHECK(saveCalls == 0 && restoreCalls == 0, "GUI_LAYER_NONE tree used the layer cache");
+
+	// 数据未变化
+	CheckRetained("unchanged", &tree, sources, none, 0, 0, 0, 0);
+
+	// 单个字段变化，只重绘绑定该字段的控件
+	data.e = 50;
+	CheckRetained("field e", &tree, sources, only4, 0, 80, 40, 100);
+	data.a = 10;
+	CheckRetained("field a", &tree, sources, only0, 0, 0, 99, 19);
+
+	// 5没有绑定字段，签名只由format生成的内容决定: 内容不变时不重绘
+	data.f = 61;
+	CheckRetained("format same", &tree, sources, none, 0, 0, 0, 0);
+	data.f = 70;
+	CheckRetained("format changed", &tree, sources, only5, 200, 100, 249, 121);
+
+	// 1与3重叠，3与2重叠: 重绘1时2、3一起重绘，区域为三者的并集
+	data.b = 20;
+	CheckRetained("overlap b", &tree, sources, closure, 0, 0, 249, 60);
+	// 从中间的3开始同样得到完整闭包
+	data.d = 40;
+	CheckRetained("overlap d", &tree, sources, closure, 0, 0, 249, 60);
+
+	// 两个不相邻的控件，区域为外接矩形
+	data.a = 11;
+	data.e = 51;
+	CheckRetained("two apart", &tree, sources, apart, 0, 0, 99, 100);
+
+	// 显存被其他视图覆盖后整帧重绘
+	ResetCalls();
+	frameRetained = FALSE;
+	drawn = WidgetTreeRender(&tree, sources);
+	HOST_CHECK(drawn == TEST_WIDGETS && clearCalls == 1 && invalidateCalls == 0, "redraw after another view: %d widgets", drawn);
+
+	// 页面控件树只在有控件重绘时保存整帧缓存
+	tree.layer = 0;
+	tree.valid = FALSE;
+	ResetCalls();
+	WidgetTreeRender(&tree, sources);
+	HOST_CHECK(saveCalls == 1, "first page render saved the frame %d times", saveCalls);
+	CheckRetained("page unchanged", &tree, sources, none, 0, 0, 0, 0);
+	HOST_CHECK(saveCalls == 0, "unchanged page saved the frame %d times", saveCalls);
+	data.e = 52;
+	CheckRetained("page field e", &tree, sources, only4, 0, 80, 40, 100);
+	HOST_CHECK(saveCalls == 1, "changed page saved the frame %d times", saveCalls);
+
+	// 超过脏标记位数的控件树不绘制
+	tree.count = WIDGET_TREE_MAX + 1;
+	HOST_CHECK(WidgetTreeRender(&tree, sources) == 0, "oversized tree rendered");
+
+	return HostReport("test_widget_tree");
+}
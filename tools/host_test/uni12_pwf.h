@@ -0,0 +1,64 @@
+/*
+ * uni12_pwf.h
+ * @brief test_unicode_font使用的UNI12.pwf，6个字符: … 。 天 晴 气 ，
+ * @note 由tools/make_pwf.py生成，GB231212.bin为规律字模(第k个字模第j字节为(k * 13 + j * 29 + 0x5A) & 0xFF)，
+ *       test_unicode_font在内存中按同样规律生成GB231212.bin作为对照:
+ *       python3 -c "open('GB231212.bin','wb').write(bytes(((k * 13 + j * 29 + 0x5A) & 0xFF) for k in range(846 + 72 * 94) for j in range(24)))"
+ *       echo "…。天晴气，" > charset.txt
+ *       python3 tools/make_pwf.py --unicode GB231212.bin UNI12.pwf charset.txt
+ * Created on: Oct 17, 2026
+ * Author: Yanye
+ */
+
+#ifndef _UNI12_PWF_H_
+#define _UNI12_PWF_H_
+
+#include "c_types.h"
+
+static const uint8_t uni12Pwf[] = {
+	0x50, 0x57, 0x46, 0x00, 0x01, 0x0C, 0x0C, 0x02, 0x18, 0x00, 0x06, 0x00, 0x00, 0x01, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00,
+	0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00, 0x01, 0x00,
+	0x01, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00,
+	0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00,
+	0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00,
+	0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00,
+	0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00, 0x02, 0x00,
+	0x02, 0x00, 0x02, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00,
+	0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x03, 0x00, 0x04, 0x00,
+	0x04, 0x00, 0x04, 0x00, 0x04, 0x00, 0x04, 0x00, 0x04, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00,
+	0x06, 0x00, 0x26, 0x02, 0x29, 0x74, 0x14, 0x0C, 0x99, 0x80, 0xAA, 0x90, 0xF0, 0x30, 0xCE, 0x30,
+	0x2D, 0x20, 0x99, 0x90, 0xAA, 0xA0, 0x00, 0x00, 0x39, 0x90, 0x5A, 0xA0, 0x0F, 0x80, 0x8C, 0x70,
+	0x66, 0x30, 0xAA, 0xD0, 0xF0, 0x70, 0x8E, 0x70, 0x69, 0x60, 0xCC, 0xC0, 0x55, 0x50, 0x00, 0x00,
+	0xC6, 0x60, 0x4A, 0xA0, 0x1F, 0x80, 0x9C, 0x60, 0x8C, 0xC0, 0x95, 0x50, 0x3E, 0x00, 0x31, 0xC0,
+	0x2D, 0x20, 0x99, 0x90, 0xAA, 0xA0, 0xFF, 0xF0, 0x98, 0xC0, 0xAB, 0x50, 0x81, 0xF0, 0x71, 0x80,
+	0xCC, 0x60, 0x54, 0xA0, 0xC1, 0xF0, 0x39, 0xC0, 0xA5, 0xA0, 0x33, 0x30, 0x55, 0x50, 0x00, 0x00,
+	0xCC, 0xC0, 0xD5, 0x50, 0x7E, 0x00, 0x71, 0x80, 0xCC, 0xC0, 0x55, 0x40, 0xFC, 0x10, 0xE3, 0x10,
+	0xD2, 0xD0, 0x99, 0x90, 0xAA, 0xA0, 0xFF, 0xF0, 0x9C, 0xC0, 0xAD, 0x50, 0x07, 0xE0, 0xE7, 0x10,
+	0x66, 0x30, 0xAA, 0xD0, 0xF0, 0x70, 0x8E, 0x70, 0x69, 0x60, 0xCC, 0xC0, 0x55, 0x50, 0xFF, 0xF0,
+	0xC6, 0x60, 0x5A, 0xA0, 0x0F, 0x80, 0x8C, 0x70,
+};
+
+#endif /* _UNI12_PWF_H_ */
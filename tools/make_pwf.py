@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# make_pwf.py
+# 将逐行扫描的bin字库转换为按列预旋转的pwf字库，格式定义见 app/include/graphics/font.h
+# 用法: python3 make_pwf.py GB231216.bin [GB231216.pwf]
+# 字体参数根据文件名选择，生成的pwf文件通过APP文件管理上传，与bin字库同名即可被优先使用
+#
+# Unicode子集字库: python3 make_pwf.py --unicode GB231212.bin UNI12.pwf ../app pwf_charset.txt
+# 从源码字符串和词表文件中收集非ASCII字符，按Unicode编码索引，UTF8字符串绘制时无需查utf16.lut
+#
+# Created on: Oct 17, 2026
+# Author: Yanye
+
+import os
+import struct
+import sys
+
+PWF_MAGIC = b'PWF\x00'
+PWF_VERSION = 1
+PWF_ENCODING_BLOCK = 0
+PWF_ENCODING_UNICODE = 1
+PWF_UNICODE_PAGES = 256
+PWF_UNICODE_GLYPHS_MAX = 4096
+# 收集字符时扫描的文件类型
+CHARSET_EXTS = ('.c', '.h', '.txt')
+
+# GB2312 非汉字符号区 A1A1-A9FE，汉字区 B0A1-F7FE
+# block: (lowFirst, lowLast, highFirst, highLast)，low为首字节(区码)，high为第二字节(位码)
+GB2312_BLOCKS = [(0xA1, 0xA9, 0xA1, 0xFE), (0xB0, 0xF7, 0xA1, 0xFE)]
+
+# 与 app/graphics/font.c 中 loadFont 的字体定义保持一致
+FONTS = {
+    'GB231212': dict(width=12, height=12, blocks=GB2312_BLOCKS),
+    'GB231216': dict(width=16, height=16, blocks=GB2312_BLOCKS),
+    'AS08_16': dict(width=8, height=16, blocks=[(0x20, 0x7E, 0x00, 0x00)]),
+    'AS06_12': dict(width=6, height=12, blocks=[(0x20, 0x7E, 0x00, 0x00)]),
+    'GB64SP': dict(width=8, height=16, blocks=[(0x00, 0x40, 0x00, 0x00)]),
+}
+
+
+def row_to_column(glyph, width, height):
+    """逐行扫描(行内高位在左) -> 逐列扫描(列内首字节最高位为第一行)"""
+    line_bytes = (width + 7) // 8
+    column_bytes = (height + 7) // 8
+    out = bytearray(width * column_bytes)
+    for y in range(height):
+        line = glyph[y * line_bytes:(y + 1) * line_bytes]
+        for x in range(width):
+            if line[x >> 3] & (0x80 >> (x & 7)):
+                out[x * column_bytes + (y >> 3)] |= (0x80 >> (y & 7))
+    return bytes(out)
+
+
+def pwf_header(width, height, glyph_count, block_count, encoding):
+    column_bytes = (height + 7) // 8
+    return PWF_MAGIC + struct.pack('<BBBBHHBB2x', PWF_VERSION, width, height, column_bytes,
+                                   width * column_bytes, glyph_count, block_count, encoding)
+
+
+def load_font(src):
+    name = os.path.splitext(os.path.basename(src))[0].upper()
+    if name not in FONTS:
+        raise SystemExit('unknown font %s, expect one of %s' % (name, ', '.join(FONTS)))
+    with open(src, 'rb') as f:
+        return FONTS[name], f.read()
+
+
+def read_glyph(data, index, width, height):
+    glyph_size = ((width + 7) // 8) * height
+    glyph = data[index * glyph_size:(index + 1) * glyph_size]
+    return glyph + b'\x00' * (glyph_size - len(glyph))
+
+
+def convert(src, dst):
+    spec, data = load_font(src)
+    width, height = spec['width'], spec['height']
+
+    blocks = b''
+    glyphs = bytearray()
+    base = 0
+    for low_first, low_last, high_first, high_last in spec['blocks']:
+        blocks += struct.pack('<BBBBHH', low_first, low_last, high_first, high_last, base, 0)
+        count = (low_last - low_first + 1) * (high_last - high_first + 1)
+        for i in range(count):
+            # bin字库中各编码区按区码主序连续存放
+            glyphs += row_to_column(read_glyph(data, base + i, width, height), width, height)
+        base += count
+
+    header = pwf_header(width, height, base, len(spec['blocks']), PWF_ENCODING_BLOCK)
+    with open(dst, 'wb') as f:
+        f.write(header + blocks + bytes(glyphs))
+    print('%s -> %s: %d glyphs, %d bytes' % (src, dst, base, len(header) + len(blocks) + len(glyphs)))
+
+
+def collect_charset(paths):
+    """收集文件中的非ASCII字符(BMP平面)，目录递归扫描"""
+    chars = set()
+    files = []
+    for path in paths:
+        if os.path.isdir(path):
+            for root, _, names in os.walk(path):
+                files += [os.path.join(root, n) for n in names if n.endswith(CHARSET_EXTS)]
+        else:
+            files.append(path)
+    for name in files:
+        with open(name, 'r', encoding='utf-8', errors='ignore') as f:
+            chars.update(c for c in f.read() if 0x7F < ord(c) <= 0xFFFF)
+    return sorted(chars)
+
+
+def gb2312_index(ch):
+    """字符在GB2312 bin字库中的字模序号，不在字库中返回None"""
+    try:
+        code = ch.encode('gb2312')
+    except UnicodeEncodeError:
+        return None
+    if len(code) != 2:
+        return None
+    base = 0
+    for low_first, low_last, high_first, high_last in GB2312_BLOCKS:
+        columns = high_last - high_first + 1
+        if low_first <= code[0] <= low_last and high_first <= code[1] <= high_last:
+            return base + (code[0] - low_first) * columns + (code[1] - high_first)
+        base += (low_last - low_first + 1) * columns
+    return None
+
+
+def convert_unicode(src, dst, paths):
+    spec, data = load_font(src)
+    if spec['blocks'] != GB2312_BLOCKS:
+        raise SystemExit('%s is not a GB2312 font' % src)
+    width, height = spec['width'], spec['height']
+
+    codes = []
+    for ch in collect_charset(paths):
+        index = gb2312_index(ch)
+        if index is None:
+            print('skip U+%04X %s: not in GB2312' % (ord(ch), ch))
+            continue
+        codes.append((ord(ch), index))
+    if not codes or len(codes) > PWF_UNICODE_GLYPHS_MAX:
+        raise SystemExit('glyph count %d out of range' % len(codes))
+
+    pages = [0] * (PWF_UNICODE_PAGES + 1)
+    for code, _ in codes:
+        pages[(code >> 8) + 1] += 1
+    for i in range(PWF_UNICODE_PAGES):
+        pages[i + 1] += pages[i]
+
+    lows = bytes(code & 0xFF for code, _ in codes)
+    glyphs = b''.join(row_to_column(read_glyph(data, index, width, height), width, height) for _, index in codes)
+    header = pwf_header(width, height, len(codes), 0, PWF_ENCODING_UNICODE)
+    with open(dst, 'wb') as f:
+        f.write(header + struct.pack('<%dH' % len(pages), *pages) + lows + glyphs)
+    print('%s -> %s: %d glyphs, %d bytes' % (src, dst, len(codes), len(header) + len(pages) * 2 + len(lows) + len(glyphs)))
+
+
+def main():
+    if len(sys.argv) > 1 and sys.argv[1] == '--unicode':
+        if len(sys.argv) < 5:
+            raise SystemExit('usage: make_pwf.py --unicode <GB2312 font.bin> <out.pwf> <charset files or dirs...>')
+        convert_unicode(sys.argv[2], sys.argv[3], sys.argv[4:])
+        return
+    if len(sys.argv) < 2:
+        raise SystemExit('usage: make_pwf.py <font.bin> [font.pwf]')
+    src = sys.argv[1]
+    dst = sys.argv[2] if len(sys.argv) > 2 else os.path.splitext(src)[0] + '.pwf'
+    convert(src, dst)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+# -*- coding: utf-8 -*-
+#
+# make_pwi.py
+# 将单色bmp图片转换为按列预旋转的pwi图片，格式定义见 app/include/graphics/displayio.h
+# 用法: python3 make_pwi.py <bmp文件或目录...> [-o 输出目录]
+# 生成的pwi文件通过APP文件管理上传，与bmp同名即可被GuiDrawBmpImage优先使用
+#
+# Created on: Oct 17, 2026
+# Author: Yanye
+
+import os
+import struct
+import sys
+
+PWI_MAGIC = b'PWI\x00'
+PWI_VERSION = 1
+PWI_FLAG_RLE = 0x01
+# 与 app/include/graphics/displayio.h 屏幕尺寸保持一致
+SCREEN_WIDTH = 250
+SCREEN_HEIGHT = 122
+
+
+def load_bmp(src):
+    """读取1bit bmp，返回(width, height, rows)，rows按从上到下排列，行内高位在左，bit=1为白色(同固件，不看调色板)"""
+    with open(src, 'rb') as f:
+        data = f.read()
+    if data[0:2] != b'BM':
+        raise SystemExit('%s: not a bmp file' % src)
+    offset, = struct.unpack_from('<I', data, 10)
+    width, height, planes, bits, compression = struct.unpack_from('<iiHHI', data, 18)
+    if bits != 1 or compression != 0:
+        raise SystemExit('%s: only 1-bit uncompressed bmp is supported' % src)
+    top_down = height < 0
+    height = abs(height)
+    if not (0 < width <= SCREEN_WIDTH and 0 < height <= SCREEN_HEIGHT):
+        raise SystemExit('%s: size %dx%d out of screen' % (src, width, height))
+    stride = ((width + 31) // 32) * 4
+    rows = [data[offset + i * stride:offset + (i + 1) * stride] for i in range(height)]
+    if not top_down:
+        rows.reverse()
+    return width, height, rows
+
+
+def bmp_to_columns(width, height, rows):
+    """逐行扫描 -> 逐列扫描(列内首字节最高位为第一行)，补齐位填0"""
+    column_bytes = (height + 7) // 8
+    out = bytearray(width * column_bytes)
+    for y, line in enumerate(rows):
+        for x in range(width):
+            if line[x >> 3] & (0x80 >> (x & 7)):
+                out[x * column_bytes + (y >> 3)] |= (0x80 >> (y & 7))
+    return bytes(out)
+
+
+def rle_encode(data):
+    """压缩0x00/0xFF连续段: 值 + 1字节长度，长度超过255时写0再跟2字节长度"""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        value = data[i]
+        if value not in (0x00, 0xFF):
+            out.append(value)
+            i += 1
+            continue
+        run = 1
+        while i + run < len(data) and data[i + run] == value and run < 0xFFFF:
+            run += 1
+        out.append(value)
+        if run <= 0xFF:
+            out.append(run)
+        else:
+            out += struct.pack('<BH', 0, run)
+        i += run
+    return bytes(out)
+
+
+def rle_decode(data, length):
+    out = bytearray()
+    i = 0
+    while len(out) < length:
+        value = data[i]
+        if value in (0x00, 0xFF):
+            count = data[i + 1]
+            i += 2
+            if count == 0:
+                count, = struct.unpack_from('<H', data, i)
+                i += 2
+            out += bytes([value]) * count
+        else:
+            out.append(value)
+            i += 1
+    return bytes(out[:length])
+
+
+def convert(src, dst):
+    width, height, rows = load_bmp(src)
+    raw = bmp_to_columns(width, height, rows)
+    packed = rle_encode(raw)
+    if rle_decode(packed, len(raw)) != raw:
+        raise SystemExit('%s: rle self check failed' % src)
+    flags, body = (PWI_FLAG_RLE, packed) if len(packed) < len(raw) else (0, raw)
+    header = PWI_MAGIC + struct.pack('<BBHHH', PWI_VERSION, flags, width, height, 0)
+    with open(dst, 'wb') as f:
+        f.write(header + body)
+    print('%s -> %s: %dx%d, %d bytes (bmp %d)%s' % (src, dst, width, height, len(header) + len(body),
+                                                    os.path.getsize(src), ', rle' if flags else ''))
+
+
+def main():
+    args = sys.argv[1:]
+    out_dir = None
+    if '-o' in args:
+        i = args.index('-o')
+        if i + 1 >= len(args):
+            raise SystemExit('usage: make_pwi.py <bmp files or dirs...> [-o out_dir]')
+        out_dir = args[i + 1]
+        del args[i:i + 2]
+    if not args:
+        raise SystemExit('usage: make_pwi.py <bmp files or dirs...> [-o out_dir]')
+    files = []
+    for path in args:
+        if os.path.isdir(path):
+            files += sorted(os.path.join(path, n) for n in os.listdir(path) if n.lower().endswith('.bmp'))
+        else:
+            files.append(path)
+    for src in files:
+        name = os.path.splitext(os.path.basename(src))[0]
+        if len(name) > 8:
+            print('warning: %s: spifs file name is limited to 8 characters' % src)
+        dst = os.path.join(out_dir if out_dir else os.path.dirname(src), name + '.pwi')
+        convert(src, dst)
+
+
+if __name__ == '__main__':
+    main()